@@ -0,0 +1,196 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/hardware/utl_cpu_features.h"
+
+#if UTL_ARCH_x86
+#  include "utl/hardware/x86/utl_cpuid.h"
+
+#  if UTL_COMPILER_MSVC
+#    include <immintrin.h>
+#  endif
+#elif UTL_ARCH_ARM && UTL_TARGET_LINUX
+#  include <sys/auxv.h>
+#endif
+
+#if UTL_TARGET_UNIX
+#  include <unistd.h>
+#endif
+
+#include <stdint.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace {
+
+size_t configured_cache_size() noexcept {
+#if UTL_TARGET_UNIX && defined(_SC_LEVEL3_CACHE_SIZE)
+    auto size = ::sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (size <= 0) {
+        size = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+    }
+
+    if (size > 0) {
+        return static_cast<size_t>(size);
+    }
+#endif
+    return 0;
+}
+
+#if UTL_ARCH_x86
+
+/**
+ * Register state enabled by the OS in XCR0
+ */
+uint64_t enabled_state() noexcept {
+#  if UTL_SUPPORTS_GNU_ASM
+    uint32_t eax;
+    uint32_t edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#  elif UTL_COMPILER_MSVC
+    return _xgetbv(0);
+#  else
+    return 0;
+#  endif
+}
+
+constexpr bool has_bit(uint32_t reg, unsigned int bit) noexcept {
+    return (reg >> bit) & 1;
+}
+
+/**
+ * Walks the deterministic cache parameters, leaf 4 on Intel and 0x8000001D on AMD share a layout
+ */
+size_t last_level_cache_size(uint32_t leaf) noexcept {
+    size_t result = 0;
+    uint32_t highest = 0;
+    for (uint32_t subleaf = 0; subleaf < 16; ++subleaf) {
+        auto const info = x86::cpuid(leaf, subleaf);
+        auto const type = info.eax & 0x1f;
+        if (type == 0) {
+            break;
+        }
+
+        auto const level = (info.eax >> 5) & 0x7;
+        // Skip instruction caches
+        if (type == 2 || level < highest) {
+            continue;
+        }
+
+        highest = level;
+        result = static_cast<size_t>((info.ebx >> 22) + 1) * (((info.ebx >> 12) & 0x3ff) + 1) *
+            ((info.ebx & 0xfff) + 1) * (static_cast<size_t>(info.ecx) + 1);
+    }
+
+    return result;
+}
+
+size_t last_level_cache_size() noexcept {
+    auto const vendor = x86::cpuid<0>();
+    // "GenuineIntel"
+    if (vendor.ebx == 0x756e6547 && vendor.eax >= 4) {
+        return last_level_cache_size(4);
+    }
+
+    // "AuthenticAMD" and "HygonGenuine" with topology extensions
+    if ((vendor.ebx == 0x68747541 || vendor.ebx == 0x6f677948) &&
+        x86::cpuid<0x80000000>().eax >= 0x8000001d && has_bit(x86::cpuid<0x80000001>().ecx, 22)) {
+        return last_level_cache_size(0x8000001d);
+    }
+
+    return configured_cache_size();
+}
+
+cpu_features probe() noexcept {
+    cpu_features features = {};
+    features.last_level_cache_size = last_level_cache_size();
+    auto const max_leaf = x86::cpuid<0>().eax;
+    if (max_leaf < 1) {
+        return features;
+    }
+
+    auto const leaf1 = x86::cpuid<1>();
+    features.sse2 = has_bit(leaf1.edx, 26);
+    features.ssse3 = has_bit(leaf1.ecx, 9);
+    features.sse4_2 = has_bit(leaf1.ecx, 20);
+    features.popcnt = has_bit(leaf1.ecx, 23);
+
+    // XMM and YMM state for AVX, additionally opmask and ZMM state for AVX-512
+    auto const state = has_bit(leaf1.ecx, 27) ? enabled_state() : 0;
+    bool const ymm_enabled = (state & 0x6) == 0x6;
+    bool const zmm_enabled = (state & 0xe6) == 0xe6;
+    features.avx = ymm_enabled && has_bit(leaf1.ecx, 28);
+    if (max_leaf < 7) {
+        return features;
+    }
+
+    auto const leaf7 = x86::cpuid<7, 0>();
+    features.bmi1 = has_bit(leaf7.ebx, 3);
+    features.avx2 = features.avx && has_bit(leaf7.ebx, 5);
+    features.bmi2 = has_bit(leaf7.ebx, 8);
+    features.erms = has_bit(leaf7.ebx, 9);
+    features.avx512f = zmm_enabled && has_bit(leaf7.ebx, 16);
+    features.avx512bw = features.avx512f && has_bit(leaf7.ebx, 30);
+    features.avx512vl = features.avx512f && has_bit(leaf7.ebx, 31);
+    features.fsrm = has_bit(leaf7.edx, 4);
+    return features;
+}
+
+#elif UTL_ARCH_ARM
+
+cpu_features probe() noexcept {
+    cpu_features features = {};
+    features.last_level_cache_size = configured_cache_size();
+#  if UTL_ARCH_AARCH64
+    // Advanced SIMD is mandatory on AArch64
+    features.neon = true;
+#  endif
+
+#  if UTL_TARGET_LINUX
+    auto const hwcap = ::getauxval(AT_HWCAP);
+#    if UTL_ARCH_AARCH64
+    auto const hwcap2 = ::getauxval(AT_HWCAP2);
+    // HWCAP_CRC32, HWCAP_SVE and HWCAP2_SVE2 from asm/hwcap.h
+    features.crc32 = hwcap & (1ul << 7);
+    features.sve = hwcap & (1ul << 22);
+    features.sve2 = hwcap2 & (1ul << 1);
+#    else
+    // HWCAP_NEON and HWCAP2_CRC32 from asm/hwcap.h
+    features.neon = hwcap & (1ul << 12);
+    features.crc32 = ::getauxval(AT_HWCAP2) & (1ul << 4);
+#    endif
+#  else
+#    ifdef __ARM_NEON
+    features.neon = true;
+#    endif
+#    ifdef __ARM_FEATURE_CRC32
+    features.crc32 = true;
+#    endif
+#    ifdef __ARM_FEATURE_SVE
+    features.sve = true;
+#    endif
+#    ifdef __ARM_FEATURE_SVE2
+    features.sve2 = true;
+#    endif
+#  endif
+    return features;
+}
+
+#else
+
+cpu_features probe() noexcept {
+    cpu_features features = {};
+    features.last_level_cache_size = configured_cache_size();
+    return features;
+}
+
+#endif
+
+} // namespace
+
+cpu_features const& cpu_features::current() noexcept {
+    static cpu_features const features = probe();
+    return features;
+}
+
+UTL_NAMESPACE_END
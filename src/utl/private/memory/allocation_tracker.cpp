@@ -0,0 +1,37 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_allocation_tracker.h"
+
+#include "utl/memory/utl_allocator_decl.h"
+
+UTL_NAMESPACE_BEGIN
+
+namespace memory {
+namespace {
+// Constant initialized, so the hooks can run before any dynamic initializer
+allocation_tracker global_tracker;
+allocation_tracker adaptor_tracker;
+} // namespace
+
+allocation_tracker& allocation_tracker::global() noexcept {
+    return global_tracker;
+}
+
+allocation_tracker& allocation_tracker::adaptors() noexcept {
+    return adaptor_tracker;
+}
+
+namespace details {
+
+void on_allocate(size_t size) noexcept {
+    global_tracker.record_allocation(size);
+}
+
+void on_deallocate(size_t size) noexcept {
+    global_tracker.record_deallocation(size);
+}
+
+} // namespace details
+} // namespace memory
+
+UTL_NAMESPACE_END
@@ -0,0 +1,130 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_biased_reference_count.h"
+
+#include <stdint.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace details {
+namespace biased_reference_count {
+namespace {
+
+/**
+ * Head of the merge queue of a thread that has exited, objects are merged by the releasing thread
+ */
+counter* const closed = reinterpret_cast<counter*>(uintptr_t(1));
+
+/**
+ * Merges a queued object's biased references into its shared count and clears its queued flag,
+ * must be called by its owner or once its owner has exited
+ */
+void finish(counter* ctr) noexcept {
+    intptr_t delta = -counter::queued_flag;
+    if (ctr->biased_ > 0) {
+        delta += ctr->biased_ * counter::one + counter::merged_flag;
+        ctr->biased_ = -1;
+    }
+
+    if (atomic_acq_rel::fetch_add(&ctr->shared_, delta) + delta == counter::merged_flag) {
+        ctr->destroy_(ctr);
+    }
+}
+
+void finish_all(counter* head) noexcept {
+    while (head != nullptr) {
+        // The object may be destroyed by finish
+        auto const next = head->next_;
+        finish(head);
+        head = next;
+    }
+}
+
+/**
+ * Keeps the calling thread's record alive until the thread exits
+ */
+struct thread_state {
+    ~thread_state() noexcept {
+        auto const record = current_thread<>::record;
+        if (record == nullptr) {
+            return;
+        }
+
+        finish_all(atomic_acq_rel::exchange(&record->deferred, closed));
+        current_thread<>::record = nullptr;
+        release(record);
+    }
+};
+
+} // namespace
+
+owner* acquire_current() UTL_THROWS {
+    auto record = current_thread<>::record;
+    if (record == nullptr) {
+        // Constructed on the first call so that its destructor runs on thread exit
+        static thread_local thread_state state;
+        record = new owner{nullptr, 1};
+        current_thread<>::record = record;
+    }
+
+    atomic_relaxed::fetch_add(&record->references, intptr_t(1));
+    return record;
+}
+
+void release(owner* record) noexcept {
+    if (atomic_acq_rel::fetch_sub(&record->references, intptr_t(1)) == 1) {
+        delete record;
+    }
+}
+
+void unbias(counter* ctr) noexcept {
+    ctr->biased_ = -1;
+    // A queued object is left for the merge queue to destroy
+    if (atomic_acq_rel::fetch_add(&ctr->shared_, counter::merged_flag) + counter::merged_flag ==
+        counter::merged_flag) {
+        ctr->destroy_(ctr);
+    }
+}
+
+void defer(counter* ctr) noexcept {
+    intptr_t const old = atomic_acq_rel::fetch_or(&ctr->shared_, counter::queued_flag);
+    if (old & counter::queued_flag) {
+        return;
+    }
+
+    if (old & counter::merged_flag) {
+        // The owner merged in the meantime, it will never see the queued flag
+        finish(ctr);
+        return;
+    }
+
+    auto const record = ctr->owner_;
+    auto head = atomic_acquire::load(&record->deferred);
+    do {
+        if (head == closed) {
+            finish(ctr);
+            return;
+        }
+
+        ctr->next_ = head;
+    } while (!atomic_acq_rel::compare_exchange_weak(
+        &record->deferred, &head, ctr, atomics::acquire_failure));
+}
+
+void merge_deferred(owner* record) noexcept {
+    finish_all(atomic_acq_rel::exchange(&record->deferred, (counter*)nullptr));
+}
+
+} // namespace biased_reference_count
+} // namespace details
+
+namespace reference_counting {
+void merge_deferred() noexcept {
+    auto const record = __UTL details::biased_reference_count::current_thread<>::record;
+    if (record != nullptr) {
+        __UTL details::biased_reference_count::merge_deferred(record);
+    }
+}
+} // namespace reference_counting
+
+UTL_NAMESPACE_END
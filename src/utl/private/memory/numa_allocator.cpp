@@ -0,0 +1,163 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_numa_allocator.h"
+
+#include <errno.h>
+#include <string.h>
+
+#if UTL_TARGET_LINUX
+
+#  include <fcntl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace {
+
+// Memory policies of <linux/mempolicy.h>, declared here to avoid depending on libnuma headers
+constexpr int mpol_preferred = 1;
+constexpr int mpol_bind = 2;
+constexpr int mpol_interleave = 3;
+
+constexpr unsigned int max_nodes = 1024;
+constexpr unsigned int word_bits = sizeof(unsigned long) * 8;
+
+/**
+ * Parses the highest node of a list such as "0-3,6" from sysfs
+ */
+unsigned int read_node_count() noexcept {
+    int const fd = ::open("/sys/devices/system/node/possible", O_RDONLY);
+    if (fd < 0) {
+        return 1;
+    }
+
+    char buffer[256];
+    auto const length = ::read(fd, buffer, sizeof(buffer) - 1);
+    ::close(fd);
+    unsigned int highest = 0;
+    unsigned int value = 0;
+    for (ssize_t i = 0; i < length; ++i) {
+        if (buffer[i] >= '0' && buffer[i] <= '9') {
+            value = value * 10 + static_cast<unsigned int>(buffer[i] - '0');
+        } else {
+            highest = value > highest ? value : highest;
+            value = 0;
+        }
+    }
+
+    highest = value > highest ? value : highest;
+    return highest < max_nodes ? highest + 1 : max_nodes;
+}
+
+UTL_ATTRIBUTES(NORETURN, NOINLINE) void throw_failure(size_t size, int error) UTL_THROWS {
+    UTL_THROW(bad_alloc(
+        UTL_MESSAGE_FORMAT("[UTL] numa allocation failed, Reason=[%s], size=[%zu]"),
+        ::strerror(error), size));
+}
+
+/**
+ * Applies a placement to a mapping that has not been touched yet
+ *
+ * @return 0 on success or when the system does not allow memory policies, errno otherwise
+ */
+int bind(void* pointer, size_t size, numa_placement placement) noexcept {
+    unsigned long mask[max_nodes / word_bits] = {};
+    int mode = mpol_interleave;
+    if (placement.policy() == numa_placement::mode::interleave) {
+        for (unsigned int node = 0; node != numa::node_count(); ++node) {
+            mask[node / word_bits] |= 1ul << (node % word_bits);
+        }
+    } else {
+        // Local placement only prefers the node so that allocations still succeed once it is full
+        bool const local = placement.policy() == numa_placement::mode::local;
+        unsigned int const node = local ? numa::current_node() : placement.node();
+        if (node >= numa::node_count()) {
+            return EINVAL;
+        }
+
+        mode = local ? mpol_preferred : mpol_bind;
+        mask[node / word_bits] = 1ul << (node % word_bits);
+    }
+
+    // The kernel expects one more than the number of bits in the mask
+    if (::syscall(SYS_mbind, pointer, size, mode, mask, max_nodes + 1, 0) == 0) {
+        return 0;
+    }
+
+    // Sandboxes and kernels without NUMA support reject the call, the memory is placed by the
+    // default policy instead
+    int const error = errno;
+    return error == ENOSYS || error == EPERM ? 0 : error;
+}
+
+} // namespace
+
+namespace numa {
+
+unsigned int node_count() noexcept {
+    static unsigned int const value = read_node_count();
+    return value;
+}
+
+unsigned int current_node() noexcept {
+    unsigned int cpu = 0;
+    unsigned int node = 0;
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+        return 0;
+    }
+
+    return node;
+}
+
+} // namespace numa
+
+namespace details {
+namespace numa_allocator {
+
+allocation_result<void*, size_t> map(
+    size_t size, page_policy policy, numa_placement placement) UTL_THROWS {
+    auto const result = __UTL details::page_allocator::map(size, policy);
+    int const error = bind(result.ptr, result.size, placement);
+    if (error != 0) {
+        __UTL details::page_allocator::unmap(result.ptr, result.size, policy);
+        throw_failure(size, error);
+    }
+
+    return result;
+}
+
+} // namespace numa_allocator
+} // namespace details
+
+UTL_NAMESPACE_END
+
+#else // UTL_TARGET_LINUX
+
+UTL_NAMESPACE_BEGIN
+
+namespace numa {
+
+unsigned int node_count() noexcept {
+    return 1;
+}
+
+unsigned int current_node() noexcept {
+    return 0;
+}
+
+} // namespace numa
+
+namespace details {
+namespace numa_allocator {
+
+allocation_result<void*, size_t> map(size_t size, page_policy policy, numa_placement) UTL_THROWS {
+    return __UTL details::page_allocator::map(size, policy);
+}
+
+} // namespace numa_allocator
+} // namespace details
+
+UTL_NAMESPACE_END
+
+#endif // UTL_TARGET_LINUX
@@ -0,0 +1,346 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_page_allocator.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#if UTL_TARGET_UNIX
+
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace details {
+namespace page_allocator {
+namespace {
+
+constexpr size_t default_huge_page_size = 2 * 1024 * 1024;
+
+size_t read_huge_page_size() noexcept {
+#  if UTL_TARGET_LINUX
+    int const fd = ::open("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", O_RDONLY);
+    if (fd >= 0) {
+        char buffer[32];
+        auto const length = ::read(fd, buffer, sizeof(buffer) - 1);
+        ::close(fd);
+        size_t value = 0;
+        for (ssize_t i = 0; i < length && buffer[i] >= '0' && buffer[i] <= '9'; ++i) {
+            value = value * 10 + static_cast<size_t>(buffer[i] - '0');
+        }
+
+        if (value != 0 && (value & (value - 1)) == 0) {
+            return value;
+        }
+    }
+#  endif
+    return default_huge_page_size;
+}
+
+size_t page_size() noexcept {
+    static size_t const value = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return value;
+}
+
+size_t huge_page_size() noexcept {
+    static size_t const value = read_huge_page_size();
+    return value;
+}
+
+size_t round_up(size_t size, size_t unit) noexcept {
+    return size == 0 ? unit : (size + unit - 1) & ~(unit - 1);
+}
+
+UTL_ATTRIBUTES(NORETURN, NOINLINE) void throw_failure(size_t size, int error) UTL_THROWS {
+    UTL_THROW(bad_alloc(
+        UTL_MESSAGE_FORMAT("[UTL] page allocation failed, Reason=[%s], size=[%zu]"),
+        ::strerror(error), size));
+}
+
+int flags() noexcept {
+    int result = MAP_PRIVATE | MAP_ANONYMOUS;
+#  ifdef MAP_NORESERVE
+    // Commit lazily, the pages are only charged when touched
+    result |= MAP_NORESERVE;
+#  endif
+    return result;
+}
+
+/**
+ * Maps `size` bytes aligned to `alignment` by over-reserving and trimming both ends
+ */
+void* map_aligned(size_t size, size_t alignment) noexcept {
+    size_t const reserved = size + alignment - page_size();
+    void* const base = ::mmap(nullptr, reserved, PROT_READ | PROT_WRITE, flags(), -1, 0);
+    if (base == MAP_FAILED) {
+        return nullptr;
+    }
+
+    auto const address = reinterpret_cast<uintptr_t>(base);
+    auto const aligned = (address + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    if (aligned != address) {
+        ::munmap(base, aligned - address);
+    }
+
+    size_t const tail = reserved - (aligned - address) - size;
+    if (tail != 0) {
+        ::munmap(reinterpret_cast<void*>(aligned + size), tail);
+    }
+
+    return reinterpret_cast<void*>(aligned);
+}
+
+void advise(void* pointer, size_t size, page_policy policy) noexcept {
+#  ifdef MADV_HUGEPAGE
+    if (policy != page_policy::standard) {
+        ::madvise(pointer, size, MADV_HUGEPAGE);
+    }
+#  else
+    (void)pointer;
+    (void)size;
+    (void)policy;
+#  endif
+}
+
+} // namespace
+
+size_t granularity(page_policy policy) noexcept {
+    return policy == page_policy::standard ? page_size() : huge_page_size();
+}
+
+allocation_result<void*, size_t> map(size_t size, page_policy policy) UTL_THROWS {
+    size_t const rounded = round_up(size, granularity(policy));
+    UTL_THROW_IF(rounded < size,
+        bad_alloc(UTL_MESSAGE_FORMAT("[UTL] page allocation failed, "
+                                     "Reason=[size overflow], size=[%zu]"),
+            size));
+
+    if (policy == page_policy::standard) {
+        void* const pointer = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE, flags(), -1, 0);
+        if (pointer == MAP_FAILED) {
+            throw_failure(size, errno);
+        }
+
+        return {pointer, rounded};
+    }
+
+#  ifdef MAP_HUGETLB
+    if (policy == page_policy::explicit_huge) {
+        // Without a reservation a mapping larger than the free huge page pool would only fail with
+        // SIGBUS on first access, reserving makes it fail here and fall back instead
+        void* const pointer = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (pointer != MAP_FAILED) {
+            return {pointer, rounded};
+        }
+    }
+#  endif
+
+    // Aligned to the huge page size so that the kernel can back the whole range with huge pages
+    void* const pointer = map_aligned(rounded, huge_page_size());
+    if (pointer == nullptr) {
+        throw_failure(size, errno);
+    }
+
+    advise(pointer, rounded, policy);
+    return {pointer, rounded};
+}
+
+void unmap(void* pointer, size_t size, page_policy policy) noexcept {
+    if (pointer != nullptr) {
+        ::munmap(pointer, round_up(size, granularity(policy)));
+    }
+}
+
+allocation_result<void*, size_t> remap(
+    void* pointer, size_t old_size, size_t new_size, page_policy policy) UTL_THROWS {
+    if (pointer == nullptr) {
+        return map(new_size, policy);
+    }
+
+    size_t const unit = granularity(policy);
+    size_t const old_rounded = round_up(old_size, unit);
+    size_t const new_rounded = round_up(new_size, unit);
+    UTL_THROW_IF(new_rounded < new_size,
+        bad_alloc(UTL_MESSAGE_FORMAT("[UTL] page reallocation failed, "
+                                     "Reason=[size overflow], size=[%zu]"),
+            new_size));
+    if (old_rounded == new_rounded) {
+        return {pointer, old_rounded};
+    }
+
+#  if UTL_TARGET_LINUX && defined(MREMAP_MAYMOVE)
+    // Moves the page table entries, the contents are never copied. Many kernels cannot grow a
+    // MAP_HUGETLB mapping this way, so any failure falls back to copying below
+    void* const moved = ::mremap(pointer, old_rounded, new_rounded, MREMAP_MAYMOVE);
+    if (moved != MAP_FAILED) {
+        if (new_rounded > old_rounded) {
+            advise(moved, new_rounded, policy);
+        }
+
+        return {moved, new_rounded};
+    }
+#  endif
+
+    if (new_rounded < old_rounded) {
+        ::munmap(static_cast<char*>(pointer) + new_rounded, old_rounded - new_rounded);
+        return {pointer, new_rounded};
+    }
+
+    auto const result = map(new_size, policy);
+    ::memcpy(result.ptr, pointer, old_rounded);
+    ::munmap(pointer, old_rounded);
+    return result;
+}
+
+void decommit(void* pointer, size_t size, page_policy policy) noexcept {
+    // MAP_HUGETLB mappings can only be released in whole huge pages
+    size_t const unit = granularity(policy);
+    auto const address = reinterpret_cast<uintptr_t>(pointer);
+    auto const first = (address + unit - 1) & ~(uintptr_t(unit) - 1);
+    auto const last = (address + size) & ~(uintptr_t(unit) - 1);
+    if (first < last) {
+#  if UTL_TARGET_LINUX
+        if (::madvise(reinterpret_cast<void*>(first), last - first, MADV_DONTNEED) == 0) {
+            return;
+        }
+#  endif
+        // Replacing the pages with a fresh mapping is the portable way to get zeroed pages back,
+        // it also covers kernels that reject MADV_DONTNEED on huge page mappings
+        ::mmap(reinterpret_cast<void*>(first), last - first, PROT_READ | PROT_WRITE,
+            flags() | MAP_FIXED, -1, 0);
+    }
+}
+
+} // namespace page_allocator
+} // namespace details
+
+UTL_NAMESPACE_END
+
+#elif UTL_TARGET_MICROSOFT
+
+#  define NOMINMAX
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+
+#  include <Windows.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace details {
+namespace page_allocator {
+namespace {
+
+size_t allocation_granularity() noexcept {
+    static size_t const value = []() {
+        ::SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwAllocationGranularity);
+    }();
+    return value;
+}
+
+size_t page_size() noexcept {
+    static size_t const value = []() {
+        ::SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+    }();
+    return value;
+}
+
+size_t large_page_size() noexcept {
+    static size_t const value = static_cast<size_t>(::GetLargePageMinimum());
+    return value;
+}
+
+size_t round_up(size_t size, size_t unit) noexcept {
+    return size == 0 ? unit : (size + unit - 1) & ~(unit - 1);
+}
+
+UTL_ATTRIBUTES(NORETURN, NOINLINE) void throw_failure(size_t size) UTL_THROWS {
+    UTL_THROW(bad_alloc(
+        UTL_MESSAGE_FORMAT("[UTL] page allocation failed, Reason=[error %lu], size=[%zu]"),
+        static_cast<unsigned long>(::GetLastError()), size));
+}
+
+} // namespace
+
+size_t granularity(page_policy policy) noexcept {
+    // Windows has no transparent huge pages, large pages must be committed up front
+    return policy == page_policy::explicit_huge && large_page_size() != 0 ? large_page_size()
+                                                                         : allocation_granularity();
+}
+
+allocation_result<void*, size_t> map(size_t size, page_policy policy) UTL_THROWS {
+    size_t const rounded = round_up(size, granularity(policy));
+    UTL_THROW_IF(rounded < size,
+        bad_alloc(UTL_MESSAGE_FORMAT("[UTL] page allocation failed, "
+                                     "Reason=[size overflow], size=[%zu]"),
+            size));
+
+    if (policy == page_policy::explicit_huge && large_page_size() != 0) {
+        void* const pointer = ::VirtualAlloc(
+            nullptr, rounded, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (pointer != nullptr) {
+            return {pointer, rounded};
+        }
+    }
+
+    // Committed pages are only backed by physical memory on first access
+    void* const pointer = ::VirtualAlloc(nullptr, rounded, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (pointer == nullptr) {
+        throw_failure(size);
+    }
+
+    return {pointer, rounded};
+}
+
+void unmap(void* pointer, size_t, page_policy) noexcept {
+    if (pointer != nullptr) {
+        ::VirtualFree(pointer, 0, MEM_RELEASE);
+    }
+}
+
+allocation_result<void*, size_t> remap(
+    void* pointer, size_t old_size, size_t new_size, page_policy policy) UTL_THROWS {
+    if (pointer == nullptr) {
+        return map(new_size, policy);
+    }
+
+    size_t const unit = granularity(policy);
+    size_t const old_rounded = round_up(old_size, unit);
+    if (old_rounded == round_up(new_size, unit)) {
+        return {pointer, old_rounded};
+    }
+
+    auto const result = map(new_size, policy);
+    ::memcpy(result.ptr, pointer, old_rounded < result.size ? old_rounded : result.size);
+    ::VirtualFree(pointer, 0, MEM_RELEASE);
+    return result;
+}
+
+void decommit(void* pointer, size_t size, page_policy policy) noexcept {
+    // Large pages can only be released whole
+    size_t const unit = policy == page_policy::explicit_huge && large_page_size() != 0
+        ? large_page_size()
+        : page_size();
+    auto const address = reinterpret_cast<uintptr_t>(pointer);
+    auto const first = (address + unit - 1) & ~(uintptr_t(unit) - 1);
+    auto const last = (address + size) & ~(uintptr_t(unit) - 1);
+    if (first < last) {
+        ::VirtualFree(reinterpret_cast<void*>(first), last - first, MEM_DECOMMIT);
+        ::VirtualAlloc(reinterpret_cast<void*>(first), last - first, MEM_COMMIT, PAGE_READWRITE);
+    }
+}
+
+} // namespace page_allocator
+} // namespace details
+
+UTL_NAMESPACE_END
+
+#endif // UTL_TARGET_UNIX
@@ -0,0 +1,326 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_allocator_decl.h"
+
+#if UTL_THREAD_CACHING_ALLOCATOR
+
+#  include "utl/atomic/utl_atomic.h"
+#  include "utl/bit/utl_bit_width.h"
+#  include "utl/memory/utl_object_pool.h"
+#  include "utl/utility/utl_exchange.h"
+
+#  include <new>
+#  include <stdint.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace memory {
+namespace details {
+namespace {
+
+using __UTL details::object_pool::depot;
+using __UTL details::object_pool::magazine;
+using __UTL details::object_pool::magazine_capacity;
+
+/**
+ * Size classes are 16 bytes apart up to 128 bytes, then split every power of 2 into 4 classes up
+ * to `small_size_limit`, bounding the internal fragmentation to 25%
+ */
+constexpr size_t linear_classes = 8;
+constexpr size_t class_count = 32;
+constexpr size_t linear_limit = linear_classes * small_alignment;
+static_assert(small_alignment == 16, "Size classes are laid out for a 16 byte alignment");
+
+constexpr size_t span_size = 64 * 1024;
+
+UTL_ATTRIBUTE(ALWAYS_INLINE) inline size_t class_of(size_t size) noexcept {
+    if (size <= linear_limit) {
+        return size == 0 ? 0 : (size - 1) / small_alignment;
+    }
+
+    size_t const last = size - 1;
+    size_t const log2 = __UTL bit_width(last) - 1;
+    return linear_classes + (log2 - 7) * 4 + ((last >> (log2 - 2)) & 3);
+}
+
+constexpr size_t size_of(size_t index) noexcept {
+    return index < linear_classes ? (index + 1) * small_alignment
+                                  : (size_t(4) + (index - linear_classes) % 4 + 1)
+            << ((index - linear_classes) / 4 + 5);
+}
+
+static_assert(size_of(linear_classes - 1) == linear_limit, "Invalid size class layout");
+static_assert(size_of(linear_classes) == 160, "Invalid size class layout");
+static_assert(size_of(class_count - 1) == small_size_limit, "Invalid size class layout");
+
+/**
+ * Number of blocks moved between a thread and the central lists at once, about 8 KiB worth
+ */
+constexpr uint32_t batch_of(size_t index) noexcept {
+    return size_of(index) * magazine_capacity <= 8192 ? uint32_t(magazine_capacity)
+        : 8192 / size_of(index) < 2                   ? 2u
+                                                      : uint32_t(8192 / size_of(index));
+}
+
+static_assert(batch_of(0) == magazine_capacity, "Invalid batch size");
+static_assert(batch_of(class_count - 1) == 2, "Invalid batch size");
+
+/**
+ * Blocks are carved out of spans that are never returned to the heap, every span is linked into
+ * `span_list` so that leak checkers see the blocks as reachable
+ */
+struct span {
+    span* next;
+};
+
+constexpr size_t span_header = small_alignment;
+static_assert(sizeof(span) <= span_header, "Span header does not fit");
+
+span* span_list = nullptr;
+
+/**
+ * Central free lists, holding magazines of free blocks shared by all threads
+ */
+depot central[class_count];
+
+struct free_list {
+    void* head;
+    uint32_t count;
+};
+
+/**
+ * Per-thread free lists, linked through the first word of each free block
+ *
+ * Once the thread's cache is closed, the counts are saturated and the heads cleared so that every
+ * request falls through to the slow paths, which then bypass the cache.
+ */
+struct thread_cache {
+    free_list lists[class_count];
+    bool enrolled;
+    bool closed;
+};
+
+thread_local thread_cache local = {};
+
+UTL_ATTRIBUTE(ALWAYS_INLINE) inline void*& link_of(void* block) noexcept {
+    return *static_cast<void**>(block);
+}
+
+/**
+ * Threads keep up to two batches of each class before returning one to the central list
+ */
+UTL_ATTRIBUTE(ALWAYS_INLINE) inline uint32_t limit_of(size_t index) noexcept {
+    return 2 * batch_of(index);
+}
+
+magazine* acquire_magazine(depot& shared) UTL_THROWS {
+    magazine* mag = shared.empty.pop();
+    if (mag == nullptr && (mag = shared.create()) == nullptr) {
+        UTL_THROW(::std::bad_alloc());
+    }
+
+    mag->count = 0;
+    return mag;
+}
+
+void release_magazine(depot& shared, magazine* mag) noexcept {
+    if (mag->count != 0) {
+        shared.full.push(mag);
+    } else {
+        shared.empty.push(mag);
+    }
+}
+
+/**
+ * Carves a new span into magazines of the class, keeping the first for the caller
+ */
+magazine* carve(size_t index) UTL_THROWS {
+    auto& shared = central[index];
+    size_t const block_size = size_of(index);
+    uint32_t const batch = batch_of(index);
+    size_t const blocks = (span_size - span_header) / block_size;
+    size_t const magazines = (blocks + batch - 1) / batch;
+
+    // Acquire every magazine up front so that a failure never strands the span's blocks
+    magazine* acquired = nullptr;
+    UTL_TRY {
+        for (size_t i = 0; i != magazines; ++i) {
+            magazine* const mag = acquire_magazine(shared);
+            mag->next = acquired;
+            acquired = mag;
+        }
+    } UTL_CATCH(...) {
+        while (acquired != nullptr) {
+            shared.empty.push(exchange(acquired, acquired->next));
+        }
+        UTL_RETHROW();
+    }
+
+    // Spans bypass the allocation hooks, only the blocks handed out are counted
+    void* const memory = ::operator new(span_size, static_cast<align_val_t>(small_alignment));
+    auto const new_span = static_cast<span*>(memory);
+    span* head = atomic_relaxed::load(&span_list);
+    do {
+        new_span->next = head;
+    } while (!atomic_relaxed::compare_exchange_weak(
+        &span_list, &head, new_span, atomics::relaxed_failure));
+
+    char* block = static_cast<char*>(memory) + span_header;
+    magazine* const first = acquired;
+    for (size_t remaining = blocks; acquired != nullptr;) {
+        magazine* const mag = exchange(acquired, acquired->next);
+        size_t const count = remaining < batch ? remaining : batch;
+        for (size_t i = 0; i != count; ++i, block += block_size) {
+            mag->blocks[i] = block;
+        }
+
+        mag->count = count;
+        remaining -= count;
+        if (mag != first) {
+            shared.full.push(mag);
+        }
+    }
+
+    return first;
+}
+
+magazine* fetch(size_t index) UTL_THROWS {
+    magazine* const mag = central[index].full.pop();
+    return mag != nullptr ? mag : carve(index);
+}
+
+/**
+ * Moves up to a batch of blocks from the front of a thread's free list into the central list
+ *
+ * @return false if no magazine could be allocated to hold them
+ */
+bool flush(size_t index, free_list& list) noexcept {
+    auto& shared = central[index];
+    magazine* mag = shared.empty.pop();
+    if (mag == nullptr && (mag = shared.create()) == nullptr) {
+        return false;
+    }
+
+    uint32_t const count = list.count < batch_of(index) ? list.count : batch_of(index);
+    for (uint32_t i = 0; i != count; ++i) {
+        mag->blocks[i] = exchange(list.head, link_of(list.head));
+    }
+
+    mag->count = count;
+    list.count -= count;
+    release_magazine(shared, mag);
+    return true;
+}
+
+/**
+ * Returns the calling thread's free blocks to the central lists on exit
+ */
+struct thread_exit {
+    ~thread_exit() noexcept {
+        auto& cache = local;
+        for (size_t index = 0; index != class_count; ++index) {
+            auto& list = cache.lists[index];
+            while (list.count != 0 && flush(index, list)) {}
+            // Blocks that could not be flushed are leaked
+            list.head = nullptr;
+            list.count = uint32_t(-1);
+        }
+
+        cache.closed = true;
+    }
+};
+
+void enroll(thread_cache& cache) noexcept {
+    static thread_local thread_exit registration;
+    (void)registration;
+    cache.enrolled = true;
+}
+
+UTL_ATTRIBUTE(NOINLINE) void* allocate_slow(size_t index) UTL_THROWS {
+    auto& cache = local;
+    magazine* const mag = fetch(index);
+    if (cache.closed) {
+        void* const block = mag->blocks[--mag->count];
+        release_magazine(central[index], mag);
+        return block;
+    }
+
+    if (!cache.enrolled) {
+        enroll(cache);
+    }
+
+    auto& list = cache.lists[index];
+    void* const block = mag->blocks[--mag->count];
+    while (mag->count != 0) {
+        void* const free_block = mag->blocks[--mag->count];
+        link_of(free_block) = list.head;
+        list.head = free_block;
+        ++list.count;
+    }
+
+    central[index].empty.push(mag);
+    return block;
+}
+
+UTL_ATTRIBUTE(NOINLINE) void deallocate_slow(void* pointer, size_t index) noexcept {
+    auto& cache = local;
+    auto& shared = central[index];
+    if (cache.closed) {
+        magazine* mag = shared.empty.pop();
+        if (mag == nullptr && (mag = shared.create()) == nullptr) {
+            // Leaked, only reachable when the heap is exhausted during thread teardown
+            return;
+        }
+
+        mag->blocks[0] = pointer;
+        mag->count = 1;
+        shared.full.push(mag);
+        return;
+    }
+
+    if (!cache.enrolled) {
+        enroll(cache);
+    }
+
+    // The list may grow past its limit if no magazine can be allocated
+    auto& list = cache.lists[index];
+    flush(index, list);
+    link_of(pointer) = list.head;
+    list.head = pointer;
+    ++list.count;
+}
+
+} // namespace
+
+void* allocate_small(size_t size) UTL_THROWS {
+    size_t const index = class_of(size);
+    auto& list = local.lists[index];
+    void* const block = list.head;
+    if (UTL_BUILTIN_expect(block != nullptr, 1)) {
+        list.head = link_of(block);
+        --list.count;
+        return block;
+    }
+
+    return allocate_slow(index);
+}
+
+void deallocate_small(void* pointer, size_t size) noexcept {
+    size_t const index = class_of(size);
+    auto& list = local.lists[index];
+    if (UTL_BUILTIN_expect(list.count < limit_of(index), 1)) {
+        link_of(pointer) = list.head;
+        list.head = pointer;
+        ++list.count;
+        return;
+    }
+
+    deallocate_slow(pointer, index);
+}
+
+} // namespace details
+} // namespace memory
+
+UTL_NAMESPACE_END
+
+#endif // UTL_THREAD_CACHING_ALLOCATOR
@@ -0,0 +1,88 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/string/utl_libc_simd.h"
+
+#if UTL_LIBC_SIMD_DISPATCH
+
+#  include "utl/atomic/utl_atomic.h"
+#  include "utl/hardware/utl_cpu_features.h"
+
+UTL_NAMESPACE_BEGIN
+
+namespace libc {
+namespace runtime {
+namespace simd {
+namespace details {
+namespace {
+
+template <bool CheckNul, typename T>
+T* sse2_kernel(T const* str, T value, size_t count) noexcept {
+    return first_match<sse2_ops, true, CheckNul>(str, value, count);
+}
+
+template <bool CheckNul, typename T>
+UTL_ATTRIBUTE(FLATTEN) __UTL_LIBC_SIMD_TARGET_AVX2 T* avx2_kernel(T const* str, T value, size_t count) noexcept {
+    return first_match<avx2_ops, true, CheckNul>(str, value, count);
+}
+
+/**
+ * Holds the bound kernel, which starts out as `resolve` so that the first call selects the
+ * implementation; the pointer is constant initialized and safe to call during static
+ * initialization.
+ */
+template <bool CheckNul, typename T>
+struct dispatcher {
+    using kernel_type = T* (*)(T const*, T, size_t);
+
+    static T* resolve(T const* str, T value, size_t count) noexcept {
+        kernel_type const selected =
+            cpu_features::current().avx2 ? &avx2_kernel<CheckNul, T> : &sse2_kernel<CheckNul, T>;
+        atomic_relaxed::store(&kernel, selected);
+        return selected(str, value, count);
+    }
+
+    UTL_ATTRIBUTE(ALWAYS_INLINE) static inline T* call(T const* str, T value, size_t count) noexcept {
+        return atomic_relaxed::load(&kernel)(str, value, count);
+    }
+
+    static kernel_type kernel;
+};
+
+template <bool CheckNul, typename T>
+typename dispatcher<CheckNul, T>::kernel_type dispatcher<CheckNul, T>::kernel =
+    &dispatcher<CheckNul, T>::resolve;
+
+} // namespace
+
+uint8_t* find_or_nul(uint8_t const* str, uint8_t value, size_t count) noexcept {
+    return dispatcher<true, uint8_t>::call(str, value, count);
+}
+
+uint16_t* find_or_nul(uint16_t const* str, uint16_t value, size_t count) noexcept {
+    return dispatcher<true, uint16_t>::call(str, value, count);
+}
+
+uint32_t* find_or_nul(uint32_t const* str, uint32_t value, size_t count) noexcept {
+    return dispatcher<true, uint32_t>::call(str, value, count);
+}
+
+uint8_t* find(uint8_t const* str, uint8_t value, size_t count) noexcept {
+    return dispatcher<false, uint8_t>::call(str, value, count);
+}
+
+uint16_t* find(uint16_t const* str, uint16_t value, size_t count) noexcept {
+    return dispatcher<false, uint16_t>::call(str, value, count);
+}
+
+uint32_t* find(uint32_t const* str, uint32_t value, size_t count) noexcept {
+    return dispatcher<false, uint32_t>::call(str, value, count);
+}
+
+} // namespace details
+} // namespace simd
+} // namespace runtime
+} // namespace libc
+
+UTL_NAMESPACE_END
+
+#endif // UTL_LIBC_SIMD_DISPATCH
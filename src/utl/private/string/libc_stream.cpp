@@ -0,0 +1,172 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/string/utl_libc_runtime.h"
+
+#include "utl/configuration/utl_simd.h"
+#include "utl/hardware/utl_cpu_features.h"
+
+// 32-bit x86 targets built without SSE2 forward to memcpy and memset
+#if UTL_ARCH_x86 && UTL_SIMD_X86_SSE2
+#  include <emmintrin.h>
+#  define __UTL_LIBC_STREAM_STORES 1
+#elif UTL_ARCH_AARCH64 && UTL_SUPPORTS_GNU_ASM
+#  include <arm_neon.h>
+#  define __UTL_LIBC_STREAM_STORES 1
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace libc {
+namespace runtime {
+namespace stream {
+namespace {
+
+/**
+ * Streaming is done in whole cache lines
+ */
+constexpr size_t line_size = 64;
+/**
+ * Used when the cache hierarchy cannot be queried
+ */
+constexpr size_t default_threshold = 4 * 1024 * 1024;
+
+size_t compute_threshold() noexcept {
+#ifdef UTL_LIBC_STREAM_THRESHOLD
+    size_t const result = UTL_LIBC_STREAM_THRESHOLD;
+#else
+    auto const cache_size = cpu_features::current().last_level_cache_size;
+    auto const result = cache_size ? cache_size / 4 * 3 : default_threshold;
+#endif
+    // Leaves room for the unaligned head
+    return result < 2 * line_size ? 2 * line_size : result;
+}
+
+#if UTL_ARCH_x86 && UTL_SIMD_X86_SSE2
+
+struct line_t {
+    __m128i parts[4];
+};
+
+UTL_ATTRIBUTE(ALWAYS_INLINE) inline line_t load_line(unsigned char const* src) noexcept {
+    auto const ptr = reinterpret_cast<__m128i const*>(src);
+    return {{_mm_loadu_si128(ptr), _mm_loadu_si128(ptr + 1), _mm_loadu_si128(ptr + 2),
+        _mm_loadu_si128(ptr + 3)}};
+}
+
+UTL_ATTRIBUTE(ALWAYS_INLINE) inline line_t broadcast_line(unsigned char value) noexcept {
+    auto const v = _mm_set1_epi8(static_cast<char>(value));
+    return {{v, v, v, v}};
+}
+
+UTL_ATTRIBUTE(ALWAYS_INLINE) inline void stream_line(unsigned char* dst, line_t const& line) noexcept {
+    auto const ptr = reinterpret_cast<__m128i*>(dst);
+    _mm_stream_si128(ptr, line.parts[0]);
+    _mm_stream_si128(ptr + 1, line.parts[1]);
+    _mm_stream_si128(ptr + 2, line.parts[2]);
+    _mm_stream_si128(ptr + 3, line.parts[3]);
+}
+
+/**
+ * Non-temporal stores are weakly ordered, fence before the buffer is published
+ */
+UTL_ATTRIBUTE(ALWAYS_INLINE) inline void stream_fence() noexcept {
+    _mm_sfence();
+}
+
+#elif __UTL_LIBC_STREAM_STORES
+
+struct line_t {
+    uint8x16_t parts[4];
+};
+
+UTL_ATTRIBUTE(ALWAYS_INLINE) inline line_t load_line(unsigned char const* src) noexcept {
+    return {{vld1q_u8(src), vld1q_u8(src + 16), vld1q_u8(src + 32), vld1q_u8(src + 48)}};
+}
+
+UTL_ATTRIBUTE(ALWAYS_INLINE) inline line_t broadcast_line(unsigned char value) noexcept {
+    auto const v = vdupq_n_u8(value);
+    return {{v, v, v, v}};
+}
+
+UTL_ATTRIBUTE(ALWAYS_INLINE) inline void stream_line(unsigned char* dst, line_t const& line) noexcept {
+    __asm__ volatile("stnp %q0, %q1, [%2]\n\t"
+                     "stnp %q3, %q4, [%2, #32]"
+                     :
+                     : "w"(line.parts[0]), "w"(line.parts[1]), "r"(dst), "w"(line.parts[2]),
+                     "w"(line.parts[3])
+                     : "memory");
+}
+
+UTL_ATTRIBUTE(ALWAYS_INLINE) inline void stream_fence() noexcept {
+    __asm__ volatile("dmb ishst" ::: "memory");
+}
+
+#endif
+
+} // namespace
+
+size_t threshold() noexcept {
+    static size_t const result = compute_threshold();
+    return result;
+}
+
+void* copy(void* UTL_RESTRICT dst, void const* UTL_RESTRICT src, size_t bytes) noexcept {
+#if __UTL_LIBC_STREAM_STORES
+    if (bytes < threshold()) {
+        return ::memcpy(dst, src, bytes);
+    }
+
+    auto out = static_cast<unsigned char*>(dst);
+    auto in = static_cast<unsigned char const*>(src);
+    // Align the destination to a cache line so that every streamed line is written in full
+    auto const head = (line_size - (reinterpret_cast<uintptr_t>(out) & (line_size - 1))) & (line_size - 1);
+    ::memcpy(out, in, head);
+    out += head;
+    in += head;
+    bytes -= head;
+    for (; bytes >= line_size; bytes -= line_size, out += line_size, in += line_size) {
+        stream_line(out, load_line(in));
+    }
+
+    stream_fence();
+    ::memcpy(out, in, bytes);
+    return dst;
+#else
+    return ::memcpy(dst, src, bytes);
+#endif
+}
+
+void* fill(void* dst, unsigned char value, size_t bytes) noexcept {
+#if __UTL_LIBC_STREAM_STORES
+    if (bytes < threshold()) {
+        return ::memset(dst, value, bytes);
+    }
+
+    auto out = static_cast<unsigned char*>(dst);
+    auto const head = (line_size - (reinterpret_cast<uintptr_t>(out) & (line_size - 1))) & (line_size - 1);
+    ::memset(out, value, head);
+    out += head;
+    bytes -= head;
+    auto const line = broadcast_line(value);
+    for (; bytes >= line_size; bytes -= line_size, out += line_size) {
+        stream_line(out, line);
+    }
+
+    stream_fence();
+    ::memset(out, value, bytes);
+    return dst;
+#else
+    return ::memset(dst, value, bytes);
+#endif
+}
+
+} // namespace stream
+} // namespace runtime
+} // namespace libc
+
+UTL_NAMESPACE_END
+
+#undef __UTL_LIBC_STREAM_STORES
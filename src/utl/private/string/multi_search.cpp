@@ -0,0 +1,168 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/string/utl_multi_search.h"
+
+#include "utl/bit/utl_countr_zero.h"
+#include "utl/configuration/utl_simd.h"
+
+#if UTL_ARCH_x86 && (UTL_SIMD_X86_SSE2 || UTL_COMPILER_MSVC)
+#  define __UTL_TEDDY_SSSE3 1
+#  include <immintrin.h>
+#  if !defined(__SSSE3__) && !UTL_COMPILER_MSVC
+#    define __UTL_TEDDY_DISPATCH 1
+#    define __UTL_TEDDY_TARGET_SSSE3 __attribute__((__target__("ssse3")))
+#    include "utl/atomic/utl_atomic.h"
+#    include "utl/hardware/utl_cpu_features.h"
+#  else
+#    define __UTL_TEDDY_TARGET_SSSE3
+#  endif
+#elif UTL_SIMD_ARM_NEON && UTL_ARCH_AARCH64
+#  define __UTL_TEDDY_NEON 1
+#  include <arm_neon.h>
+#endif
+
+UTL_NAMESPACE_BEGIN
+
+namespace details {
+namespace multi_search {
+namespace {
+
+size_t limit_of(teddy_masks const& masks, size_t count) noexcept {
+    return count >= masks.fingerprint ? count - masks.fingerprint + 1 : 0;
+}
+
+size_t scalar_find(teddy_masks const& masks, unsigned char const* str, size_t offset,
+    size_t limit) noexcept {
+    for (; offset < limit; ++offset) {
+        unsigned int buckets = 0xff;
+        for (size_t pos = 0; pos != masks.fingerprint; ++pos) {
+            auto const byte = str[offset + pos];
+            buckets &= masks.low[pos][byte & 0xf] & masks.high[pos][byte >> 4];
+        }
+
+        if (buckets != 0) {
+            break;
+        }
+    }
+
+    return offset;
+}
+
+#if __UTL_TEDDY_DISPATCH || !(__UTL_TEDDY_SSSE3 || __UTL_TEDDY_NEON)
+size_t scalar_kernel(teddy_masks const& masks, unsigned char const* str, size_t count) noexcept {
+    return scalar_find(masks, str, 0, limit_of(masks, count));
+}
+#endif
+
+/**
+ * Each block tests 16 candidate positions: the k-th fingerprint byte of every position is loaded
+ * from `str + k`, its nibbles index the bucket tables and the results are intersected. Every load
+ * stays within the text, the positions left over are tested by `scalar_find`.
+ */
+#if __UTL_TEDDY_SSSE3
+
+__UTL_TEDDY_TARGET_SSSE3 size_t ssse3_kernel(
+    teddy_masks const& masks, unsigned char const* str, size_t count) noexcept {
+    auto const limit = limit_of(masks, count);
+    auto const nibble = _mm_set1_epi8(0xf);
+    __m128i low[teddy_masks::max_fingerprint];
+    __m128i high[teddy_masks::max_fingerprint];
+    for (size_t pos = 0; pos != masks.fingerprint; ++pos) {
+        low[pos] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(masks.low[pos]));
+        high[pos] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(masks.high[pos]));
+    }
+
+    size_t offset = 0;
+    for (; limit - offset >= 16; offset += 16) {
+        auto buckets = _mm_set1_epi8(-1);
+        for (size_t pos = 0; pos != masks.fingerprint; ++pos) {
+            auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(str + offset + pos));
+            auto const lo = _mm_shuffle_epi8(low[pos], _mm_and_si128(v, nibble));
+            auto const hi =
+                _mm_shuffle_epi8(high[pos], _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+            buckets = _mm_and_si128(buckets, _mm_and_si128(lo, hi));
+        }
+
+        auto const empty = static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(buckets, _mm_setzero_si128())));
+        if (empty != 0xffff) {
+            return offset + __UTL countr_zero(~empty & 0xffff);
+        }
+    }
+
+    return scalar_find(masks, str, offset, limit);
+}
+
+#elif __UTL_TEDDY_NEON
+
+size_t neon_kernel(teddy_masks const& masks, unsigned char const* str, size_t count) noexcept {
+    auto const limit = limit_of(masks, count);
+    auto const nibble = vdupq_n_u8(0xf);
+    uint8x16_t low[teddy_masks::max_fingerprint];
+    uint8x16_t high[teddy_masks::max_fingerprint];
+    for (size_t pos = 0; pos != masks.fingerprint; ++pos) {
+        low[pos] = vld1q_u8(masks.low[pos]);
+        high[pos] = vld1q_u8(masks.high[pos]);
+    }
+
+    size_t offset = 0;
+    for (; limit - offset >= 16; offset += 16) {
+        auto buckets = vdupq_n_u8(0xff);
+        for (size_t pos = 0; pos != masks.fingerprint; ++pos) {
+            auto const v = vld1q_u8(str + offset + pos);
+            auto const lo = vqtbl1q_u8(low[pos], vandq_u8(v, nibble));
+            auto const hi = vqtbl1q_u8(high[pos], vshrq_n_u8(v, 4));
+            buckets = vandq_u8(buckets, vandq_u8(lo, hi));
+        }
+
+        // Narrows each lane to a nibble, there is no movemask equivalent
+        auto const candidates = vtstq_u8(buckets, buckets);
+        auto const mask = vget_lane_u64(
+            vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(candidates), 4)), 0);
+        if (mask != 0) {
+            return offset + __UTL countr_zero(mask) / 4;
+        }
+    }
+
+    return scalar_find(masks, str, offset, limit);
+}
+
+#endif
+
+#if __UTL_TEDDY_DISPATCH
+
+using kernel_type = size_t (*)(teddy_masks const&, unsigned char const*, size_t);
+
+size_t resolve(teddy_masks const& masks, unsigned char const* str, size_t count) noexcept;
+
+/**
+ * Starts out as `resolve` so that the first call selects the implementation
+ */
+kernel_type kernel = &resolve;
+
+size_t resolve(teddy_masks const& masks, unsigned char const* str, size_t count) noexcept {
+    kernel_type const selected = cpu_features::current().ssse3 ? &ssse3_kernel : &scalar_kernel;
+    atomic_relaxed::store(&kernel, selected);
+    return selected(masks, str, count);
+}
+
+#endif
+
+} // namespace
+
+size_t teddy_find(teddy_masks const& masks, unsigned char const* str, size_t count) noexcept {
+#if __UTL_TEDDY_DISPATCH
+    return atomic_relaxed::load(&kernel)(masks, str, count);
+#elif __UTL_TEDDY_SSSE3
+    return ssse3_kernel(masks, str, count);
+#elif __UTL_TEDDY_NEON
+    return neon_kernel(masks, str, count);
+#else
+    return scalar_kernel(masks, str, count);
+#endif
+}
+
+} // namespace multi_search
+} // namespace details
+
+UTL_NAMESPACE_END
@@ -0,0 +1,97 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/tempus/utl_coarse_clock.h"
+
+#if UTL_TARGET_UNIX
+
+#  include <pthread.h>
+#  include <time.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace tempus {
+namespace {
+
+enum class ticker_state : int {
+    stopped,
+    starting,
+    running,
+    stopping
+};
+
+ticker_state state = ticker_state::stopped;
+bool stop_requested = false;
+::pthread_t ticker_thread;
+
+} // namespace
+
+int64_t clock_traits<coarse_clock_t>::published_ = 0;
+
+auto clock_traits<coarse_clock_t>::read() noexcept -> value_type {
+    ::timespec ts;
+#  if UTL_TARGET_LINUX && defined(CLOCK_MONOTONIC_COARSE)
+    ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#  else
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+#  endif
+    return static_cast<value_type>(ts.tv_sec) * 1000000000ll + static_cast<value_type>(ts.tv_nsec);
+}
+
+void coarse_clock_t::publish(int64_t value) noexcept {
+    atomic_relaxed::store(&clock_traits<coarse_clock_t>::published_, value);
+}
+
+void* coarse_clock_t::tick(void*) noexcept {
+    static constexpr ::timespec interval = {UTL_COARSE_CLOCK_RESOLUTION_US / 1000000,
+        (UTL_COARSE_CLOCK_RESOLUTION_US % 1000000) * 1000};
+    while (!atomic_acquire::load(&stop_requested)) {
+        publish(clock_traits<coarse_clock_t>::read());
+        ::nanosleep(&interval, nullptr);
+    }
+
+    return nullptr;
+}
+
+bool coarse_clock_t::start() noexcept {
+    auto expected = ticker_state::stopped;
+    if (!atomic_acq_rel::compare_exchange_strong(
+            &state, &expected, ticker_state::starting, atomics::acquire_failure)) {
+        // Wait out a concurrent start or stop
+        while (expected == ticker_state::starting || expected == ticker_state::stopping) {
+            expected = atomic_acquire::load(&state);
+        }
+
+        return expected == ticker_state::running || start();
+    }
+
+    atomic_relaxed::store(&stop_requested, false);
+    // Publish before the thread starts so that readers never observe a stale value
+    publish(clock_traits<coarse_clock_t>::read());
+    if (::pthread_create(&ticker_thread, nullptr, &tick, nullptr) != 0) {
+        publish(0);
+        atomic_release::store(&state, ticker_state::stopped);
+        return false;
+    }
+
+    atomic_release::store(&state, ticker_state::running);
+    return true;
+}
+
+void coarse_clock_t::stop() noexcept {
+    auto expected = ticker_state::running;
+    if (!atomic_acq_rel::compare_exchange_strong(
+            &state, &expected, ticker_state::stopping, atomics::acquire_failure)) {
+        return;
+    }
+
+    atomic_release::store(&stop_requested, true);
+    ::pthread_join(ticker_thread, nullptr);
+    publish(0);
+    atomic_release::store(&state, ticker_state::stopped);
+}
+
+} // namespace tempus
+
+UTL_NAMESPACE_END
+
+#endif // UTL_TARGET_UNIX
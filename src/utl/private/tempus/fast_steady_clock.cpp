@@ -0,0 +1,237 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/tempus/utl_fast_steady_clock.h"
+
+#if UTL_TARGET_UNIX
+
+#  include "utl/atomic/utl_atomic.h"
+#  include "utl/hardware/utl_instruction_barrier.h"
+
+#  if UTL_ARCH_x86
+#    include "utl/hardware/x86/utl_cpuid.h"
+#  endif
+
+#  include <time.h>
+
+#  ifndef UTL_FAST_STEADY_CLOCK_RESYNC_MS
+#    define UTL_FAST_STEADY_CLOCK_RESYNC_MS 1000
+#  endif
+
+#  ifndef UTL_FAST_STEADY_CLOCK_CALIBRATION_US
+#    define UTL_FAST_STEADY_CLOCK_CALIBRATION_US 2000
+#  endif
+
+UTL_NAMESPACE_BEGIN
+
+namespace tempus {
+namespace {
+
+/**
+ * Fixed point precision of the tick to nanosecond multiplier
+ */
+constexpr unsigned int mult_shift = 32;
+constexpr uint64_t nano = 1000000000;
+
+struct calibration_t {
+    uint64_t tsc_base;
+    uint64_t ns_base;
+    uint64_t mult;
+};
+
+struct sample_t {
+    uint64_t tsc;
+    uint64_t ns;
+};
+
+struct clock_state_t {
+    /**
+     * Sequence lock guarding `params`, odd while a re-sync is in progress
+     */
+    uint32_t sequence;
+    calibration_t params;
+    /**
+     * First calibration sample, re-syncs measure the rate over the entire lifetime of the process
+     */
+    sample_t origin;
+    uint64_t resync_ticks;
+    bool use_tsc;
+};
+
+UTL_ATTRIBUTE(ALWAYS_INLINE) inline uint64_t mul_shift(uint64_t delta, uint64_t mult) noexcept {
+#  if UTL_SUPPORTS_INT128
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(delta) * mult) >> mult_shift);
+#  else
+    static constexpr uint64_t low_mask = (1ull << mult_shift) - 1;
+    return (delta >> mult_shift) * mult + (((delta & low_mask) * mult) >> mult_shift);
+#  endif
+}
+
+UTL_ATTRIBUTE(ALWAYS_INLINE) inline uint64_t read_tsc() noexcept {
+    return static_cast<uint64_t>(
+        get_time(hardware_clock, instruction_barrier_none).time_since_epoch().value());
+}
+
+uint64_t monotonic_ns() noexcept {
+    ::timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * nano + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+bool invariant_tsc() noexcept {
+#  if UTL_ARCH_x86
+    // CPUID.80000007H:EDX[8], queried directly since the TSC frequency need not be enumerated
+    if (x86::cpuid<0x80000000>().eax < 0x80000007) {
+        return false;
+    }
+
+    return x86::cpuid<0x80000007>().edx & (1 << 8);
+#  else
+    return hardware_ticks::invariant_frequency();
+#  endif
+}
+
+/**
+ * Pairs a hardware clock read with a monotonic read, keeping the tightest of a few attempts
+ */
+sample_t take_sample() noexcept {
+    sample_t best = {0, 0};
+    uint64_t best_window = uint64_t(-1);
+    for (int attempt = 0; attempt < 5; ++attempt) {
+        auto const before = read_tsc();
+        auto const ns = monotonic_ns();
+        auto const after = read_tsc();
+        if (after >= before && after - before < best_window) {
+            best_window = after - before;
+            best = {before + (after - before) / 2, ns};
+        }
+    }
+
+    return best;
+}
+
+uint64_t compute_mult(sample_t const& from, sample_t const& to) noexcept {
+    auto const ticks = to.tsc - from.tsc;
+    auto const ns = to.ns - from.ns;
+#  if UTL_SUPPORTS_INT128
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(ns) << mult_shift) / ticks);
+#  else
+    return static_cast<uint64_t>(static_cast<long double>(ns) * (1ull << mult_shift) / ticks);
+#  endif
+}
+
+clock_state_t initialize() noexcept {
+    clock_state_t state = {};
+    if (!invariant_tsc()) {
+        return state;
+    }
+
+    auto const start = take_sample();
+    static constexpr uint64_t calibration_ns = UTL_FAST_STEADY_CLOCK_CALIBRATION_US * 1000ull;
+    while (monotonic_ns() - start.ns < calibration_ns) {}
+    auto const end = take_sample();
+    if (end.tsc <= start.tsc || end.ns <= start.ns) {
+        return state;
+    }
+
+    auto const mult = compute_mult(start, end);
+    if (!mult) {
+        return state;
+    }
+
+    static constexpr uint64_t resync_ns = UTL_FAST_STEADY_CLOCK_RESYNC_MS * 1000000ull;
+    state.params = {end.tsc, end.ns, mult};
+    state.origin = start;
+    state.resync_ticks = static_cast<uint64_t>(
+        (static_cast<long double>(resync_ns) * (1ull << mult_shift)) / mult);
+    state.use_tsc = state.resync_ticks != 0;
+    return state;
+}
+
+/**
+ * Calibrates on first use so that processes which never read the clock do not pay for the
+ * calibration spin during static initialization
+ */
+clock_state_t& clock_state() noexcept {
+    static clock_state_t state = initialize();
+    return state;
+}
+
+calibration_t load_params(clock_state_t& state) noexcept {
+    calibration_t result;
+    uint32_t sequence;
+    do {
+        sequence = atomic_acquire::load(&state.sequence);
+        result.tsc_base = atomic_relaxed::load(&state.params.tsc_base);
+        result.ns_base = atomic_relaxed::load(&state.params.ns_base);
+        result.mult = atomic_relaxed::load(&state.params.mult);
+        atomic_acquire::thread_fence();
+    } while ((sequence & 1) || atomic_relaxed::load(&state.sequence) != sequence);
+
+    return result;
+}
+
+/**
+ * Re-anchors the conversion at the current tick so the clock stays continuous, then picks a rate
+ * that absorbs the drift from `CLOCK_MONOTONIC` over the next re-sync interval
+ */
+UTL_ATTRIBUTE(NOINLINE) calibration_t resync(
+    clock_state_t& state, calibration_t const& current) noexcept {
+    auto sequence = atomic_relaxed::load(&state.sequence);
+    if ((sequence & 1) ||
+        !atomic_relaxed::compare_exchange_strong(
+            &state.sequence, &sequence, sequence + 1, atomics::relaxed_failure)) {
+        // Another thread is re-syncing
+        return current;
+    }
+
+    atomic_release::thread_fence();
+    auto const sample = take_sample();
+    calibration_t next = current;
+    if (sample.tsc > current.tsc_base) {
+        auto const continuous_ns = current.ns_base + mul_shift(sample.tsc - current.tsc_base, current.mult);
+        auto const rate = compute_mult(state.origin, sample);
+        // Slew the error away over one interval, never by more than half the measured rate
+        auto const error_ns = static_cast<int64_t>(sample.ns - continuous_ns);
+        auto const correction =
+            static_cast<int64_t>((static_cast<long double>(error_ns) * (1ull << mult_shift)) /
+                static_cast<long double>(state.resync_ticks));
+        auto const limit = static_cast<int64_t>(rate / 2);
+        auto const bounded = correction > limit ? limit : correction < -limit ? -limit : correction;
+        next = {sample.tsc, continuous_ns, static_cast<uint64_t>(static_cast<int64_t>(rate) + bounded)};
+    }
+
+    atomic_relaxed::store(&state.params.tsc_base, next.tsc_base);
+    atomic_relaxed::store(&state.params.ns_base, next.ns_base);
+    atomic_relaxed::store(&state.params.mult, next.mult);
+    atomic_release::store(&state.sequence, sequence + 2);
+    return next;
+}
+} // namespace
+
+bool fast_steady_clock_t::calibrated() noexcept {
+    return clock_state().use_tsc;
+}
+
+auto clock_traits<fast_steady_clock_t>::now() noexcept -> value_type {
+    auto& state = clock_state();
+    if (!state.use_tsc) {
+        return static_cast<value_type>(monotonic_ns());
+    }
+
+    auto const tsc = read_tsc();
+    auto params = load_params(state);
+    // Counters on different cores may be marginally out of step
+    auto delta = tsc > params.tsc_base ? tsc - params.tsc_base : 0;
+    if (UTL_BUILTIN_expect(delta > state.resync_ticks, 0)) {
+        params = resync(state, params);
+        delta = tsc > params.tsc_base ? tsc - params.tsc_base : 0;
+    }
+
+    return static_cast<value_type>(params.ns_base + mul_shift(delta, params.mult));
+}
+
+} // namespace tempus
+
+UTL_NAMESPACE_END
+
+#endif // UTL_TARGET_UNIX
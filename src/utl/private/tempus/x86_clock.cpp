@@ -177,12 +177,14 @@ duration to_duration(hardware_ticks t) noexcept {
         return duration::invalid();
     }
 
-    if (t) {
+    if (!t) {
         return duration::invalid();
     }
 
-    static constexpr unsigned int nano = 1000000000;
-    return t.value() * nano / tsc_frequency().value;
+    // Split into whole seconds first to avoid overflowing the intermediate product
+    static constexpr int64_t nano = 1000000000;
+    int64_t const frequency = tsc_frequency().value;
+    return duration{t.value() / frequency, (t.value() % frequency) * nano / frequency};
 }
 
 #  define __UTL_DEFINE_GET_TIME(ORDER)                                      \
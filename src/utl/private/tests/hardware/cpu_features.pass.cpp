@@ -0,0 +1,150 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/hardware/utl_cpu_features.h"
+#include "utl/string/utl_libc_simd.h"
+
+#include <cassert>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace {
+bool same_features(utl::cpu_features const& l, utl::cpu_features const& r) {
+    return l.sse2 == r.sse2 && l.ssse3 == r.ssse3 && l.sse4_2 == r.sse4_2 &&
+        l.popcnt == r.popcnt && l.avx == r.avx && l.avx2 == r.avx2 && l.bmi1 == r.bmi1 &&
+        l.bmi2 == r.bmi2 && l.avx512f == r.avx512f && l.avx512bw == r.avx512bw &&
+        l.avx512vl == r.avx512vl && l.erms == r.erms && l.fsrm == r.fsrm && l.neon == r.neon &&
+        l.crc32 == r.crc32 && l.sve == r.sve && l.sve2 == r.sve2 &&
+        l.last_level_cache_size == r.last_level_cache_size;
+}
+
+void check_features() {
+    auto const& features = utl::cpu_features::current();
+    utl::cpu_features const first = features;
+    for (int i = 0; i < 100; ++i) {
+        // Probed once, every query returns the same object with the same values
+        assert(&utl::cpu_features::current() == &features);
+        assert(same_features(utl::cpu_features::current(), first));
+    }
+
+    // Extensions are only reported together with the extensions they build on
+    assert(!features.avx2 || features.avx);
+    assert(!features.avx512bw || features.avx512f);
+    assert(!features.avx512vl || features.avx512f);
+    assert(!features.sve2 || features.sve);
+
+#if UTL_ARCH_x86_64
+    // Part of the x86-64 baseline
+    assert(features.sse2);
+    assert(!features.neon && !features.sve);
+#elif UTL_ARCH_AARCH64
+    assert(features.neon);
+    assert(!features.sse2 && !features.avx);
+#endif
+
+#if UTL_SIMD_X86_AVX2
+    // The binary could not run at all without it
+    assert(features.avx2);
+#endif
+}
+
+#if UTL_LIBC_SIMD
+namespace details = utl::libc::runtime::simd::details;
+
+template <typename T>
+using kernel_type = T* (*)(T const*, T, size_t);
+
+template <bool CheckNul, typename T>
+T* scalar_kernel(T const* str, T value, size_t count) {
+    for (size_t idx = 0; idx < count; ++idx) {
+        if (str[idx] == value || (CheckNul && str[idx] == 0)) {
+            return const_cast<T*>(str + idx);
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * The baseline kernel, SSE2 or NEON
+ */
+template <bool CheckNul, typename T>
+T* vector_kernel(T const* str, T value, size_t count) {
+    return details::first_match<details::vector_ops, true, CheckNul>(str, value, count);
+}
+
+#  if UTL_SIMD_X86_AVX2 || UTL_LIBC_SIMD_DISPATCH
+template <bool CheckNul, typename T>
+UTL_ATTRIBUTE(FLATTEN) __UTL_LIBC_SIMD_TARGET_AVX2 T* avx2_kernel(
+    T const* str, T value, size_t count) {
+    return details::first_match<details::avx2_ops, true, CheckNul>(str, value, count);
+}
+#  endif
+
+/**
+ * The kernel the library binds, dispatched at runtime where supported
+ */
+template <bool CheckNul, typename T>
+T* bound_kernel(T const* str, T value, size_t count) {
+    return details::search<true, CheckNul>(str, value, count);
+}
+
+template <bool CheckNul, typename T>
+size_t available_kernels(kernel_type<T> (&kernels)[3]) {
+    size_t count = 0;
+    kernels[count++] = &vector_kernel<CheckNul, T>;
+#  if UTL_SIMD_X86_AVX2 || UTL_LIBC_SIMD_DISPATCH
+    if (utl::cpu_features::current().avx2) {
+        kernels[count++] = &avx2_kernel<CheckNul, T>;
+    }
+#  endif
+    kernels[count++] = &bound_kernel<CheckNul, T>;
+    return count;
+}
+
+template <bool CheckNul, typename T>
+void check_kernels() {
+    constexpr size_t buffer_size = 512 / sizeof(T);
+    alignas(64) T buffer[buffer_size];
+    T const alphabet[] = {T(0), T('a'), T('b'), T('x')};
+
+    kernel_type<T> kernels[3];
+    size_t const kernel_count = available_kernels<CheckNul, T>(kernels);
+
+    uint32_t state = 12345;
+    for (int round = 0; round < 64; ++round) {
+        for (auto& c : buffer) {
+            // Sparse NULs and matches among filler
+            state = state * 1103515245 + 12345;
+            auto const r = (state >> 16) & 31;
+            c = r < 1 ? alphabet[0] : r < 2 ? alphabet[3] : alphabet[1 + (r & 1)];
+        }
+
+        for (size_t offset = 0; offset < 64 / sizeof(T); ++offset) {
+            for (size_t count = 0; count + offset <= buffer_size; count += 1 + count / 8) {
+                T const* const str = buffer + offset;
+                T* const expected = scalar_kernel<CheckNul>(str, T('x'), count);
+                for (size_t idx = 0; idx < kernel_count; ++idx) {
+                    assert(kernels[idx](str, T('x'), count) == expected);
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void check_kernels() {
+    check_kernels<true, T>();
+    check_kernels<false, T>();
+}
+#endif // UTL_LIBC_SIMD
+} // namespace
+
+int main() {
+    check_features();
+#if UTL_LIBC_SIMD
+    check_kernels<uint8_t>();
+    check_kernels<uint16_t>();
+    check_kernels<uint32_t>();
+#endif
+    return 0;
+}
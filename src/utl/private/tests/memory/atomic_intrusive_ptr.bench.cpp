@@ -0,0 +1,108 @@
+// Copyright 2023-2024 Bryan Wong
+
+// Compares the aggregate load throughput of atomic_intrusive_ptr with a mutex-protected
+// intrusive_ptr as the number of concurrent readers grows
+
+#include "utl/memory/utl_atomic_intrusive_ptr.h"
+#include "utl/memory/utl_atomic_reference_count.h"
+#include "utl/tempus/utl_clock.h"
+
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr size_t loads_per_reader = 2000000;
+constexpr unsigned int max_readers = 16;
+
+struct snapshot : utl::atomic_reference_count<snapshot> {
+    explicit snapshot(int v) : version(v) {}
+    int version;
+};
+
+class mutex_slot {
+public:
+    explicit mutex_slot(utl::intrusive_ptr<snapshot> ptr)
+        : ptr_(static_cast<utl::intrusive_ptr<snapshot>&&>(ptr)) {}
+
+    utl::intrusive_ptr<snapshot> load() const {
+        std::lock_guard<std::mutex> guard(mutex_);
+        return ptr_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    utl::intrusive_ptr<snapshot> ptr_;
+};
+
+double seconds(utl::tempus::duration d) {
+    return d.seconds() + d.nanoseconds() * 1e-9;
+}
+
+/**
+ * @return Millions of loads per second across all readers, or a negative value if a load
+ * returned the wrong object
+ */
+template <typename Slot>
+double loads_per_second(Slot const& slot, unsigned int readers) {
+    std::atomic<unsigned int> ready{0};
+    std::atomic<bool> start{false};
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> threads;
+    for (unsigned int idx = 0; idx < readers; ++idx) {
+        threads.emplace_back([&]() {
+            ready.fetch_add(1);
+            while (!start.load(std::memory_order_acquire)) {}
+            long sum = 0;
+            for (size_t count = 0; count < loads_per_reader; ++count) {
+                sum += slot.load()->version;
+            }
+
+            if (sum != long(loads_per_reader)) {
+                failed = true;
+            }
+        });
+    }
+
+    while (ready.load() != readers) {}
+    auto const begin = get_time(utl::tempus::steady_clock);
+    start.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto const elapsed = seconds(get_time(utl::tempus::steady_clock) - begin);
+    if (failed) {
+        return -1;
+    }
+
+    return double(loads_per_reader) * readers / elapsed * 1e-6;
+}
+} // namespace
+
+int main() {
+    auto const make = []() {
+        return utl::intrusive_ptr<snapshot>(utl::adopt_object, new snapshot(1));
+    };
+    utl::atomic_intrusive_ptr<snapshot> const atomic_slot(make());
+    mutex_slot const locked_slot(make());
+
+    unsigned int const hardware = std::thread::hardware_concurrency();
+    ::printf("hardware threads: %u\n", hardware);
+    ::printf("%8s %12s %12s (M loads/s)\n", "readers", "atomic", "mutex");
+    for (unsigned int readers = 1; readers <= max_readers; readers *= 2) {
+        auto const atomic_rate = loads_per_second(atomic_slot, readers);
+        auto const mutex_rate = loads_per_second(locked_slot, readers);
+        if (atomic_rate < 0 || mutex_rate < 0) {
+            ::fprintf(stderr, "a load returned the wrong object with %u readers\n", readers);
+            return 1;
+        }
+
+        ::printf("%8u %12.1f %12.1f%s\n", readers, atomic_rate, mutex_rate,
+            hardware && readers > hardware ? " (oversubscribed)" : "");
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_atomic_intrusive_ptr.h"
+#include "utl/memory/utl_atomic_reference_count.h"
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+namespace {
+std::atomic<int> live{0};
+
+struct snapshot : utl::atomic_reference_count<snapshot> {
+    explicit snapshot(int v) : version(v) { ++live; }
+    ~snapshot() { --live; }
+    int version;
+};
+
+// Only provides single-step counting, batches are paid one reference at a time
+struct plain {
+    explicit plain(int v) : version(v) { ++live; }
+    ~plain() { --live; }
+    friend void increment(plain& obj) noexcept { obj.count.fetch_add(1, std::memory_order_relaxed); }
+    friend void decrement(plain& obj) noexcept {
+        if (obj.count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete &obj;
+        }
+    }
+
+    std::atomic<int> count{1};
+    int version;
+};
+
+template <typename T>
+utl::intrusive_ptr<T> make(int version) {
+    return utl::intrusive_ptr<T>(utl::adopt_object, new T(version));
+}
+
+template <typename T>
+void run() {
+    {
+        utl::atomic_intrusive_ptr<T> slot;
+        assert(!slot.load());
+        slot.store(make<T>(0));
+
+        // Enough loads to go through several top-ups of the prepaid references
+        for (int i = 0; i < 100000; ++i) {
+            assert(slot.load()->version == 0);
+        }
+
+        auto expected = make<T>(-1);
+        assert(!slot.compare_exchange_strong(expected, make<T>(1)));
+        assert(expected->version == 0);
+        assert(slot.compare_exchange_strong(expected, make<T>(1)));
+        assert(slot.load()->version == 1);
+
+        std::atomic<bool> stop{false};
+        std::thread readers[3];
+        for (auto& reader : readers) {
+            reader = std::thread([&]() {
+                int last = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    auto const current = slot.load();
+                    assert(current->version >= last);
+                    last = current->version;
+                }
+            });
+        }
+
+        for (int version = 2; version < 2000; ++version) {
+            slot.store(make<T>(version));
+        }
+
+        stop = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        auto const last = slot.exchange(utl::intrusive_ptr<T>());
+        assert(last->version == 1999);
+        assert(!slot.load());
+    }
+
+    assert(live == 0);
+}
+} // namespace
+
+int main() {
+    run<snapshot>();
+    run<plain>();
+    return 0;
+}
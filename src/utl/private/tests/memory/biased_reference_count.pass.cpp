@@ -0,0 +1,86 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_biased_reference_count.h"
+#include "utl/memory/utl_borrowed_ptr.h"
+#include "utl/memory/utl_intrusive_ptr.h"
+#include "utl/memory/utl_is_reference_countable.h"
+
+#include <cassert>
+#include <thread>
+
+namespace {
+int live = 0;
+
+struct node : utl::biased_reference_count<node> {
+    node() { ++live; }
+    ~node() { --live; }
+};
+
+static_assert(utl::is_reference_countable<node>::value, "");
+static_assert(utl::is_reference_countable<node const>::value, "");
+
+int observe(utl::borrowed_ptr<node> ptr) {
+    return ptr ? 1 : 0;
+}
+} // namespace
+
+int main() {
+    // Copies made by the owner never leave the thread
+    {
+        auto ptr = utl::make_intrusive_ptr<node>();
+        auto copy = ptr;
+        assert(live == 1);
+        assert(observe(ptr) == 1);
+        assert(observe(nullptr) == 0);
+        utl::borrowed_ptr<node> const borrowed(copy);
+        assert(borrowed == utl::borrowed_ptr<node>(ptr.get()));
+        auto retained = borrowed.retain();
+        assert(retained == ptr);
+    }
+    assert(live == 0);
+
+    // The owner's last reference merges the counts, the other thread's release destroys the object
+    {
+        auto ptr = utl::make_intrusive_ptr<node>();
+        utl::intrusive_ptr<node> shared;
+        std::thread([&]() { shared = ptr; }).join();
+        ptr.reset();
+        assert(live == 1);
+        std::thread([&shared]() { shared.reset(); }).join();
+        assert(live == 0);
+    }
+
+    // A reference taken by the owner and released elsewhere is queued back to the owner
+    {
+        auto ptr = utl::make_intrusive_ptr<node>();
+        auto shared = ptr;
+        std::thread([&shared]() { shared.reset(); }).join();
+        assert(live == 1);
+        ptr.reset();
+        assert(live == 0);
+    }
+
+    // Objects whose owner exited are merged by the releasing thread
+    {
+        utl::intrusive_ptr<node> orphan;
+        std::thread([&orphan]() { orphan = utl::make_intrusive_ptr<node>(); }).join();
+        assert(live == 1);
+        orphan.reset();
+        assert(live == 0);
+    }
+
+    // Objects released elsewhere last are destroyed on the owner's next merge
+    {
+        auto ptr = utl::make_intrusive_ptr<node>();
+        auto first = ptr;
+        auto second = ptr;
+        ptr.reset();
+        first.reset();
+        std::thread([&second]() { second.reset(); }).join();
+        assert(live == 1);
+        utl::reference_counting::merge_deferred();
+        assert(live == 0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_compressed_ptr.h"
+#include "utl/memory/utl_pointer_traits.h"
+
+#include <cassert>
+#include <new>
+
+namespace {
+alignas(16) unsigned char buffer[1024];
+
+struct arena {
+    static void* base() noexcept { return buffer; }
+};
+
+struct node;
+using node_ptr = utl::compressed_ptr<node, arena>;
+
+struct node {
+    node_ptr left;
+    node_ptr right;
+    int key;
+};
+} // namespace
+
+static_assert(sizeof(node_ptr) == 4, "");
+static_assert(sizeof(node) == 12, "");
+static_assert(sizeof(utl::pointer_traits<node_ptr>::element_type) == sizeof(node), "");
+
+int main() {
+    node* const nodes = new (buffer) node[3]();
+    assert(!nodes[0].left && nodes[0].left == nullptr);
+
+    nodes[0].left = node_ptr(&nodes[1]);
+    nodes[0].right = node_ptr::pointer_to(nodes[2]);
+    nodes[2].key = 5;
+    assert(nodes[0].left.get() == &nodes[1]);
+    assert(nodes[0].right->key == 5);
+    assert(nodes[0].left != nodes[0].right);
+
+    // The first object of the arena is distinct from null
+    node_ptr first(&nodes[0]);
+    assert(first && first.get() == &nodes[0]);
+    auto const copy = node_ptr::from_offset(first.offset());
+    assert(copy == first);
+    assert(node_ptr(nullptr).get() == nullptr);
+    return 0;
+}
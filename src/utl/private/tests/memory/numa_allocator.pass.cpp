@@ -0,0 +1,65 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_allocator_traits.h"
+#include "utl/memory/utl_numa_allocator.h"
+
+#include <cassert>
+
+#ifdef __linux__
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+namespace {
+/**
+ * Returns the memory policy applied to the mapping containing `address`, or -1 if it cannot be
+ * queried
+ */
+int policy_of(void* address) {
+#ifdef __linux__
+    int mode = -1;
+    unsigned long mask[1024 / (sizeof(unsigned long) * 8)] = {};
+    // MPOL_F_ADDR
+    if (::syscall(SYS_get_mempolicy, &mode, mask, 1025, address, 2) == 0) {
+        return mode;
+    }
+#endif
+    (void)address;
+    return -1;
+}
+
+void check(utl::numa_placement placement, int expected_policy) {
+    using allocator_type = utl::numa_allocator<int>;
+    using traits = utl::allocator_traits<allocator_type>;
+    allocator_type alloc(placement);
+    assert(alloc == utl::numa_allocator<long>(placement));
+
+    auto block = traits::allocate_at_least(alloc, 1000);
+    assert(block.size >= 1000);
+    int const policy = policy_of(block.ptr);
+    assert(policy == -1 || policy == expected_policy);
+    for (size_t i = 0; i < block.size; ++i) {
+        block.ptr[i] = static_cast<int>(i);
+    }
+
+    // The policy follows the pages when they are moved
+    block = traits::reallocate_at_least(alloc, block, 1 << 20);
+    assert(block.ptr[999] == 999);
+    assert(policy == -1 || policy_of(block.ptr + (1 << 19)) == expected_policy);
+    traits::deallocate(alloc, block.ptr, block.size);
+}
+} // namespace
+
+int main() {
+    unsigned int const nodes = utl::numa::node_count();
+    assert(nodes >= 1);
+    assert(utl::numa::current_node() < nodes);
+
+    assert(utl::numa_allocator<int>() != utl::numa_allocator<int>(utl::numa_placement::on_node(0)));
+
+    // MPOL_PREFERRED, MPOL_BIND and MPOL_INTERLEAVE; a single node box only checks the calls
+    check(utl::numa_placement::local(), 1);
+    check(utl::numa_placement::on_node(nodes - 1), 2);
+    check(utl::numa_placement::interleaved(), 3);
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_atomic_reference_count.h"
+#include "utl/memory/utl_intrusive_ptr.h"
+#include "utl/memory/utl_object_pool.h"
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+namespace {
+std::atomic<int> live{0};
+
+struct message : utl::atomic_reference_count<message>, utl::pool_allocated<message> {
+    explicit message(int v) : value(v) { ++live; }
+    ~message() { --live; }
+    int value;
+};
+
+struct alignas(64) aligned_block {
+    char bytes[64];
+};
+} // namespace
+
+int main() {
+    // Blocks released by a thread are handed back to it first
+    void* const first = utl::object_pool<aligned_block>::allocate();
+    assert(reinterpret_cast<uintptr_t>(first) % 64 == 0);
+    utl::object_pool<aligned_block>::deallocate(first);
+    assert(utl::object_pool<aligned_block>::allocate() == first);
+    utl::object_pool<aligned_block>::deallocate(first);
+
+    message* const address = utl::make_intrusive_ptr<message>(0).get();
+    {
+        auto const reused = utl::make_intrusive_ptr<message>(1);
+        assert(reused.get() == address);
+        assert(live == 1);
+    }
+    assert(live == 0);
+
+    // Messages created on one thread and released on others are recycled through the depot
+    utl::intrusive_ptr<message> batch[256];
+    for (int i = 0; i < 256; ++i) {
+        batch[i] = utl::make_intrusive_ptr<message>(i);
+    }
+
+    std::thread consumers[4];
+    for (int t = 0; t < 4; ++t) {
+        consumers[t] = std::thread([&batch, t]() {
+            for (int i = t; i < 256; i += 4) {
+                assert(batch[i]->value == i);
+                batch[i].reset();
+            }
+
+            for (int i = 0; i < 1000; ++i) {
+                auto const temporary = utl::make_intrusive_ptr<message>(i);
+                assert(temporary->value == i);
+            }
+        });
+    }
+
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+    assert(live == 0);
+
+    for (int i = 0; i < 256; ++i) {
+        batch[i] = utl::make_intrusive_ptr<message>(i);
+    }
+    for (auto& ptr : batch) {
+        ptr.reset();
+    }
+
+    utl::object_pool<message>::trim();
+    return 0;
+}
@@ -0,0 +1,57 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_allocator_traits.h"
+#include "utl/memory/utl_page_allocator.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace {
+template <utl::page_policy Policy>
+void run() {
+    using allocator_type = utl::page_allocator<long, Policy>;
+    using traits = utl::allocator_traits<allocator_type>;
+    allocator_type alloc;
+    size_t const granularity = allocator_type::granularity();
+    assert(granularity % 4096 == 0);
+
+    // The capacity is rounded up to whole pages and the memory starts zeroed
+    auto const small = traits::allocate_at_least(alloc, 3);
+    assert(small.size * sizeof(long) == granularity);
+    assert(reinterpret_cast<uintptr_t>(small.ptr) % granularity == 0);
+    for (size_t i = 0; i < small.size; ++i) {
+        assert(small.ptr[i] == 0);
+    }
+    traits::deallocate(alloc, small.ptr, 3);
+
+    // Growing keeps the contents, the pages are moved rather than copied where supported
+    auto block = traits::allocate_at_least(alloc, granularity / sizeof(long));
+    for (size_t i = 0; i < block.size; ++i) {
+        block.ptr[i] = static_cast<long>(i);
+    }
+
+    block = traits::reallocate_at_least(alloc, block, 16 * granularity / sizeof(long));
+    assert(block.size == 16 * granularity / sizeof(long));
+    for (size_t i = 0; i < granularity / sizeof(long); ++i) {
+        assert(block.ptr[i] == static_cast<long>(i));
+    }
+    block.ptr[block.size - 1] = 1;
+
+    // Decommitted pages stay mapped and read back as zeros, partial pages are left alone
+    alloc.decommit(block.ptr + 1, block.size - 1);
+    assert(block.ptr[0] == 0 && block.ptr[1] == 1);
+    assert(block.ptr[block.size - 1] == 0);
+
+    block = traits::reallocate_at_least(alloc, block, 1);
+    assert(block.size * sizeof(long) == granularity);
+    assert(block.ptr[1] == 1);
+    traits::deallocate(alloc, block.ptr, block.size);
+}
+} // namespace
+
+int main() {
+    run<utl::page_policy::standard>();
+    run<utl::page_policy::transparent_huge>();
+    run<utl::page_policy::explicit_huge>();
+    return 0;
+}
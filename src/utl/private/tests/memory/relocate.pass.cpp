@@ -0,0 +1,110 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_relocate.h"
+#include "utl/type_traits/utl_is_trivially_relocatable.h"
+
+#include <cassert>
+#include <new>
+
+namespace {
+int live = 0;
+
+/**
+ * Owns a heap integer and opts into trivial relocation
+ */
+struct owner {
+    explicit owner(int v) : value(new int(v)) { ++live; }
+    owner(owner&& other) noexcept : value(other.value) {
+        other.value = nullptr;
+        ++live;
+    }
+    ~owner() {
+        delete value;
+        --live;
+    }
+
+    int* value;
+};
+
+/**
+ * Stores a pointer to itself, so it must be relocated by its move constructor
+ */
+struct self_referencing {
+    explicit self_referencing(int v) : self(this), value(v) { ++live; }
+    self_referencing(self_referencing&& other) : self(this), value(other.value) {
+        if (value < 0) {
+            throw 0;
+        }
+        ++live;
+    }
+    ~self_referencing() {
+        assert(self == this);
+        --live;
+    }
+
+    self_referencing* self;
+    int value;
+};
+
+template <typename T>
+T* storage(void* buffer) {
+    return static_cast<T*>(buffer);
+}
+} // namespace
+
+UTL_NAMESPACE_BEGIN
+template <>
+struct is_trivially_relocatable<owner> : true_type {};
+UTL_NAMESPACE_END
+
+static_assert(UTL_TRAIT_is_trivially_relocatable(int), "");
+static_assert(UTL_TRAIT_is_trivially_relocatable(int const[4]), "");
+static_assert(UTL_TRAIT_is_trivially_relocatable(owner), "");
+static_assert(UTL_TRAIT_is_trivially_relocatable(owner const), "");
+static_assert(!UTL_TRAIT_is_trivially_relocatable(self_referencing), "");
+
+int main() {
+    alignas(owner) unsigned char raw[8 * sizeof(owner)];
+    owner* const owners = storage<owner>(raw);
+    for (int i = 0; i < 4; ++i) {
+        new (owners + i) owner(i);
+    }
+
+    // Shift right by two to open a gap, then back again
+    assert(utl::uninitialized_relocate_backward(owners, owners + 4, owners + 6) == owners + 2);
+    assert(*owners[5].value == 3);
+    assert(utl::uninitialized_relocate(owners + 2, owners + 6, owners) == owners + 4);
+    assert(*owners[0].value == 0 && *owners[3].value == 3);
+    assert(utl::relocate_at(owners + 3, owners + 7) == owners + 7);
+    assert(*owners[7].value == 3);
+    assert(live == 4);
+    owners[7].~owner();
+    for (int i = 0; i < 3; ++i) {
+        owners[i].~owner();
+    }
+
+    alignas(self_referencing) unsigned char other_raw[8 * sizeof(self_referencing)];
+    self_referencing* const objects = storage<self_referencing>(other_raw);
+    for (int i = 0; i < 4; ++i) {
+        new (objects + i) self_referencing(i);
+    }
+
+    assert(utl::uninitialized_relocate_backward(objects, objects + 4, objects + 6) == objects + 2);
+    assert(utl::uninitialized_relocate(objects + 2, objects + 6, objects) == objects + 4);
+    for (int i = 0; i < 4; ++i) {
+        assert(objects[i].self == objects + i && objects[i].value == i);
+    }
+    assert(live == 4);
+
+    // A throwing move destroys both ranges
+    objects[2].value = -1;
+    bool thrown = false;
+    try {
+        (void)utl::uninitialized_relocate(objects, objects + 4, objects + 4);
+    } catch (int) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(live == 0);
+    return 0;
+}
@@ -0,0 +1,49 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_pointer_traits.h"
+#include "utl/memory/utl_tagged_ptr.h"
+#include "utl/memory/utl_to_address.h"
+
+#include <cassert>
+
+namespace {
+struct alignas(8) node {
+    // Declared while node is still incomplete
+    utl::tagged_ptr<node, 4> next;
+    int value;
+};
+
+using node_ptr = utl::tagged_ptr<node, 4>;
+using wide_ptr = utl::tagged_ptr<node, 16>;
+} // namespace
+
+static_assert(sizeof(node_ptr) == sizeof(node*), "");
+static_assert(node_ptr::max_tag == 15, "");
+static_assert(sizeof(utl::pointer_traits<node_ptr>::element_type) == sizeof(node), "");
+static_assert(sizeof(utl::pointer_traits<node_ptr>::rebind<long>) == sizeof(long*), "");
+
+int main() {
+    node nodes[2] = {};
+    node_ptr ptr(&nodes[1], 13);
+    assert(ptr.get() == &nodes[1]);
+    assert(ptr.tag() == 13);
+    assert(utl::to_address(ptr) == &nodes[1]);
+    ptr->value = 7;
+    assert(nodes[1].value == 7);
+
+    ptr.set_tag(2);
+    assert(ptr.get() == &nodes[1] && ptr.tag() == 2);
+    assert(node_ptr::from_raw(ptr.raw()) == ptr);
+    assert(ptr != node_ptr(&nodes[1], 3));
+    assert(node_ptr::pointer_to(nodes[0]).get() == &nodes[0]);
+
+    // Tags wider than the alignment spill above the address
+    wide_ptr wide(&nodes[0], 0xbeef);
+    assert(wide.get() == &nodes[0] && wide.tag() == 0xbeef);
+    wide.reset(nullptr, wide_ptr::max_tag);
+    assert(!wide && wide.tag() == wide_ptr::max_tag);
+
+    node_ptr null;
+    assert(!null && null.tag() == 0 && null == nullptr);
+    return 0;
+}
@@ -0,0 +1,76 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_allocator.h"
+
+#include <cassert>
+#include <cstring>
+#include <thread>
+
+namespace {
+void* allocate(size_t size) {
+    return utl::memory::details::allocate(size);
+}
+
+void deallocate(void* ptr, size_t size) {
+    utl::memory::details::deallocate(ptr, size);
+}
+} // namespace
+
+int main() {
+    // Every size up to the largest class is served with the default alignment and reused LIFO
+    for (size_t size = 0; size <= 8192 + 64; size += 7) {
+        void* const block = allocate(size);
+        assert(reinterpret_cast<uintptr_t>(block) % 16 == 0);
+        std::memset(block, 0xa5, size);
+        deallocate(block, size);
+        if (size <= 8192) {
+            assert(allocate(size) == block);
+            deallocate(block, size);
+        }
+    }
+
+    {
+        utl::allocator<double> alloc;
+        double* const values = alloc.allocate(100);
+        for (int i = 0; i < 100; ++i) {
+            values[i] = i;
+        }
+        alloc.deallocate(values, 100);
+    }
+
+    // Blocks allocated on one thread and released on others travel through the central lists
+    constexpr int count = 4096;
+    static void* blocks[count];
+    for (int i = 0; i < count; ++i) {
+        blocks[i] = allocate(48);
+        std::memset(blocks[i], i & 0xff, 48);
+    }
+
+    std::thread workers[4];
+    for (int t = 0; t < 4; ++t) {
+        workers[t] = std::thread([t]() {
+            for (int i = t; i < count; i += 4) {
+                assert(*static_cast<unsigned char*>(blocks[i]) == (i & 0xff));
+                deallocate(blocks[i], 48);
+            }
+
+            void* local[256];
+            for (int round = 0; round < 100; ++round) {
+                for (auto& block : local) {
+                    block = allocate(48);
+                    std::memset(block, t, 48);
+                }
+                for (auto& block : local) {
+                    assert(*static_cast<unsigned char*>(block) == t);
+                    deallocate(block, 48);
+                }
+            }
+        });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_allocator_traits.h"
+#include "utl/memory/utl_tracking_allocator.h"
+
+#include <cassert>
+#include <string.h>
+
+int main() {
+    utl::memory::allocation_tracker tracker(1);
+    using allocator_type = utl::tracking_allocator<utl::allocator<int>>;
+    using traits = utl::allocator_traits<allocator_type>;
+    allocator_type alloc(tracker);
+    unsigned int const line = __LINE__ - 1;
+
+    int* const small = traits::allocate(alloc, 4);
+    auto block = traits::allocate_at_least(alloc, 1000);
+    assert(block.size >= 1000);
+    block = traits::reallocate_at_least(alloc, block, 2000);
+    assert(block.size >= 2000);
+
+    auto stats = tracker.statistics();
+    assert(stats.allocations == 3);
+    assert(stats.deallocations == 1);
+    assert(stats.size_histogram[4] == 1);
+    assert(stats.live_bytes() == (4 + block.size) * sizeof(int));
+
+    traits::deallocate(alloc, small, 4);
+    traits::deallocate(alloc, block.ptr, block.size);
+    stats = tracker.statistics();
+    assert(stats.live_allocations() == 0);
+    assert(stats.live_bytes() == 0);
+
+    // Every allocation is sampled with a period of 1, attributed to where the allocator was made
+    utl::memory::allocation_sample samples[utl::memory::allocation_tracker::sample_capacity];
+    assert(tracker.samples(samples, utl::memory::allocation_tracker::sample_capacity) == 3);
+    assert(samples[0].bytes == 4 * sizeof(int));
+    assert(strcmp(samples[0].file_name, __FILE__) == 0);
+    assert(samples[0].line == line);
+
+    // Rebound copies record into the same tracker and wrap an equal allocator
+    utl::tracking_allocator<utl::allocator<long>> rebound(alloc);
+    assert(rebound.base() == alloc.base());
+    assert(rebound == alloc);
+    assert(&rebound.tracker() == &tracker);
+    assert(allocator_type() != alloc);
+
+    // Default-constructed adaptors stay out of the tracker fed by the allocation hooks
+    allocator_type const fallback;
+    assert(&fallback.tracker() == &utl::memory::allocation_tracker::adaptors());
+    assert(&fallback.tracker() != &utl::memory::allocation_tracker::global());
+    traits::deallocate(alloc, traits::allocate(alloc, 1), 1);
+    assert(tracker.statistics().allocations == 4);
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/memory/utl_destroy.h"
+#include "utl/memory/utl_uninitialized_algorithms.h"
+
+#include <cassert>
+
+namespace {
+int live = 0;
+
+struct counted {
+    counted() : value(-1) { ++live; }
+    counted(int v) : value(v) { ++live; }
+    counted(counted const& other) : value(other.value) {
+        if (value == 3) {
+            throw 0;
+        }
+        ++live;
+    }
+    counted(counted&& other) noexcept : value(other.value) {
+        other.value = 0;
+        ++live;
+    }
+    ~counted() { --live; }
+
+    int value;
+};
+
+struct node {
+    int* next;
+    long key;
+};
+
+template <typename T>
+T* storage(void* buffer) {
+    return static_cast<T*>(buffer);
+}
+} // namespace
+
+int main() {
+    int const source[5] = {1, 2, 3, 4, 5};
+    int ints[5];
+    assert(utl::uninitialized_copy(source, source + 5, ints) == ints + 5);
+    assert(ints[0] == 1 && ints[4] == 5);
+    assert(utl::uninitialized_copy_n(source, 0, ints) == ints);
+    auto const moved = utl::uninitialized_move_n(source + 1, 3, ints);
+    assert(moved.first == source + 4 && moved.second == ints + 3 && ints[2] == 4);
+
+    unsigned char bytes[16];
+    assert(utl::uninitialized_fill_n(bytes, 16, (unsigned char)0xab) == bytes + 16);
+    assert(bytes[0] == 0xab && bytes[15] == 0xab);
+
+    long longs[4] = {1, 2, 3, 4};
+    utl::uninitialized_value_construct(longs, longs + 4);
+    assert(longs[0] == 0 && longs[3] == 0);
+    int* pointers[2] = {ints, ints};
+    assert(utl::uninitialized_value_construct_n(pointers, 2) == pointers + 2);
+    assert(pointers[0] == nullptr && pointers[1] == nullptr);
+    node nodes[2] = {{ints, 7}, {ints, 8}};
+    utl::uninitialized_value_construct(nodes, nodes + 2);
+    assert(nodes[0].next == nullptr && nodes[1].key == 0);
+    assert(utl::uninitialized_default_construct_n(longs, 4) == longs + 4);
+
+    alignas(counted) unsigned char raw[8 * sizeof(counted)];
+    counted* const objects = storage<counted>(raw);
+    utl::uninitialized_fill(objects, objects + 4, counted(2));
+    assert(live == 4 && objects[3].value == 2);
+    assert(utl::uninitialized_move(objects, objects + 4, objects + 4) == objects + 8);
+    assert(live == 8 && objects[0].value == 0 && objects[7].value == 2);
+    assert(utl::destroy_n(objects, 8) == objects + 8);
+    assert(live == 0);
+
+    utl::uninitialized_value_construct(objects, objects + 2);
+    assert(objects[1].value == -1);
+    utl::destroy(objects, objects + 2);
+
+    // A throwing copy destroys the objects already constructed
+    counted values[4] = {0, 1, 2, 3};
+    bool thrown = false;
+    try {
+        (void)utl::uninitialized_copy(values, values + 4, objects);
+    } catch (int) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(live == 4);
+    return 0;
+}
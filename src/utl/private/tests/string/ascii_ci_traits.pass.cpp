@@ -0,0 +1,49 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/string/utl_ascii_ci_traits.h"
+
+#include <cassert>
+
+int main() {
+    using traits = utl::ascii_ci_traits<char>;
+    static_assert(traits::compare("Content-Type", "content-type", 12) == 0, "");
+    static_assert(traits::eq('A', 'a') && !traits::eq('@', '`'), "");
+    static_assert(traits::lt('a', 'B'), "");
+
+    utl::ci_string_view const name("Transfer-Encoding");
+    assert(name == utl::ci_string_view("TRANSFER-ENCODING"));
+    assert(name != utl::ci_string_view("Transfer-Encodinh"));
+    assert(name.find("encoding") == 9);
+    assert(name.find('E') == 6);
+    assert(name.starts_with("transfer"));
+    assert(utl::ci_string_view("ACCEPT") < utl::ci_string_view("accept-encoding"));
+
+    // Long enough for the vectorized kernels, the mismatch sits past the first vector
+    char const lower[] = "x-forwarded-for-and-a-much-longer-header-name-suffix";
+    char upper[sizeof(lower)];
+    for (size_t i = 0; i < sizeof(lower); ++i) {
+        char const c = lower[i];
+        upper[i] = c >= 'a' && c <= 'z' ? char(c - ('a' - 'A')) : c;
+    }
+
+    assert(traits::compare(lower, upper, sizeof(lower) - 1) == 0);
+    upper[40] = '~';
+    assert(traits::compare(lower, upper, sizeof(lower) - 1) < 0);
+    assert(traits::find(lower, sizeof(lower) - 1, 'X') == lower);
+    assert(traits::find(lower, sizeof(lower) - 1, 'F') == lower + 2);
+    assert(traits::find(lower, sizeof(lower) - 1, 'Z') == nullptr);
+
+    // Only ASCII letters fold
+    assert(traits::compare("\xc9", "\xe9", 1) != 0);
+    assert(traits::compare("[", "{", 1) != 0);
+
+    utl::ascii_ci_hash<char> const hasher;
+    assert(hasher(name) == hasher(utl::string_view("transfer-encoding")));
+    assert(hasher(name) != hasher(utl::string_view("transfer-encodinh")));
+    assert((utl::hash<utl::ci_string_view>{}(name) == hasher(name)));
+
+    utl::ci_string const owned("Keep-Alive");
+    assert(utl::ci_string_view(owned.data(), owned.size()) == utl::ci_string_view("keep-alive"));
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/string/utl_cord.h"
+
+#include <cassert>
+
+namespace {
+
+bool flattens_to(utl::cord const& c, utl::string_view expected) {
+    utl::string_view::size_type offset = 0;
+    for (auto const chunk : c.chunks()) {
+        if (expected.substr(offset, chunk.size()) != chunk) {
+            return false;
+        }
+        offset += chunk.size();
+    }
+
+    return offset == expected.size() && c == expected;
+}
+
+} // namespace
+
+int main() {
+    static constexpr char text[] =
+        "The quick brown fox jumps over the lazy dog. Pack my box with five dozen liquor jugs.";
+    static constexpr utl::string_view::size_type length = sizeof(text) - 1;
+
+    // Large leaves are shared by substrings rather than copied
+    utl::cord body;
+    for (int i = 0; i < 64; ++i) {
+        body.append(utl::string_view(text, length));
+    }
+    assert(body.size() == 64 * length);
+
+    auto const middle = body.substr(10 * length, 20 * length);
+    assert(middle.size() == 20 * length);
+    assert(middle[0] == text[0]);
+
+    utl::cord spliced = body;
+    spliced.insert(length, "<inserted>");
+    spliced.erase(0, length);
+    assert(spliced.substr(0, 10) == utl::string_view("<inserted>"));
+    spliced.replace(0, 10, middle);
+    assert(spliced.size() == 83 * length);
+    assert(body.size() == 64 * length);
+
+    utl::cord small("ab");
+    small.append("cd");
+    small.prepend("__");
+    assert(flattens_to(small, "__abcd"));
+    small.replace(2, 2, utl::cord("XY"));
+    assert(flattens_to(small, "__XYcd"));
+    assert(small.compare(utl::string_view("__XYce")) < 0);
+    assert(flattens_to(utl::cord("left") + utl::cord("right"), "leftright"));
+
+    char buffer[4] = {};
+    assert(small.copy(buffer, 4, 1) == 4);
+    assert(utl::string_view(buffer, 4) == utl::string_view("_XYc"));
+
+    // Deep trees built from many appends are rebalanced
+    utl::cord deep;
+    for (int i = 0; i < 100000; ++i) {
+        deep.append(middle.substr(0, 600));
+    }
+    assert(deep.size() == 600 * 100000);
+    assert(deep.substr(600 * 998, 600) == middle.substr(0, 600));
+    return 0;
+}
@@ -0,0 +1,163 @@
+// Copyright 2023-2024 Bryan Wong
+
+// Checks the head and tail masking of the vectorized kernels behind the runtime strlen, strchr,
+// strnchr and find against the scalar compile time implementations
+
+#include "utl/string/utl_libc.h"
+
+#include <cassert>
+#include <stddef.h>
+
+#if UTL_TARGET_UNIX
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace {
+namespace runtime = utl::libc::runtime;
+namespace scalar = utl::libc::compile_time;
+using utl::libc::element_count_t;
+
+/**
+ * Wide enough to cover every offset within the largest vector any kernel loads
+ */
+constexpr size_t vector_bytes = 64;
+
+template <typename T>
+constexpr T filler = T('a');
+template <typename T>
+constexpr T target = T('x');
+
+template <typename T>
+void check_string(T const* str, size_t length) {
+    auto const count = element_count_t(length);
+    assert(runtime::strlen(str) == length);
+    assert(runtime::strlen(str) == scalar::strlen(str));
+    assert(runtime::strchr(str, T()) == str + length);
+    assert(runtime::strchr(str, target<T>) == scalar::strchr(str, target<T>));
+    assert(runtime::strnchr(str, target<T>, count) == scalar::strnchr(str, target<T>, count));
+    assert(runtime::find(str, target<T>, count) == scalar::find(str, target<T>, count));
+    // One past the length reaches the terminator, which stops strnchr but not find
+    auto const terminated = element_count_t(length + 1);
+    assert(runtime::strnchr(str, T(), terminated) == str + length);
+    assert(runtime::find(str, T(), terminated) == str + length);
+}
+
+template <typename T>
+void check_match(T const* str, size_t length, size_t position) {
+    T* const expected = const_cast<T*>(str + position);
+    assert(runtime::strchr(str, target<T>) == expected);
+    assert(runtime::strchr(str, target<T>) == scalar::strchr(str, target<T>));
+    for (size_t count = position; count <= position + 1 && count <= length; ++count) {
+        auto const limit = element_count_t(count);
+        assert(runtime::strnchr(str, target<T>, limit) == scalar::strnchr(str, target<T>, limit));
+        assert(runtime::find(str, target<T>, limit) == scalar::find(str, target<T>, limit));
+        assert(runtime::find(str, target<T>, limit) == (count > position ? expected : nullptr));
+    }
+}
+
+template <typename T>
+void check_offsets() {
+    constexpr size_t width = vector_bytes / sizeof(T);
+    constexpr size_t max_length = 2 * width;
+    alignas(vector_bytes) T buffer[width + max_length + width];
+
+    for (size_t offset = 0; offset < width; ++offset) {
+        T* const str = buffer + offset;
+        for (size_t length = 0; length <= max_length; ++length) {
+            // Fill past the terminator too so that a missed terminator is noticed
+            for (auto& c : buffer) {
+                c = filler<T>;
+            }
+            str[length] = T();
+            check_string(str, length);
+
+            for (size_t position = 0; position < length; ++position) {
+                str[position] = target<T>;
+                check_match(str, length, position);
+                str[position] = filler<T>;
+            }
+
+            if (length) {
+                // An embedded NUL ends strnchr but find must search past it
+                str[0] = T();
+                str[length - 1] = target<T>;
+                auto const count = element_count_t(length);
+                assert(runtime::find(str, target<T>, count) == str + length - 1);
+                assert(runtime::find(str, target<T>, count) == scalar::find(str, target<T>, count));
+                assert(runtime::strnchr(str, target<T>, count) ==
+                    scalar::strnchr(str, target<T>, count));
+            }
+        }
+    }
+}
+
+#if UTL_TARGET_UNIX
+/**
+ * Places every string so that it ends on the last element of a page followed by an inaccessible
+ * page; a kernel whose tail loads cross into the next page faults
+ */
+template <typename T>
+void check_page_boundary(unsigned char* page_end) {
+    constexpr size_t max_length = 2 * vector_bytes / sizeof(T);
+    T* const end = reinterpret_cast<T*>(page_end);
+
+    for (size_t length = 0; length <= max_length; ++length) {
+        T* const str = end - (length + 1);
+        for (size_t idx = 0; idx < length; ++idx) {
+            str[idx] = filler<T>;
+        }
+
+        // Terminator in the last element
+        str[length] = T();
+        check_string(str, length);
+        auto const count = element_count_t(length + 1);
+        assert(runtime::find(str, target<T>, count) == nullptr);
+
+        // Match in the last element with no terminator before the boundary
+        str[length] = target<T>;
+        assert(runtime::strchr(str, target<T>) == str + length);
+        assert(runtime::strnchr(str, target<T>, count) == str + length);
+        assert(runtime::find(str, target<T>, count) == str + length);
+
+        // Neither a match nor a terminator before the boundary
+        str[length] = filler<T>;
+        assert(runtime::strnchr(str, target<T>, count) == nullptr);
+        assert(runtime::find(str, target<T>, count) == nullptr);
+    }
+}
+
+template <typename T>
+void check_page_boundary() {
+    auto const page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    void* const mapping =
+        ::mmap(nullptr, 2 * page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    assert(mapping != MAP_FAILED);
+    auto const pages = static_cast<unsigned char*>(mapping);
+    int const protect_result = ::mprotect(pages + page_size, page_size, PROT_NONE);
+    assert(protect_result == 0);
+
+    check_page_boundary<T>(pages + page_size);
+
+    int const unmap_result = ::munmap(mapping, 2 * page_size);
+    assert(unmap_result == 0);
+}
+#endif
+
+template <typename T>
+void check() {
+    check_offsets<T>();
+#if UTL_TARGET_UNIX
+    check_page_boundary<T>();
+#endif
+}
+} // namespace
+
+int main() {
+#if UTL_SUPPORTS_CHAR8_T
+    check<char8_t>();
+#endif
+    check<char16_t>();
+    check<char32_t>();
+    return 0;
+}
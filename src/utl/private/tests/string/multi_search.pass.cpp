@@ -0,0 +1,56 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/string/utl_multi_search.h"
+
+#include <cassert>
+
+namespace {
+struct recorder {
+    void operator()(utl::multi_search::match m) {
+        assert(count < 16);
+        matches[count++] = m;
+    }
+
+    utl::multi_search::match matches[16];
+    size_t count = 0;
+};
+} // namespace
+
+int main() {
+    utl::string_view const patterns[] = {"he", "she", "his", "hers", ""};
+    utl::multi_search const matcher(patterns);
+    assert(matcher.has_prefilter());
+    assert(!matcher.contains_any("nothing to see"));
+    assert(matcher.contains_any("ushers"));
+
+    // Overlapping matches are reported in order of their end position
+    recorder found;
+    matcher.find_all("ushers", found);
+    assert(found.count == 3);
+    assert(found.matches[0].pattern == 1 && found.matches[0].position == 1);
+    assert(found.matches[1].pattern == 0 && found.matches[1].position == 2);
+    assert(found.matches[2].pattern == 3 && found.matches[2].position == 2);
+
+    // Matches spanning chunks are reported with positions relative to the stream
+    recorder streamed;
+    utl::multi_search::scanner scanner(matcher);
+    scanner.feed("a long line of text that ends with us", streamed);
+    scanner.feed("he", streamed);
+    scanner.feed("rs and his", streamed);
+    assert(scanner.offset() == 49);
+    assert(streamed.count == 4);
+    assert(streamed.matches[0].pattern == 1 && streamed.matches[0].position == 36);
+    assert(streamed.matches[1].pattern == 0 && streamed.matches[1].position == 37);
+    assert(streamed.matches[2].pattern == 3 && streamed.matches[2].position == 37);
+    assert(streamed.matches[3].pattern == 2 && streamed.matches[3].position == 46);
+
+    // Wide strings are scanned without the prefilter
+    utl::u16string_view const wide[] = {u"ab", u"b"};
+    utl::u16multi_search const wide_matcher(wide);
+    assert(!wide_matcher.has_prefilter());
+    size_t wide_count = 0;
+    wide_matcher.find_all(u"xabab", [&](utl::u16multi_search::match) { ++wide_count; });
+    assert(wide_count == 4);
+
+    return 0;
+}
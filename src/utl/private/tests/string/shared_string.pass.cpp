@@ -0,0 +1,33 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/string/utl_shared_string.h"
+
+#include <cassert>
+
+int main() {
+    utl::shared_string const empty;
+    assert(empty.empty() && empty.c_str()[0] == '\0');
+
+    utl::shared_string const small("key");
+    assert(!small.is_shared());
+    assert(small == utl::string_view("key"));
+
+    static constexpr char payload[] = "a payload long enough to be stored in a shared heap block";
+    utl::shared_string const large(payload);
+    assert(large.is_shared());
+
+    // Copies share the heap block
+    utl::shared_string copy = large;
+    assert(copy.data() == large.data());
+    assert(copy == large);
+    assert(copy.zview().data()[copy.size()] == '\0');
+
+    utl::shared_string moved = static_cast<utl::shared_string&&>(copy);
+    assert(copy.empty());
+    assert(moved.data() == large.data());
+
+    moved = small;
+    assert(moved == small && moved.data() != small.data());
+    assert(large.view() == utl::string_view(payload));
+    return 0;
+}
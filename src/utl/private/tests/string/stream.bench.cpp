@@ -0,0 +1,77 @@
+// Copyright 2023-2024 Bryan Wong
+
+// Compares the streaming memcpy/memset against the C library from 64B to 1GiB
+
+#include "utl/string/utl_libc.h"
+#include "utl/tempus/utl_clock.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef UTL_BENCHMARK_MAX_BYTES
+#  define UTL_BENCHMARK_MAX_BYTES (size_t(1) << 30)
+#endif
+
+namespace {
+/**
+ * Bytes moved per variant and size, bounds the iteration count of small sizes
+ */
+constexpr size_t bytes_per_run = size_t(1) << 28;
+
+double seconds(utl::tempus::duration d) {
+    return d.seconds() + d.nanoseconds() * 1e-9;
+}
+
+template <typename F>
+double gigabytes_per_second(size_t size, F&& op) {
+    size_t const iterations = size < bytes_per_run ? bytes_per_run / size : 1;
+    // Warm up, faulting in the pages
+    op();
+    auto const begin = get_time(utl::tempus::steady_clock);
+    for (size_t idx = 0; idx < iterations; ++idx) {
+        op();
+    }
+    auto const elapsed = seconds(get_time(utl::tempus::steady_clock) - begin);
+    return (double(size) * iterations) / elapsed * 1e-9;
+}
+} // namespace
+
+int main() {
+    namespace libc = utl::libc;
+    auto const src = static_cast<unsigned char*>(::malloc(UTL_BENCHMARK_MAX_BYTES));
+    auto const dst = static_cast<unsigned char*>(::malloc(UTL_BENCHMARK_MAX_BYTES));
+    if (src == nullptr || dst == nullptr) {
+        ::fprintf(stderr, "failed to allocate %zu bytes\n", size_t(UTL_BENCHMARK_MAX_BYTES));
+        return 1;
+    }
+
+    ::memset(src, 0x5a, UTL_BENCHMARK_MAX_BYTES);
+
+    ::printf("stream threshold: %zu bytes\n", libc::runtime::stream::threshold());
+    ::printf("%12s %10s %10s %10s %10s (GB/s)\n", "bytes", "memcpy", "stream", "memset", "stream");
+    for (size_t size = 64; size <= UTL_BENCHMARK_MAX_BYTES; size *= 2) {
+        auto const count = libc::element_count_t(size);
+        auto const copy = gigabytes_per_second(size, [&]() { ::memcpy(dst, src, size); });
+        auto const copy_stream =
+            gigabytes_per_second(size, [&]() { libc::memcpy_stream(dst, src, count); });
+        if (::memcmp(dst, src, size) != 0) {
+            ::fprintf(stderr, "memcpy_stream mismatch at %zu bytes\n", size);
+            return 1;
+        }
+
+        auto const fill = gigabytes_per_second(size, [&]() { ::memset(dst, 0, size); });
+        auto const fill_stream = gigabytes_per_second(
+            size, [&]() { libc::memset_stream(dst, static_cast<unsigned char>(1), count); });
+        if (dst[0] != 1 || dst[size - 1] != 1) {
+            ::fprintf(stderr, "memset_stream mismatch at %zu bytes\n", size);
+            return 1;
+        }
+
+        ::printf("%12zu %10.2f %10.2f %10.2f %10.2f\n", size, copy, copy_stream, fill, fill_stream);
+    }
+
+    ::free(dst);
+    ::free(src);
+    return 0;
+}
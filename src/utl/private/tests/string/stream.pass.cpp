@@ -0,0 +1,132 @@
+// Copyright 2023-2024 Bryan Wong
+
+// Checks memcpy_stream/memset_stream on either side of the streaming threshold, with every
+// alignment of the destination so that the unaligned head and the partial tail are exercised
+
+#include "utl/string/utl_libc.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+namespace libc = utl::libc;
+
+constexpr size_t line_size = 64;
+/**
+ * Bytes on either side of the destination that must be left untouched
+ */
+constexpr size_t guard_size = line_size;
+constexpr unsigned char guard_value = 0xee;
+constexpr unsigned char fill_value = 0x3c;
+
+struct buffers {
+    unsigned char* src;
+    unsigned char* dst;
+    size_t capacity;
+};
+
+buffers allocate(size_t max_size) {
+    // Room for every offset within a line plus the guards, rounded up for aligned_alloc
+    size_t const capacity =
+        (max_size + 2 * line_size + 2 * guard_size + line_size - 1) & ~(line_size - 1);
+    buffers result{static_cast<unsigned char*>(::aligned_alloc(line_size, capacity)),
+        static_cast<unsigned char*>(::aligned_alloc(line_size, capacity)), capacity};
+    assert(result.src != nullptr && result.dst != nullptr);
+    for (size_t idx = 0; idx < capacity; ++idx) {
+        // A period prime to the line size so that a misplaced line is noticed
+        result.src[idx] = static_cast<unsigned char>(idx % 251);
+    }
+
+    return result;
+}
+
+void release(buffers const& b) {
+    ::free(b.src);
+    ::free(b.dst);
+}
+
+bool untouched(unsigned char const* ptr, size_t size) {
+    for (size_t idx = 0; idx < size; ++idx) {
+        if (ptr[idx] != guard_value) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool filled(unsigned char const* ptr, size_t size) {
+    for (size_t idx = 0; idx < size; ++idx) {
+        if (ptr[idx] != fill_value) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void check_copy(buffers const& b, size_t offset, size_t size) {
+    ::memset(b.dst, guard_value, b.capacity);
+    unsigned char* const dst = b.dst + guard_size + offset;
+    // Misalign the source differently from the destination
+    unsigned char const* const src = b.src + guard_size + (offset * 5 + 3) % line_size;
+    auto const result = libc::memcpy_stream(dst, src, libc::element_count_t(size));
+    assert(result == dst);
+    assert(::memcmp(dst, src, size) == 0);
+    assert(untouched(b.dst, guard_size + offset));
+    assert(untouched(dst + size, b.capacity - (guard_size + offset + size)));
+}
+
+void check_fill(buffers const& b, size_t offset, size_t size) {
+    ::memset(b.dst, guard_value, b.capacity);
+    unsigned char* const dst = b.dst + guard_size + offset;
+    auto const result = libc::memset_stream(dst, fill_value, libc::element_count_t(size));
+    assert(result == dst);
+    assert(filled(dst, size));
+    assert(untouched(b.dst, guard_size + offset));
+    assert(untouched(dst + size, b.capacity - (guard_size + offset + size)));
+}
+
+void check(buffers const& b, size_t offset, size_t size) {
+    check_copy(b, offset, size);
+    check_fill(b, offset, size);
+}
+} // namespace
+
+int main() {
+    auto const threshold = libc::runtime::stream::threshold();
+    // At least two lines so that the head always fits below it
+    assert(threshold >= 2 * line_size);
+    assert(libc::runtime::stream::threshold() == threshold);
+
+    {
+        // Every size up to a few lines, well below the threshold unless it is overridden
+        auto const b = allocate(4 * line_size);
+        for (size_t offset = 0; offset < line_size; ++offset) {
+            for (size_t size = 0; size <= 4 * line_size; ++size) {
+                check(b, offset, size);
+            }
+        }
+
+        release(b);
+    }
+
+    {
+        // Sizes straddling the threshold, with a tail of no, some and almost a full line
+        size_t const sizes[] = {threshold - 1, threshold, threshold + 1, threshold + line_size - 1,
+            threshold + line_size, threshold + line_size + 1};
+        // Aligned, and heads of one, half and all but one byte of a line
+        size_t const offsets[] = {0, 1, line_size / 2, line_size - 1};
+        auto const b = allocate(threshold + line_size + 1);
+        for (auto const size : sizes) {
+            for (auto const offset : offsets) {
+                check(b, offset, size);
+            }
+        }
+
+        release(b);
+    }
+
+    return 0;
+}
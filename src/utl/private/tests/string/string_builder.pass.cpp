@@ -0,0 +1,43 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/string/utl_string_builder.h"
+
+#include <cassert>
+
+int main() {
+    utl::string_builder builder;
+    builder.append("status=").append(200).append(' ').append(-42).append(3, '.');
+    builder.append_format("[%s:%d]", "key", 7);
+    assert(builder.str() == "status=200 -42...[key:7]");
+
+    // Appends spanning several chunks are copied out in order
+    builder.clear();
+    for (int i = 0; i < 10000; ++i) {
+        builder.append("0123456789");
+    }
+    assert(builder.size() == 100000);
+    assert(builder.chunk_count() > 1);
+
+    utl::string result;
+    builder.finalize(result);
+    assert(result.size() == 100000);
+    for (utl::string::size_type i = 0; i < result.size(); ++i) {
+        assert(result[i] == static_cast<char>('0' + i % 10));
+    }
+
+#if UTL_TARGET_UNIX
+    ::iovec vectors[64];
+    auto const count = builder.to_iovec(vectors, 64);
+    assert(count == builder.chunk_count());
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += vectors[i].iov_len;
+    }
+    assert(total == builder.size());
+#endif
+
+    utl::u16string_builder wide;
+    wide.append(u"id=").append(12345u);
+    assert(wide.str() == u"id=12345");
+    return 0;
+}
@@ -0,0 +1,68 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/string/utl_string_pool.h"
+
+#include <cassert>
+#include <pthread.h>
+#include <stdio.h>
+
+namespace {
+
+constexpr int key_count = 10000;
+constexpr int thread_count = 8;
+
+utl::string_pool pool;
+char keys[key_count][16];
+utl::interned_string handles[thread_count][key_count];
+
+void* intern_all(void* arg) {
+    auto const index = *static_cast<int*>(arg);
+    for (int i = 0; i < key_count; ++i) {
+        handles[index][i] = pool.intern(keys[i]);
+    }
+
+    return nullptr;
+}
+
+} // namespace
+
+int main() {
+    utl::string_pool local;
+    auto const hello = local.intern("hello");
+    char buffer[] = "hello";
+    assert(local.intern(buffer) == hello);
+    assert(hello.c_str() != buffer);
+    assert(hello.size() == 5 && hello.view() == utl::string_view("hello"));
+    assert(local.find("hello") == hello);
+    assert(!local.find("world"));
+    assert(local.intern("") == utl::interned_string());
+    assert(local.size() == 1);
+    assert(utl::hash<utl::interned_string>()(hello) == hello.hash());
+
+    for (int i = 0; i < key_count; ++i) {
+        snprintf(keys[i], sizeof(keys[i]), "key-%d", i);
+    }
+
+    int indices[thread_count];
+    pthread_t threads[thread_count];
+    for (int t = 0; t < thread_count; ++t) {
+        indices[t] = t;
+        pthread_create(&threads[t], nullptr, &intern_all, &indices[t]);
+    }
+
+    for (int t = 0; t < thread_count; ++t) {
+        pthread_join(threads[t], nullptr);
+    }
+
+    assert(pool.size() == key_count);
+    for (int i = 0; i < key_count; ++i) {
+        for (int t = 1; t < thread_count; ++t) {
+            assert(handles[t][i] == handles[0][i]);
+        }
+
+        assert(handles[0][i].view() == utl::string_view(keys[i]));
+        assert(pool.find(keys[i]) == handles[0][i]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/string/utl_unicode.h"
+
+#include <cassert>
+
+namespace unicode = utl::unicode;
+
+int main() {
+    // U+0041, U+00E9, U+20AC, U+1F600
+    static constexpr char utf8[] = "A\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80";
+    static constexpr char16_t utf16[] = u"Aé€\U0001F600";
+    static constexpr char32_t utf32[] = U"Aé€\U0001F600";
+
+    assert(unicode::validate(utf8, sizeof(utf8) - 1));
+    assert(unicode::transcoded_length<char16_t>(utf8, sizeof(utf8) - 1) == 5);
+    assert(unicode::transcoded_length<char>(utf32, 4) == sizeof(utf8) - 1);
+
+    utl::u16string wide;
+    assert(unicode::transcode(utl::string_view(utf8), wide));
+    assert(wide == utf16);
+
+    utl::u32string wider;
+    assert(unicode::transcode(utl::u16string_view(utf16), wider));
+    assert(wider == utf32);
+
+    utl::string narrow;
+    assert(unicode::transcode(utl::u32string_view(utf32), narrow));
+    assert(narrow == utf8);
+
+    assert(unicode::is_ascii("plain ascii text that spans more than one block", 47));
+    assert(!unicode::is_ascii(utf8, sizeof(utf8) - 1));
+
+    // Overlong, surrogate, out of range and truncated sequences
+    assert(unicode::validate("\xc0\xaf", 2).error == unicode::conversion_error::overlong);
+    assert(unicode::validate("ab\xed\xa0\x80", 5).error == unicode::conversion_error::surrogate);
+    assert(unicode::validate("ab\xed\xa0\x80", 5).count == 2);
+    assert(unicode::validate("\xf4\x90\x80\x80", 4).error == unicode::conversion_error::out_of_range);
+    assert(unicode::validate("\xe2\x82", 2).error == unicode::conversion_error::truncated);
+    assert(unicode::validate("\x80", 1).error == unicode::conversion_error::invalid_sequence);
+
+    static constexpr char16_t lone[] = {u'a', char16_t(0xdc00)};
+    assert(unicode::validate(lone, 2).error == unicode::conversion_error::surrogate);
+    assert(!unicode::transcode(utl::u16string_view(lone, 2), narrow));
+    assert(narrow.empty());
+    return 0;
+}
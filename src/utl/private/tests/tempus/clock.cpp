@@ -0,0 +1,10 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/tempus/utl_clock.h"
+#include "utl/tempus/utl_coarse_clock.h"
+
+static_assert(utl::tempus::is_clock<utl::tempus::steady_clock_t>::value, "Invalid implementation");
+
+#if UTL_TARGET_UNIX
+static_assert(utl::tempus::is_clock<utl::tempus::coarse_clock_t>::value, "Invalid implementation");
+#endif
@@ -0,0 +1,122 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/tempus/utl_coarse_clock.h"
+
+#include <cassert>
+
+#if UTL_TARGET_UNIX
+
+#  include <stdint.h>
+#  include <time.h>
+
+static_assert(utl::tempus::is_clock<utl::tempus::coarse_clock_t>::value, "Invalid implementation");
+
+namespace {
+
+constexpr int64_t ms = 1000000;
+/**
+ * Allowance for the ticker thread being descheduled on a loaded machine
+ */
+constexpr int64_t lag_ns = 200 * ms;
+
+/**
+ * The clock the fallback reads, which is also the clock the ticker publishes
+ */
+int64_t os_now() {
+    ::timespec ts;
+#  if UTL_TARGET_LINUX && defined(CLOCK_MONOTONIC_COARSE)
+    ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#  else
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+#  endif
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+int64_t coarse_now() {
+    return get_time(utl::tempus::coarse_clock).value();
+}
+
+void sleep_for(int64_t ns) {
+    ::timespec const ts = {static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+    ::nanosleep(&ts, nullptr);
+}
+
+/**
+ * Latest reading, the clock never goes backwards across starting and stopping the ticker
+ */
+int64_t previous = 0;
+
+/**
+ * Without the ticker every reading comes straight from the OS clock, so it lies between the
+ * readings taken around it
+ */
+void check_fallback() {
+    // Lets the OS clock move past anything the ticker may have left behind
+    sleep_for(20 * ms);
+    for (int i = 0; i < 1000; ++i) {
+        int64_t const before = os_now();
+        int64_t const current = coarse_now();
+        int64_t const after = os_now();
+        assert(current >= before && current <= after);
+        assert(current >= previous);
+        previous = current;
+    }
+}
+
+/**
+ * With the ticker running readings are published values, which trail the OS clock by at most a
+ * few ticks and advance as the ticker publishes
+ */
+void check_ticker() {
+    int64_t const start = coarse_now();
+    int64_t const os_start = os_now();
+    assert(start >= previous);
+    previous = start;
+    while (os_now() - os_start < 100 * ms) {
+        int64_t const before = os_now();
+        int64_t const current = coarse_now();
+        int64_t const after = os_now();
+        assert(current <= after);
+        assert(current >= before - lag_ns);
+        assert(current >= previous);
+        previous = current;
+        sleep_for(ms / 2);
+    }
+
+    assert(previous > start);
+}
+
+} // namespace
+
+int main() {
+    using utl::tempus::coarse_clock_t;
+    check_fallback();
+
+    bool const started = coarse_clock_t::start();
+    assert(started);
+    // Starting a running ticker does nothing
+    bool const started_again = coarse_clock_t::start();
+    assert(started_again);
+    check_ticker();
+
+    coarse_clock_t::stop();
+    // Stopping a stopped ticker does nothing
+    coarse_clock_t::stop();
+    check_fallback();
+
+    // The ticker can be restarted once stopped
+    bool const restarted = coarse_clock_t::start();
+    assert(restarted);
+    check_ticker();
+    coarse_clock_t::stop();
+    check_fallback();
+    return 0;
+}
+
+#else
+
+int main() {
+    return 0;
+}
+
+#endif
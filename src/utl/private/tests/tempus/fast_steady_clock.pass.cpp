@@ -0,0 +1,70 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/tempus/utl_fast_steady_clock.h"
+
+#include <cassert>
+
+#if UTL_TARGET_UNIX
+
+#  include <stdint.h>
+#  include <time.h>
+
+static_assert(
+    utl::tempus::is_clock<utl::tempus::fast_steady_clock_t>::value, "Invalid implementation");
+
+namespace {
+
+/**
+ * Calibration and re-sync errors are a few microseconds at most
+ */
+constexpr int64_t tolerance_ns = 1000000;
+/**
+ * Longer than the default re-sync interval so that the readings span a re-sync
+ */
+constexpr int64_t run_ns = 1100000000;
+
+int64_t os_now() {
+    ::timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+int64_t fast_now() {
+    return get_time(utl::tempus::fast_steady_clock).value();
+}
+
+} // namespace
+
+int main() {
+    // Both clocks count from the same epoch, so every reading lies between the readings of
+    // CLOCK_MONOTONIC taken around it
+    int64_t const os_start = os_now();
+    int64_t const start = fast_now();
+    assert(start >= os_start - tolerance_ns);
+    assert(start <= os_now() + tolerance_ns);
+
+    int64_t previous = start;
+    int64_t os_current = os_start;
+    while (os_current - os_start < run_ns) {
+        int64_t const before = os_now();
+        int64_t const current = fast_now();
+        os_current = os_now();
+        assert(current >= previous);
+        assert(current >= before - tolerance_ns);
+        assert(current <= os_current + tolerance_ns);
+        previous = current;
+    }
+
+    int64_t const elapsed = previous - start;
+    int64_t const os_elapsed = os_current - os_start;
+    assert(elapsed >= os_elapsed - tolerance_ns && elapsed <= os_elapsed + tolerance_ns);
+    return 0;
+}
+
+#else
+
+int main() {
+    return 0;
+}
+
+#endif
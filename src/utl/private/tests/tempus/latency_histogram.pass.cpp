@@ -0,0 +1,107 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/tempus/utl_latency_histogram.h"
+
+#include <cassert>
+#include <stdint.h>
+
+namespace {
+
+using layout = utl::tempus::details::histogram::layout;
+using ticks = utl::tempus::hardware_ticks;
+
+utl::tempus::local_latency_histogram<ticks> local;
+utl::tempus::latency_histogram<ticks> shared;
+utl::tempus::local_latency_histogram<utl::tempus::duration> durations;
+
+/**
+ * Checks that `value` falls in a bucket whose range contains it and starts after the previous one
+ */
+void check_bucket(uint64_t value) {
+    size_t const idx = layout::index_of(value);
+    assert(idx < layout::bucket_count);
+    assert(layout::highest_equivalent(idx) >= value);
+    assert(idx == 0 || layout::highest_equivalent(idx - 1) < value);
+}
+
+int64_t value(ticks t) {
+    return t.value();
+}
+
+} // namespace
+
+int main() {
+    // Values below the sub-bucket count are exact
+    assert(layout::index_of(0) == 0);
+    assert(layout::highest_equivalent(0) == 0);
+    assert(layout::index_of(31) == 31);
+    assert(layout::index_of(32) == 32 && layout::highest_equivalent(32) == 32);
+    assert(layout::index_of(63) == 63 && layout::highest_equivalent(63) == 63);
+    // From 64 onwards every power of 2 is split into 32 buckets of equal width
+    assert(layout::index_of(64) == 64 && layout::index_of(65) == 64);
+    assert(layout::highest_equivalent(64) == 65);
+    assert(layout::index_of(66) == 65);
+
+    for (unsigned int bit = 0; bit < 64; ++bit) {
+        uint64_t const power = uint64_t(1) << bit;
+        check_bucket(power);
+        check_bucket(power - 1);
+        check_bucket(power + 1);
+        if (bit >= layout::precision_bits) {
+            assert(layout::index_of(power) == (bit - layout::precision_bits + 1) * 32);
+            assert(layout::index_of(power - 1) == layout::index_of(power) - 1);
+        }
+    }
+
+    // The largest values share the last bucket
+    assert(layout::index_of(UINT64_MAX) == layout::bucket_count - 1);
+    assert(layout::highest_equivalent(layout::bucket_count - 1) == UINT64_MAX);
+    check_bucket(UINT64_MAX);
+
+    assert(local.count() == 0);
+    assert(value(local.p50()) == 0 && value(local.max()) == 0);
+
+    for (int64_t i = 1; i <= 100; ++i) {
+        local.record(ticks(i));
+    }
+    local.record(ticks::invalid());
+    assert(local.count() == 100);
+    assert(value(local.value_at_percentile(0.0)) == 1);
+    assert(value(local.p50()) == 50);
+    // 98 and 99 share a bucket, as do 100 and 101
+    assert(value(local.p99()) == 99);
+    assert(value(local.value_at_percentile(100.0)) == 101);
+    assert(value(local.value_at_percentile(250.0)) == 101);
+    assert(value(local.max()) == 101);
+
+    shared.record(ticks(1000), 100);
+    shared.merge(local);
+    assert(shared.count() == 200);
+    assert(value(shared.p50()) == 101);
+    // 1000 is in the bucket [992, 1007]
+    assert(value(shared.value_at_percentile(75.0)) == 1007);
+    assert(value(shared.max()) == 1007);
+
+    local.merge(shared);
+    assert(local.count() == 300);
+    // Every value up to 100 has been recorded twice
+    assert(value(local.value_at_percentile(25.0)) == 38);
+
+    shared.record(ticks(INT64_MAX));
+    assert(shared.count() == 201);
+    assert(value(shared.max()) == INT64_MAX);
+
+    local.reset();
+    shared.reset();
+    assert(local.count() == 0 && shared.count() == 0);
+    assert(value(shared.max()) == 0);
+
+    durations.record(utl::tempus::duration(0, 1500));
+    durations.record(utl::tempus::duration(2, 0));
+    durations.record(utl::tempus::duration::invalid());
+    assert(durations.count() == 2);
+    assert(durations.p50().seconds() == 0 && durations.p50().nanoseconds() >= 1500);
+    assert(durations.p50().nanoseconds() < 1500 + 1500 / 32);
+    assert(durations.max().seconds() == 2);
+    return 0;
+}
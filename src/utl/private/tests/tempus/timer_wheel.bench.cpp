@@ -0,0 +1,64 @@
+// Copyright 2023-2024 Bryan Wong
+
+// Schedules 1e6 concurrent timers and reports the per-operation cost
+
+#include "utl/tempus/utl_clock.h"
+#include "utl/tempus/utl_timer_wheel.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+using wheel_type = utl::tempus::timer_wheel<utl::tempus::steady_clock_t>;
+
+struct timer : utl::tempus::timer_node {
+    bool fired = false;
+};
+
+constexpr size_t timer_count = 1000000;
+
+double nanoseconds_per_op(utl::tempus::duration d, size_t count) {
+    return (d.seconds() * 1e9 + d.nanoseconds()) / count;
+}
+} // namespace
+
+int main() {
+    using namespace utl::literals::tempus_literals;
+    auto const start = get_time(utl::tempus::steady_clock);
+    wheel_type wheel(start, 1ms);
+    std::vector<timer> timers(timer_count);
+
+    auto begin = get_time(utl::tempus::steady_clock);
+    for (size_t idx = 0; idx < timer_count; ++idx) {
+        // Delays up to 500ms spread across the first two levels
+        wheel.schedule(timers[idx], utl::tempus::duration{0, int64_t(1 + idx % 500) * 1000000});
+    }
+    auto const schedule_time = get_time(utl::tempus::steady_clock) - begin;
+
+    size_t cancelled = 0;
+    begin = get_time(utl::tempus::steady_clock);
+    for (size_t idx = 0; idx < timer_count; idx += 2) {
+        cancelled += wheel.cancel(timers[idx]);
+    }
+    auto const cancel_time = get_time(utl::tempus::steady_clock) - begin;
+
+    size_t fired = 0;
+    auto advance_time = utl::tempus::duration::zero();
+    while (!wheel.empty()) {
+        auto const now = get_time(utl::tempus::steady_clock);
+        fired += wheel.advance(now, [](utl::tempus::timer_node& node) {
+            static_cast<timer&>(node).fired = true;
+        });
+        advance_time = advance_time + (get_time(utl::tempus::steady_clock) - now);
+    }
+
+    if (cancelled + fired != timer_count) {
+        ::fprintf(stderr, "expected %zu timers, got %zu\n", timer_count, cancelled + fired);
+        return 1;
+    }
+
+    ::printf("schedule: %.1f ns/timer\n", nanoseconds_per_op(schedule_time, timer_count));
+    ::printf("cancel: %.1f ns/timer\n", nanoseconds_per_op(cancel_time, cancelled));
+    ::printf("advance: %.1f ns/timer\n", nanoseconds_per_op(advance_time, fired));
+    return 0;
+}
@@ -0,0 +1,181 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/tempus/utl_clock.h"
+#include "utl/tempus/utl_timer_wheel.h"
+
+#include <cassert>
+#include <stdint.h>
+
+/**
+ * A clock that only moves when told to, so that expiry can be checked at exact instants
+ */
+struct manual_clock_t {};
+
+UTL_NAMESPACE_BEGIN
+namespace tempus {
+template <>
+struct clock_traits<manual_clock_t> {
+    using clock = manual_clock_t;
+    /** Nanoseconds since the start of the test */
+    using value_type = int64_t;
+    using duration_type = duration;
+
+    static constexpr duration_type time_since_epoch(value_type t) noexcept {
+        return duration_type{0, t};
+    }
+
+    static constexpr duration_type difference(value_type l, value_type r) noexcept {
+        return duration_type{0, l - r};
+    }
+
+    static constexpr bool equal(value_type l, value_type r) noexcept { return l == r; }
+
+    static constexpr clock_order compare(value_type l, value_type r) noexcept {
+        return static_cast<clock_order>((l > r) - (l < r));
+    }
+
+    static time_point<manual_clock_t> at(value_type t) noexcept {
+        return time_point<manual_clock_t>{t};
+    }
+};
+} // namespace tempus
+UTL_NAMESPACE_END
+
+namespace {
+using wheel_type = utl::tempus::timer_wheel<manual_clock_t>;
+using utl::tempus::duration;
+
+constexpr int64_t ms = 1000000;
+
+struct timer : utl::tempus::timer_node {
+    int fired = 0;
+};
+
+timer* last_fired = nullptr;
+
+void on_expire(utl::tempus::timer_node& node) {
+    auto& t = static_cast<timer&>(node);
+    assert(!t.scheduled());
+    ++t.fired;
+    last_fired = &t;
+}
+
+utl::tempus::time_point<manual_clock_t> at(int64_t ns) {
+    return utl::tempus::clock_traits<manual_clock_t>::at(ns);
+}
+
+size_t advance(wheel_type& wheel, int64_t ns) {
+    return wheel.advance(at(ns), on_expire);
+}
+} // namespace
+
+int main() {
+    {
+        wheel_type wheel(at(0), duration{0, ms});
+        timer exact;
+        timer partial;
+        timer zero;
+        wheel.schedule(exact, duration{0, 3 * ms});
+        // Rounded up to 3 ticks rather than down to 2
+        wheel.schedule(partial, duration{0, 2 * ms + ms / 2});
+        wheel.schedule(zero, duration{0, 0});
+        assert(wheel.size() == 3);
+
+        assert(advance(wheel, ms - 1) == 0);
+        assert(advance(wheel, ms) == 1 && zero.fired == 1);
+        assert(advance(wheel, 2 * ms) == 0 && partial.fired == 0);
+        assert(advance(wheel, 3 * ms - 1) == 0);
+        // A delay of exactly 3 ticks fires at the tick boundary
+        assert(advance(wheel, 3 * ms) == 2);
+        assert(exact.fired == 1 && partial.fired == 1);
+        assert(wheel.empty());
+
+        // Delays are measured from the wheel's current tick
+        advance(wheel, 3 * ms + ms / 2);
+        wheel.schedule(exact, duration{0, ms});
+        assert(advance(wheel, 4 * ms - 1) == 0);
+        assert(advance(wheel, 4 * ms) == 1 && exact.fired == 2);
+    }
+
+    {
+        wheel_type wheel(at(0), duration{0, ms});
+        timer first;
+        timer second;
+        wheel.schedule(first, duration{0, 10 * ms});
+        wheel.schedule(second, duration{0, 10 * ms});
+        bool const cancelled = wheel.cancel(first);
+        assert(cancelled);
+        assert(!first.scheduled() && wheel.size() == 1);
+        bool const cancelled_again = wheel.cancel(first);
+        assert(!cancelled_again);
+
+        // Rescheduling moves the timer
+        wheel.schedule(second, duration{0, 20 * ms});
+        assert(wheel.size() == 1);
+        assert(advance(wheel, 19 * ms) == 0);
+        assert(advance(wheel, 20 * ms) == 1 && second.fired == 1);
+        assert(first.fired == 0);
+    }
+
+    {
+        // Timers on higher levels cascade down and still fire on their exact tick
+        wheel_type wheel(at(0), duration{0, ms});
+        timer near;
+        timer far;
+        timer farther;
+        wheel.schedule(near, duration{0, 64 * ms});
+        wheel.schedule(far, duration{0, 5000 * ms});
+        wheel.schedule(farther, duration{300, 0});
+        assert(advance(wheel, 63 * ms) == 0);
+        assert(advance(wheel, 64 * ms) == 1 && near.fired == 1);
+        assert(advance(wheel, 5000 * ms - 1) == 0);
+        assert(advance(wheel, 5000 * ms) == 1 && far.fired == 1);
+        assert(advance(wheel, 300000 * ms - 1) == 0);
+        assert(advance(wheel, 300000 * ms) == 1 && farther.fired == 1);
+    }
+
+    {
+        // Timers beyond the wheel's range of 2^36 ticks are parked and still fire on their tick
+        wheel_type wheel(at(0), duration{0, 1});
+        timer beyond;
+        timer edge;
+        int64_t const range = int64_t(1) << 36;
+        wheel.schedule(beyond, duration{0, 3 * range + 5});
+        wheel.schedule(edge, duration{0, range - 1});
+        assert(advance(wheel, range - 2) == 0);
+        assert(advance(wheel, range - 1) == 1 && edge.fired == 1);
+        assert(advance(wheel, 3 * range + 4) == 0 && beyond.scheduled());
+        assert(advance(wheel, 3 * range + 5) == 1 && beyond.fired == 1);
+    }
+
+    {
+        // A callback may reschedule the timer it is passed
+        wheel_type wheel(at(0), duration{0, ms});
+        timer periodic;
+        wheel.schedule(periodic, duration{0, 5 * ms});
+        size_t fired = 0;
+        for (int64_t now = ms; now <= 50 * ms; now += ms) {
+            fired += wheel.advance(at(now), [&](utl::tempus::timer_node& node) {
+                on_expire(node);
+                wheel.schedule(node, duration{0, 5 * ms});
+            });
+        }
+
+        assert(fired == 10 && periodic.fired == 10);
+        assert(last_fired == &periodic && periodic.scheduled());
+    }
+
+    {
+        timer pending;
+        {
+            wheel_type wheel(at(0), duration{0, ms});
+            wheel.schedule(pending, duration{1, 0});
+            assert(pending.scheduled());
+        }
+
+        // Destroying the wheel unschedules without firing
+        assert(!pending.scheduled() && pending.fired == 0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/trace/utl_trace.h"
+
+#include <cassert>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+
+char output[1 << 22];
+
+size_t dump() {
+    ::FILE* const file = ::tmpfile();
+    assert(file != nullptr);
+    size_t const count = utl::trace::dump_chrome_trace(file);
+    ::rewind(file);
+    size_t const size = ::fread(output, 1, sizeof(output) - 1, file);
+    output[size] = 0;
+    ::fclose(file);
+    return count;
+}
+
+size_t occurrences(char const* pattern) {
+    size_t count = 0;
+    for (char const* it = ::strstr(output, pattern); it != nullptr;
+         it = ::strstr(it + 1, pattern)) {
+        ++count;
+    }
+
+    return count;
+}
+
+char const* find_event(char const* from, char const* name, char phase) {
+    char pattern[64];
+    ::snprintf(pattern, sizeof(pattern), "\"name\":\"%s\",\"ph\":\"%c\"", name, phase);
+    return from == nullptr ? nullptr : ::strstr(from, pattern);
+}
+
+void inner() {
+    UTL_TRACE_SCOPE("inner");
+}
+
+void outer() {
+    UTL_TRACE_SCOPE("outer");
+    inner();
+}
+
+void* spin(void*) {
+    // Wraps the ring several times so that the dump races with overwrites
+    for (int i = 0; i < 4 * UTL_TRACE_RING_CAPACITY; ++i) {
+        UTL_TRACE_SCOPE("worker");
+    }
+
+    return nullptr;
+}
+
+} // namespace
+
+int main() {
+    assert(utl::trace::enabled());
+    outer();
+    assert(dump() == 4);
+    assert(occurrences("\"name\":") == 4);
+
+    // Events are written in recording order, so the zones nest
+    char const* const outer_begin = find_event(output, "outer", 'B');
+    char const* const inner_begin = find_event(outer_begin, "inner", 'B');
+    char const* const inner_end = find_event(inner_begin, "inner", 'E');
+    char const* const outer_end = find_event(inner_end, "outer", 'E');
+    assert(outer_begin != nullptr && inner_begin != nullptr);
+    assert(inner_end != nullptr && outer_end != nullptr);
+
+    utl::trace::disable();
+    outer();
+    utl::trace::enable();
+    assert(dump() == 4);
+
+    pthread_t worker;
+    int const created = ::pthread_create(&worker, nullptr, &spin, nullptr);
+    assert(created == 0);
+    // Torn or overwritten slots are skipped, every event that is written is intact
+    for (int i = 0; i < 16; ++i) {
+        size_t const count = dump();
+        assert(occurrences("\"name\":") == count);
+        assert(occurrences("\"name\":\"worker\",\"ph\":\"") + 4 == count);
+    }
+
+    ::pthread_join(worker, nullptr);
+    assert(dump() == 4 + UTL_TRACE_RING_CAPACITY);
+    return 0;
+}
@@ -0,0 +1,273 @@
+// Copyright 2023-2024 Bryan Wong
+
+#include "utl/trace/utl_trace.h"
+
+#include "utl/atomic/utl_atomic.h"
+#include "utl/tempus/utl_clock.h"
+
+#include <stdlib.h>
+
+#if UTL_TARGET_LINUX
+#  include <sched.h>
+#endif
+
+#if UTL_TARGET_UNIX
+#  include <unistd.h>
+#endif
+
+UTL_NAMESPACE_BEGIN
+
+namespace trace {
+namespace {
+
+static_assert((UTL_TRACE_RING_CAPACITY & (UTL_TRACE_RING_CAPACITY - 1)) == 0,
+    "UTL_TRACE_RING_CAPACITY must be a power of 2");
+
+constexpr uint64_t ring_capacity = UTL_TRACE_RING_CAPACITY;
+constexpr uint64_t ring_mask = ring_capacity - 1;
+
+/**
+ * A ring entry guarded by a sequence lock
+ *
+ * The sequence is odd while the owning thread is writing the slot and `2 * (index + 1)` once the
+ * event with the given index has been written, so a reader knows which event it copied and whether
+ * the copy was torn.
+ */
+struct slot_t {
+    uint64_t sequence;
+    event_t event;
+};
+
+struct thread_ring {
+    thread_ring* next;
+    uint32_t thread_index;
+    /**
+     * Total number of events recorded, only ever written by the owning thread
+     */
+    uint64_t head;
+    slot_t slots[ring_capacity];
+};
+
+struct stamp_t {
+    int64_t tick;
+    int cpu;
+};
+
+/**
+ * Rings are never released so that events of threads that have exited can still be dumped
+ */
+thread_ring* ring_list = nullptr;
+uint32_t thread_counter = 0;
+bool tracing_enabled = true;
+thread_local thread_ring* local_ring = nullptr;
+
+UTL_ATTRIBUTE(NOINLINE) thread_ring* register_ring() noexcept {
+    auto ring = static_cast<thread_ring*>(::calloc(1, sizeof(thread_ring)));
+    if (ring == nullptr) {
+        return nullptr;
+    }
+
+    ring->thread_index = atomic_relaxed::fetch_add(&thread_counter, 1u);
+    auto head = atomic_relaxed::load(&ring_list);
+    do {
+        ring->next = head;
+    } while (!atomic_release::compare_exchange_weak(
+        &ring_list, &head, ring, atomics::relaxed_failure));
+
+    local_ring = ring;
+    return ring;
+}
+
+UTL_ATTRIBUTE(ALWAYS_INLINE) inline stamp_t read_stamp() noexcept {
+    auto const now = get_time(tempus::hardware_clock, instruction_barrier_none);
+#if UTL_ARCH_x86_64
+    int cpu = now.value().aux;
+#  if UTL_TARGET_LINUX
+    // Linux stores (node << 12) | cpu in IA32_TSC_AUX
+    cpu = cpu < 0 ? cpu : (cpu & 0xfff);
+#  endif
+    return {now.value().tick, cpu};
+#elif UTL_TARGET_LINUX
+    return {now.time_since_epoch().value(), ::sched_getcpu()};
+#else
+    return {now.time_since_epoch().value(), -1};
+#endif
+}
+
+int process_id() noexcept {
+#if UTL_TARGET_UNIX
+    return static_cast<int>(::getpid());
+#else
+    return 0;
+#endif
+}
+
+void write_escaped(::FILE* file, char const* str) noexcept {
+    for (; *str; ++str) {
+        auto const c = static_cast<unsigned char>(*str);
+        if (c == '"' || c == '\\') {
+            ::fputc('\\', file);
+            ::fputc(c, file);
+        } else if (c < 0x20) {
+            ::fprintf(file, "\\u%04x", static_cast<unsigned int>(c));
+        } else {
+            ::fputc(c, file);
+        }
+    }
+}
+
+void write_timestamp(::FILE* file, int64_t ticks) noexcept {
+    auto const elapsed = tempus::to_duration(tempus::hardware_ticks(ticks));
+    if (!elapsed) {
+        ::fprintf(file, "%lld", static_cast<long long>(ticks));
+        return;
+    }
+
+    auto const ns = elapsed.nanoseconds();
+    ::fprintf(file, "%llu.%03u",
+        static_cast<unsigned long long>(elapsed.seconds() * 1000000 + ns / 1000), ns % 1000);
+}
+
+uint64_t oldest_index(uint64_t head) noexcept {
+    return head > ring_capacity ? head - ring_capacity : 0;
+}
+
+/**
+ * The payload of a slot is accessed with relaxed atomics since a reader may copy it while the
+ * owner overwrites it; the sequence decides whether the copy is kept
+ */
+void store_event(event_t& dst, event_t const& src) noexcept {
+    atomic_relaxed::store(&dst.name, src.name);
+    atomic_relaxed::store(&dst.tick, src.tick);
+    atomic_relaxed::store(&dst.cpu, src.cpu);
+    atomic_relaxed::store(
+        reinterpret_cast<unsigned char*>(&dst.phase), static_cast<unsigned char>(src.phase));
+}
+
+void load_event(event_t& dst, event_t const& src) noexcept {
+    dst.name = atomic_relaxed::load(&src.name);
+    dst.tick = atomic_relaxed::load(&src.tick);
+    dst.cpu = atomic_relaxed::load(&src.cpu);
+    dst.phase = static_cast<event_phase>(
+        atomic_relaxed::load(reinterpret_cast<unsigned char const*>(&src.phase)));
+}
+
+constexpr uint64_t complete_sequence(uint64_t index) noexcept {
+    return 2 * (index + 1);
+}
+
+/**
+ * Copies the event with the given index out of its slot
+ *
+ * @return `false` if the slot no longer holds the event or was written during the copy
+ */
+bool read_event(slot_t const& slot, uint64_t index, event_t& out) noexcept {
+    auto const expected = complete_sequence(index);
+    if (atomic_acquire::load(&slot.sequence) != expected) {
+        return false;
+    }
+
+    load_event(out, slot.event);
+    atomic_acquire::thread_fence();
+    // A writer entering the slot makes the sequence odd, so only an unchanged even sequence
+    // guarantees the copy is intact
+    return atomic_relaxed::load(&slot.sequence) == expected;
+}
+
+int64_t earliest_tick() noexcept {
+    int64_t result = -1;
+    for (auto ring = atomic_acquire::load(&ring_list); ring != nullptr; ring = ring->next) {
+        auto const head = atomic_acquire::load(&ring->head);
+        for (auto idx = oldest_index(head); idx != head; ++idx) {
+            event_t event;
+            if (read_event(ring->slots[idx & ring_mask], idx, event)) {
+                if (result < 0 || event.tick < result) {
+                    result = event.tick;
+                }
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+} // namespace
+
+void record(char const* name, event_phase phase) noexcept {
+    if (!atomic_relaxed::load(&tracing_enabled)) {
+        return;
+    }
+
+    auto ring = local_ring;
+    if (UTL_BUILTIN_expect(ring == nullptr, 0) && (ring = register_ring()) == nullptr) {
+        return;
+    }
+
+    auto const stamp = read_stamp();
+    auto const head = ring->head;
+    auto& slot = ring->slots[head & ring_mask];
+    atomic_relaxed::store(&slot.sequence, 2 * head + 1);
+    atomic_release::thread_fence();
+    store_event(slot.event, event_t{name, stamp.tick, stamp.cpu, phase});
+    atomic_release::store(&slot.sequence, complete_sequence(head));
+    atomic_release::store(&ring->head, head + 1);
+}
+
+void enable() noexcept {
+    atomic_relaxed::store(&tracing_enabled, true);
+}
+
+void disable() noexcept {
+    atomic_relaxed::store(&tracing_enabled, false);
+}
+
+bool enabled() noexcept {
+    return atomic_relaxed::load(&tracing_enabled);
+}
+
+size_t dump_chrome_trace(::FILE* file) noexcept {
+    if (file == nullptr) {
+        return 0;
+    }
+
+    auto const base = earliest_tick();
+    auto const pid = process_id();
+    size_t count = 0;
+    ::fputs("{\"traceEvents\":[", file);
+    for (auto ring = atomic_acquire::load(&ring_list); ring != nullptr; ring = ring->next) {
+        auto const head = atomic_acquire::load(&ring->head);
+        for (auto idx = oldest_index(head); idx != head; ++idx) {
+            // Skip any event the owner overwrote before or while it was being copied
+            event_t event;
+            if (!read_event(ring->slots[idx & ring_mask], idx, event)) {
+                continue;
+            }
+
+            ::fputs(count ? ",\n{\"name\":\"" : "\n{\"name\":\"", file);
+            write_escaped(file, event.name);
+            ::fprintf(file, "\",\"ph\":\"%c\",\"ts\":", static_cast<char>(event.phase));
+            write_timestamp(file, event.tick > base ? event.tick - base : 0);
+            ::fprintf(file, ",\"pid\":%d,\"tid\":%u,\"args\":{\"cpu\":%d}}", pid,
+                ring->thread_index, event.cpu);
+            ++count;
+        }
+    }
+
+    ::fputs("\n]}\n", file);
+    return count;
+}
+
+bool dump_chrome_trace(char const* path) noexcept {
+    auto file = ::fopen(path, "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    dump_chrome_trace(file);
+    auto const failed = ::ferror(file);
+    return (::fclose(file) == 0) && !failed;
+}
+
+} // namespace trace
+
+UTL_NAMESPACE_END
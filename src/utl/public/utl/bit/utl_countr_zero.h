@@ -51,8 +51,8 @@ private:
         return compute((unsigned long long)(x & mask()), (unsigned long long)(x >> 64));
     }
 
-    static constexpr int compute(unsigned long long hi, unsigned long long low) noexcept {
-        return low == 0 ? 64 + builtin_clz(hi) : builtin_clz(low);
+    static constexpr int compute(unsigned long long low, unsigned long long high) noexcept {
+        return low == 0 ? 64 + builtin_ctz(high) : builtin_ctz(low);
     }
 
     int result;
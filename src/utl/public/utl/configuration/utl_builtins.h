@@ -27,6 +27,14 @@
 #  define UTL_BUILTIN_addressof(X) __builtin_addressof(X)
 #endif /* if UTL_HAS_BUILTIN(__builtin_addressof) */
 
+#if UTL_HAS_BUILTIN(__builtin_expect)
+#  define UTL_BUILTIN_expect(VALUE, EXP) __builtin_expect(VALUE, EXP)
+#elif UTL_COMPILER_GCC_AT_LEAST(3, 0, 0)
+#  define UTL_BUILTIN_expect(VALUE, EXP) __builtin_expect(VALUE, EXP)
+#else /* UTL_HAS_BUILTIN(__builtin_expect) */
+#  define UTL_BUILTIN_expect(VALUE, _1) VALUE
+#endif /* UTL_HAS_BUILTIN(__builtin_expect) */
+
 #if UTL_HAS_BUILTIN(__builtin_unreachable)
 #  define UTL_BUILTIN_unreachable() __builtin_unreachable()
 #elif UTL_COMPILER_GCC_AT_LEAST(4, 5, 0)
@@ -37,12 +45,6 @@
 #  define UTL_BUILTIN_unreachable() __assume(0)
 #else /* UTL_HAS_BUILTIN(__builtin_unreachable) */
 
-#  if UTL_HAS_BUILTIN(__builtin_expect)
-#    define UTL_BUILTIN_expect(VALUE, EXP) __builtin_expect(VALUE, EXP)
-#  else
-#    define UTL_BUILTIN_expect(VALUE, _1) VALUE
-#  endif
-
 #  ifdef UTL_CXX
 extern "C" void abort(void);
 #  else
@@ -6,6 +6,11 @@
 
 #if UTL_ARCH_x86
 
+/* SSE2 is part of the x86-64 baseline, used by kernels that do not need anything newer */
+#  ifdef __SSE2__
+#    define UTL_SIMD_X86_SSE2 1
+#  endif
+
 /* Use SSE4.2 as a minimum SIMD support */
 #  ifdef __SSE4_2__
 #    define UTL_SIMD_X86_SSE4_2 1
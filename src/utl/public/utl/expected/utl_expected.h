@@ -13,3 +13,19 @@
 #  include "utl/expected/utl_expected_cpp17.h"
 #endif
 #undef UTL_EXPECTED_PRIVATE_HEADER_GUARD
+
+#include "utl/type_traits/utl_is_trivially_relocatable.h"
+#include "utl/type_traits/utl_is_void.h"
+#include "utl/type_traits/utl_logical_traits.h"
+
+UTL_NAMESPACE_BEGIN
+
+/**
+ * The value or error is stored inline next to a flag, so an expected relocates like its members.
+ */
+template <typename T, typename E>
+struct __UTL_PUBLIC_TEMPLATE is_trivially_relocatable<expected<T, E>> :
+    conjunction<disjunction<is_void<T>, is_trivially_relocatable<T>>,
+        is_trivially_relocatable<E>> {};
+
+UTL_NAMESPACE_END
@@ -0,0 +1,49 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+UTL_NAMESPACE_BEGIN
+
+/**
+ * Instruction set extensions supported by the executing CPU
+ *
+ * Probed once on first use, with CPUID on x86 and `getauxval(AT_HWCAP)` on Linux ARM; extensions
+ * whose register state is not enabled by the OS are reported as unsupported. Used to select
+ * kernels at runtime so that a binary built for the baseline ISA still takes the fastest path.
+ */
+struct __UTL_ABI_PUBLIC cpu_features {
+    /* x86 */
+    bool sse2;
+    bool ssse3;
+    bool sse4_2;
+    bool popcnt;
+    bool avx;
+    bool avx2;
+    bool bmi1;
+    bool bmi2;
+    bool avx512f;
+    bool avx512bw;
+    bool avx512vl;
+    /** Enhanced REP MOVSB/STOSB */
+    bool erms;
+    /** Fast short REP MOVSB */
+    bool fsrm;
+
+    /* ARM */
+    bool neon;
+    bool crc32;
+    bool sve;
+    bool sve2;
+
+    /** Size in bytes of the last level data cache shared by the executing core, 0 if unknown */
+    size_t last_level_cache_size;
+
+    /**
+     * @return The features of the executing CPU
+     */
+    __UTL_ABI_PUBLIC static cpu_features const& current() noexcept;
+};
+
+UTL_NAMESPACE_END
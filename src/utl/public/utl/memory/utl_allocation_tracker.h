@@ -0,0 +1,198 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/atomic/utl_atomic.h"
+#include "utl/bit/utl_bit_width.h"
+#include "utl/source_location/utl_source_location.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace memory {
+
+/**
+ * Counters of an `allocation_tracker` read at one point in time
+ */
+struct allocation_statistics {
+    /**
+     * Buckets of the size histogram, bucket `i` counts the allocations of `(2^(i-1), 2^i]` bytes
+     * and the last bucket every larger allocation
+     */
+    static constexpr size_t bucket_count = 32;
+
+    uint64_t allocations;
+    uint64_t deallocations;
+    uint64_t allocated_bytes;
+    uint64_t deallocated_bytes;
+    uint64_t size_histogram[bucket_count];
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) constexpr uint64_t live_allocations() const noexcept {
+        return allocations - deallocations;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) constexpr uint64_t live_bytes() const noexcept {
+        return allocated_bytes - deallocated_bytes;
+    }
+};
+
+/**
+ * A sampled allocation and the site it is attributed to, the site is empty when unknown
+ */
+struct allocation_sample {
+    char const* file_name;
+    char const* function_name;
+    unsigned int line;
+    size_t bytes;
+};
+
+/**
+ * Thread-safe allocation counters with a size histogram and a ring of sampled allocations.
+ *
+ * Every allocation updates the counters with relaxed atomic operations, one in `sample_period`
+ * allocations is also recorded with its call site in a ring of the most recent samples. Trackers
+ * are fed by `tracking_allocator` and, when `UTL_ALLOCATION_HOOKS` is enabled, by every allocation
+ * made through `memory::details::allocate` into the `global` tracker. Default-constructed
+ * `tracking_allocator`s record into the separate `adaptors` tracker so that an allocation is never
+ * counted twice in `global`.
+ */
+class __UTL_ABI_PUBLIC allocation_tracker {
+public:
+    static constexpr size_t sample_capacity = 64;
+
+    /**
+     * @param sample_period The number of allocations between samples, 0 disables sampling.
+     */
+    __UTL_HIDE_FROM_ABI constexpr explicit allocation_tracker(uint32_t sample_period = 64) noexcept
+        : sample_period_(sample_period)
+        , allocations_(0)
+        , deallocations_(0)
+        , allocated_bytes_(0)
+        , deallocated_bytes_(0)
+        , histogram_{}
+        , sample_cursor_(0)
+        , samples_{} {}
+
+    allocation_tracker(allocation_tracker const&) = delete;
+    allocation_tracker& operator=(allocation_tracker const&) = delete;
+
+    /**
+     * Returns the tracker fed by the allocation hooks.
+     */
+    UTL_ATTRIBUTE(NODISCARD) static allocation_tracker& global() noexcept;
+
+    /**
+     * Returns the tracker default-constructed `tracking_allocator`s record into.
+     */
+    UTL_ATTRIBUTE(NODISCARD) static allocation_tracker& adaptors() noexcept;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) void record_allocation(
+        size_t bytes, source_location const& site = source_location()) noexcept {
+        uint64_t const count = atomic_relaxed::fetch_add(&allocations_, uint64_t(1));
+        atomic_relaxed::fetch_add(&allocated_bytes_, uint64_t(bytes));
+        atomic_relaxed::fetch_add(&histogram_[bucket_of(bytes)], uint64_t(1));
+        if (sample_period_ != 0 && count % sample_period_ == 0) {
+            sample(bytes, site);
+        }
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) void record_deallocation(size_t bytes) noexcept {
+        atomic_relaxed::fetch_add(&deallocations_, uint64_t(1));
+        atomic_relaxed::fetch_add(&deallocated_bytes_, uint64_t(bytes));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) allocation_statistics statistics() const noexcept {
+        allocation_statistics result;
+        result.allocations = atomic_relaxed::load(&allocations_);
+        result.deallocations = atomic_relaxed::load(&deallocations_);
+        result.allocated_bytes = atomic_relaxed::load(&allocated_bytes_);
+        result.deallocated_bytes = atomic_relaxed::load(&deallocated_bytes_);
+        for (size_t i = 0; i != allocation_statistics::bucket_count; ++i) {
+            result.size_histogram[i] = atomic_relaxed::load(&histogram_[i]);
+        }
+
+        return result;
+    }
+
+    /**
+     * Copies the most recent samples, skipping any that are being overwritten.
+     *
+     * @return The number of samples copied into `output`
+     */
+    __UTL_HIDE_FROM_ABI size_t samples(allocation_sample* output, size_t capacity) const noexcept {
+        size_t copied = 0;
+        for (size_t i = 0; i != sample_capacity && copied != capacity; ++i) {
+            slot const& source = samples_[i];
+            uint64_t const sequence = atomic_acquire::load(&source.sequence);
+            if (sequence == 0 || (sequence & 1) != 0) {
+                continue;
+            }
+
+            allocation_sample& target = output[copied];
+            target.file_name = atomic_relaxed::load(&source.file_name);
+            target.function_name = atomic_relaxed::load(&source.function_name);
+            target.line = atomic_relaxed::load(&source.line);
+            target.bytes = atomic_relaxed::load(&source.bytes);
+            atomic_acquire::thread_fence();
+            if (atomic_relaxed::load(&source.sequence) == sequence) {
+                ++copied;
+            }
+        }
+
+        return copied;
+    }
+
+private:
+    /**
+     * A sample guarded by a sequence number that is odd while the sample is written
+     */
+    struct slot {
+        uint64_t sequence;
+        char const* file_name;
+        char const* function_name;
+        unsigned int line;
+        size_t bytes;
+    };
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, CONST) static size_t bucket_of(size_t bytes) noexcept {
+        size_t const bucket = bytes <= 1 ? 0 : static_cast<size_t>(__UTL bit_width(bytes - 1));
+        return bucket < allocation_statistics::bucket_count ? bucket
+                                                            : allocation_statistics::bucket_count - 1;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NOINLINE) void sample(size_t bytes, source_location const& site) noexcept {
+        uint64_t const index = atomic_relaxed::fetch_add(&sample_cursor_, uint64_t(1));
+        slot& target = samples_[index % sample_capacity];
+        uint64_t sequence = atomic_relaxed::load(&target.sequence);
+        // A sample is dropped rather than waited for if another thread is writing the slot
+        if ((sequence & 1) != 0 ||
+            !atomic_relaxed::compare_exchange_strong(
+                &target.sequence, &sequence, sequence + 1, atomics::relaxed_failure)) {
+            return;
+        }
+
+        atomic_release::thread_fence();
+        atomic_relaxed::store(&target.file_name, site.file_name());
+        atomic_relaxed::store(&target.function_name, site.function_name());
+        atomic_relaxed::store(&target.line, site.line());
+        atomic_relaxed::store(&target.bytes, bytes);
+        atomic_release::store(&target.sequence, sequence + 2);
+    }
+
+    uint32_t sample_period_;
+    uint64_t allocations_;
+    uint64_t deallocations_;
+    uint64_t allocated_bytes_;
+    uint64_t deallocated_bytes_;
+    uint64_t histogram_[allocation_statistics::bucket_count];
+    uint64_t sample_cursor_;
+    slot samples_[sample_capacity];
+};
+
+} // namespace memory
+
+UTL_NAMESPACE_END
@@ -50,6 +50,22 @@ public:
     __UTL_HIDE_FROM_ABI UTL_CONSTEXPR_CXX20 void deallocate(pointer pointer, size_type count) noexcept;
 
     __UTL_HIDE_FROM_ABI UTL_CONSTEXPR_CXX20 ~allocator() noexcept = default;
+
+    /**
+     * Every allocator draws from the same heap, so memory allocated by one can be deallocated by
+     * any other regardless of the element type
+     */
+    template <typename U>
+    UTL_ATTRIBUTES(NODISCARD, _HIDE_FROM_ABI) friend constexpr bool operator==(
+        allocator const&, allocator<U> const&) noexcept {
+        return true;
+    }
+
+    template <typename U>
+    UTL_ATTRIBUTES(NODISCARD, _HIDE_FROM_ABI) friend constexpr bool operator!=(
+        allocator const&, allocator<U> const&) noexcept {
+        return false;
+    }
 };
 UTL_NAMESPACE_END
 
@@ -61,6 +77,26 @@ UTL_NAMESPACE_END
 #  define __UTL_ALLOC_DELETE(...) ::operator delete(__VA_ARGS__)
 #endif
 
+/**
+ * Routes small allocations made through `memory::details::allocate`, and so every `utl::allocator`,
+ * to a thread-caching allocator compiled into the library instead of the global `operator new`.
+ *
+ * Define `UTL_THREAD_CACHING_ALLOCATOR` to 0 when building both the library and its users to
+ * allocate everything from the global heap.
+ */
+#ifndef UTL_THREAD_CACHING_ALLOCATOR
+#  define UTL_THREAD_CACHING_ALLOCATOR 1
+#endif
+
+/**
+ * Define `UTL_ALLOCATION_HOOKS` to 1 to count every allocation requested through
+ * `memory::details::allocate` in `memory::allocation_tracker::global()`, the library does not need
+ * to be rebuilt.
+ */
+#ifndef UTL_ALLOCATION_HOOKS
+#  define UTL_ALLOCATION_HOOKS 0
+#endif
+
 UTL_NAMESPACE_BEGIN
 using ::std::align_val_t;
 
@@ -81,8 +117,45 @@ UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, CONST) inline constexpr bool is_ov
     return alignment > default_new_alignment;
 }
 
+/**
+ * Records an allocation or deallocation in the global allocation tracker
+ */
+__UTL_ABI_PUBLIC void on_allocate(size_t size) noexcept;
+__UTL_ABI_PUBLIC void on_deallocate(size_t size) noexcept;
+
+#if UTL_THREAD_CACHING_ALLOCATOR
+/**
+ * Largest size served by the thread-caching allocator
+ */
+UTL_INLINE_CXX17 constexpr size_t small_size_limit = 8192;
+/**
+ * Strictest alignment guaranteed by the thread-caching allocator
+ */
+UTL_INLINE_CXX17 constexpr size_t small_alignment = 16;
+
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, CONST) inline constexpr bool is_small_allocation(
+    size_t size, size_t alignment) noexcept {
+    return size <= small_size_limit && alignment <= small_alignment;
+}
+
+/**
+ * Allocates a block of at least `size` bytes from the calling thread's cache
+ *
+ * @throws std::bad_alloc - if the cache is empty and a new span cannot be allocated
+ */
+__UTL_ABI_PUBLIC void* allocate_small(size_t size) UTL_THROWS;
+
+/**
+ * Returns a block obtained from `allocate_small` with the same `size` to the calling thread's cache
+ */
+__UTL_ABI_PUBLIC void deallocate_small(void* pointer, size_t size) noexcept;
+#endif
+
 __UTL_HIDE_FROM_ABI inline void deallocate(
     void* pointer, size_t size, size_t alignment = default_new_alignment) noexcept {
+#if UTL_ALLOCATION_HOOKS
+    on_deallocate(size);
+#endif
     if (is_overaligned_for_new(alignment)) {
 #if UTL_SUPPORTS_ALIGNED_ALLOCATION
         align_val_t const align_val = static_cast<align_val_t>(alignment);
@@ -96,6 +169,12 @@ __UTL_HIDE_FROM_ABI inline void deallocate(
         UTL_BUILTIN_unreachable();
 #endif
     } else {
+#if UTL_THREAD_CACHING_ALLOCATOR
+        if (is_small_allocation(size, alignment)) {
+            deallocate_small(pointer, size);
+            return;
+        }
+#endif
         (void)alignment;
 #if UTL_SUPPORTS_SIZED_DEALLOCATION
         __UTL_ALLOC_DELETE(pointer, size);
@@ -107,6 +186,9 @@ __UTL_HIDE_FROM_ABI inline void deallocate(
 }
 
 __UTL_HIDE_FROM_ABI inline void* allocate(size_t size, size_t alignment = default_new_alignment) {
+#if UTL_ALLOCATION_HOOKS
+    on_allocate(size);
+#endif
     if (is_overaligned_for_new(alignment)) {
 #if UTL_SUPPORTS_ALIGNED_ALLOCATION
         align_val_t const align_val = static_cast<align_val_t>(alignment);
@@ -116,6 +198,11 @@ __UTL_HIDE_FROM_ABI inline void* allocate(size_t size, size_t alignment = defaul
         UTL_BUILTIN_unreachable();
 #endif
     }
+#if UTL_THREAD_CACHING_ALLOCATOR
+    if (is_small_allocation(size, alignment)) {
+        return allocate_small(size);
+    }
+#endif
     (void)alignment;
     return __UTL_ALLOC_NEW(size);
 }
@@ -0,0 +1,282 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/assert/utl_assert.h"
+#include "utl/atomic/utl_atomic.h"
+#include "utl/memory/utl_intrusive_ptr.h"
+#include "utl/memory/utl_tagged_ptr.h"
+#include "utl/type_traits/utl_constants.h"
+#include "utl/type_traits/utl_declval.h"
+
+#include <stdint.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace details {
+namespace atomic_intrusive_ptr {
+
+// The local count of a 64-bit slot is kept in the 16 bits above a 48-bit address; targets whose
+// addresses may use those bits are rejected here instead of relying on the `UTL_ASSERT` in `adopt`
+static_assert(sizeof(void*) != 8 || UTL_POINTER_ADDRESS_BITS == 48,
+    "atomic_intrusive_ptr requires 48-bit user-space addresses on 64-bit targets");
+
+template <typename T>
+__UTL_HIDE_FROM_ABI auto has_bulk_count_impl(int) noexcept -> always_true_type<decltype(
+    increment(__UTL declval<T&>(), 1), decrement(__UTL declval<T&>(), 1))>;
+template <typename T>
+__UTL_HIDE_FROM_ABI auto has_bulk_count_impl(float) noexcept -> false_type;
+
+template <typename T>
+using has_bulk_count UTL_NODEBUG = decltype(has_bulk_count_impl<T>(0));
+
+template <typename T>
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) inline void add_references(T& obj, int count, true_type) noexcept {
+    increment(obj, count);
+}
+
+template <typename T>
+__UTL_HIDE_FROM_ABI void add_references(T& obj, int count, false_type) noexcept {
+    for (; count != 0; --count) {
+        increment(obj);
+    }
+}
+
+/**
+ * The caller must hold a reference besides the ones being dropped unless `count` covers all of them
+ */
+template <typename T>
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) inline void drop_references(T& obj, int count, true_type) noexcept {
+    decrement(obj, count);
+}
+
+template <typename T>
+__UTL_HIDE_FROM_ABI void drop_references(T& obj, int count, false_type) noexcept {
+    for (; count != 0; --count) {
+        decrement(obj);
+    }
+}
+
+} // namespace atomic_intrusive_ptr
+} // namespace details
+
+/**
+ * An atomic slot holding an `intrusive_ptr`.
+ *
+ * The slot packs the object pointer and a local count of the references handed out by `load` into
+ * a single word, the unused upper bits of a pointer on 64-bit targets. Storing an object prepays a
+ * batch of references in the object's own count; a load takes one of them with a single
+ * compare-and-swap on the slot and never touches the object's count, except for the load that
+ * consumes half of the batch, which tops it up. Replacing the object returns the references the
+ * slot did not hand out.
+ *
+ * Object types that provide `increment(T&, int)` and `decrement(T&, int)`, such as those derived
+ * from `atomic_reference_count`, pay for a batch with a single atomic operation, others fall back
+ * to one increment per reference and a much smaller batch.
+ *
+ * @tparam T The type of the managed object, its reference count must be thread-safe.
+ */
+template <typename T>
+class __UTL_PUBLIC_TEMPLATE atomic_intrusive_ptr {
+    using word_type = uint64_t;
+    using bulk_count UTL_NODEBUG = details::atomic_intrusive_ptr::has_bulk_count<T>;
+
+    static constexpr unsigned int count_shift = sizeof(T*) == 8 ? 48 : 32;
+    static constexpr word_type pointer_mask = (word_type(1) << count_shift) - 1;
+    static constexpr word_type one = word_type(1) << count_shift;
+    /**
+     * Number of references prepaid for each object stored, the count never exceeds it; kept small
+     * when every reference has to be paid for individually
+     */
+    static constexpr int batch = bulk_count::value ? 1 << 13 : 1 << 6;
+    static_assert((batch & (batch - 1)) == 0, "batch must be a power of 2");
+    static constexpr int refill_at = batch / 2;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, CONST) static T* pointer_of(word_type word) noexcept {
+        return reinterpret_cast<T*>(static_cast<uintptr_t>(word & pointer_mask));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, CONST) static int count_of(word_type word) noexcept {
+        return static_cast<int>(word >> count_shift);
+    }
+
+    /**
+     * Converts an owned reference into the slot's representation, prepaying its batch
+     */
+    __UTL_HIDE_FROM_ABI static word_type adopt(intrusive_ptr<T>&& ptr) noexcept {
+        T* const object = ptr.release();
+        if (object == nullptr) {
+            return 0;
+        }
+
+        auto const word = static_cast<word_type>(reinterpret_cast<uintptr_t>(object));
+        UTL_ASSERT((word & ~pointer_mask) == 0);
+        details::atomic_intrusive_ptr::add_references(*object, batch, bulk_count{});
+        return word;
+    }
+
+    /**
+     * Returns the references a slot value did not hand out, keeping the slot's own reference
+     */
+    __UTL_HIDE_FROM_ABI static intrusive_ptr<T> unwind(word_type word) noexcept {
+        T* const object = pointer_of(word);
+        if (object == nullptr) {
+            return intrusive_ptr<T>();
+        }
+
+        details::atomic_intrusive_ptr::drop_references(
+            *object, batch - count_of(word), bulk_count{});
+        return intrusive_ptr<T>(adopt_object, object);
+    }
+
+public:
+    /**
+     * Constructs an empty slot.
+     */
+    __UTL_HIDE_FROM_ABI constexpr atomic_intrusive_ptr() noexcept : word_(0) {}
+    __UTL_HIDE_FROM_ABI constexpr atomic_intrusive_ptr(decltype(nullptr)) noexcept : word_(0) {}
+
+    /**
+     * Constructs a slot holding the object owned by `ptr`.
+     */
+    __UTL_HIDE_FROM_ABI explicit atomic_intrusive_ptr(intrusive_ptr<T> ptr) noexcept
+        : word_(adopt(static_cast<intrusive_ptr<T>&&>(ptr))) {}
+
+    atomic_intrusive_ptr(atomic_intrusive_ptr const&) = delete;
+    atomic_intrusive_ptr& operator=(atomic_intrusive_ptr const&) = delete;
+
+    __UTL_HIDE_FROM_ABI ~atomic_intrusive_ptr() noexcept { unwind(word_); }
+
+    /**
+     * Takes a new reference to the stored object.
+     *
+     * Lock-free unless `batch / 2` loads complete while a top-up is in progress, in which case
+     * the load waits for it to finish.
+     *
+     * @return An intrusive_ptr sharing ownership of the stored object
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) intrusive_ptr<T> load() const noexcept {
+        word_type word = atomic_relaxed::load(&word_);
+        for (;;) {
+            if (pointer_of(word) == nullptr) {
+                return intrusive_ptr<T>();
+            }
+
+            if (count_of(word) == batch) {
+                word = atomic_relaxed::load(&word_);
+            } else if (atomic_acquire::compare_exchange_weak(
+                           &word_, &word, word + one, atomics::relaxed_failure)) {
+                return acquired(word);
+            }
+        }
+    }
+
+    /**
+     * Replaces the stored object.
+     *
+     * @param desired The object to store.
+     */
+    __UTL_HIDE_FROM_ABI void store(intrusive_ptr<T> desired) noexcept {
+        word_type const word = adopt(static_cast<intrusive_ptr<T>&&>(desired));
+        unwind(atomic_acq_rel::exchange(&word_, word));
+    }
+
+    /**
+     * Replaces the stored object.
+     *
+     * @param desired The object to store.
+     *
+     * @return The previously stored object
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) intrusive_ptr<T> exchange(intrusive_ptr<T> desired) noexcept {
+        word_type const word = adopt(static_cast<intrusive_ptr<T>&&>(desired));
+        return unwind(atomic_acq_rel::exchange(&word_, word));
+    }
+
+    /**
+     * Replaces the stored object if it is the one owned by `expected`.
+     *
+     * @param expected The object expected to be stored, receives the object that failed the
+     * comparison on failure, which is never the one it held.
+     * @param desired The object to store.
+     *
+     * @return `true` if the object was replaced, `false` otherwise
+     */
+    __UTL_HIDE_FROM_ABI bool compare_exchange_strong(
+        intrusive_ptr<T>& expected, intrusive_ptr<T> desired) noexcept {
+        T* const object = desired.get();
+        word_type const replacement = adopt(static_cast<intrusive_ptr<T>&&>(desired));
+        word_type word = atomic_relaxed::load(&word_);
+        for (;;) {
+            if (pointer_of(word) == expected.get()) {
+                if (atomic_acq_rel::compare_exchange_weak(
+                        &word_, &word, replacement, atomics::relaxed_failure)) {
+                    unwind(word);
+                    return true;
+                }
+
+                continue;
+            }
+
+            // The reference handed back is taken from the same slot value the comparison failed
+            // on, reloading could observe `expected` again if it was stored back in between
+            if (pointer_of(word) == nullptr) {
+                expected = intrusive_ptr<T>();
+                break;
+            }
+
+            if (count_of(word) == batch) {
+                word = atomic_relaxed::load(&word_);
+            } else if (atomic_acquire::compare_exchange_weak(
+                           &word_, &word, word + one, atomics::relaxed_failure)) {
+                expected = acquired(word);
+                break;
+            }
+        }
+
+        if (object != nullptr) {
+            details::atomic_intrusive_ptr::drop_references(*object, batch + 1, bulk_count{});
+        }
+
+        return false;
+    }
+
+private:
+    /**
+     * Wraps the reference taken by incrementing the count of the slot value `word`
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) intrusive_ptr<T> acquired(
+        word_type word) const noexcept {
+        T* const object = pointer_of(word);
+        // Taking the unit at either half of the batch schedules a top-up, so one is always pending
+        // for each half consumed and the loads waiting on a full count are eventually released
+        if (((count_of(word) + 1) & (refill_at - 1)) == 0) {
+            refill(object);
+        }
+
+        return intrusive_ptr<T>(adopt_object, object);
+    }
+
+    /**
+     * Tops up the references prepaid for `object`, the caller holds one of them
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NOINLINE) void refill(T* object) const noexcept {
+        details::atomic_intrusive_ptr::add_references(*object, refill_at, bulk_count{});
+        word_type word = atomic_relaxed::load(&word_);
+        while (pointer_of(word) == object && count_of(word) >= refill_at) {
+            // Release so that readers taking the returned units observe the top-up
+            if (atomic_release::compare_exchange_weak(
+                    &word_, &word, word - refill_at * one, atomics::relaxed_failure)) {
+                return;
+            }
+        }
+
+        details::atomic_intrusive_ptr::drop_references(*object, refill_at, bulk_count{});
+    }
+
+    mutable word_type word_;
+};
+
+UTL_NAMESPACE_END
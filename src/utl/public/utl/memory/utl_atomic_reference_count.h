@@ -5,7 +5,7 @@
 #include "utl/utl_config.h"
 
 #include "utl/assert/utl_assert.h"
-#include "utl/atomic.h"
+#include "utl/atomic/utl_atomic.h"
 #include "utl/memory/utl_addressof.h"
 #include "utl/memory/utl_reference_counting_destroy.h"
 
@@ -55,7 +55,7 @@ private:
      */
     __UTL_HIDE_FROM_ABI friend void increment(T& obj) noexcept {
         static_assert(UTL_TRAIT_is_base_of(atomic_reference_count, T), "Invalid type relation");
-        ((atomic_reference_count&)obj).count_.fetch_add(1, __UTL memory_order_relaxed);
+        atomic_relaxed::fetch_add(&((atomic_reference_count&)obj).count_, 1);
     }
 
     /**
@@ -65,18 +65,43 @@ private:
      */
     __UTL_HIDE_FROM_ABI friend void decrement(T& obj) noexcept {
         static_assert(UTL_TRAIT_is_base_of(atomic_reference_count, T), "Invalid type relation");
-        int const result =
-            ((atomic_reference_count&)obj).count_.fetch_sub(1, __UTL memory_order_acq_rel);
+        int const result = atomic_acq_rel::fetch_sub(&((atomic_reference_count&)obj).count_, 1);
         if (result <= 1) {
             UTL_ASSERT(result > 0);
             reference_counting::destroy(__UTL addressof(obj));
         }
     }
 
+    /**
+     * ADL function to add several references at once for objects of type T.
+     *
+     * @param obj The object of type T to increment the count for.
+     * @param count The number of references to add.
+     */
+    __UTL_HIDE_FROM_ABI friend void increment(T& obj, int count) noexcept {
+        static_assert(UTL_TRAIT_is_base_of(atomic_reference_count, T), "Invalid type relation");
+        atomic_relaxed::fetch_add(&((atomic_reference_count&)obj).count_, count);
+    }
+
+    /**
+     * ADL function to drop several references at once for objects of type T.
+     *
+     * @param obj The object of type T to decrement the count for.
+     * @param count The number of references to drop.
+     */
+    __UTL_HIDE_FROM_ABI friend void decrement(T& obj, int count) noexcept {
+        static_assert(UTL_TRAIT_is_base_of(atomic_reference_count, T), "Invalid type relation");
+        int const result = atomic_acq_rel::fetch_sub(&((atomic_reference_count&)obj).count_, count);
+        if (result <= count) {
+            UTL_ASSERT(result == count);
+            reference_counting::destroy(__UTL addressof(obj));
+        }
+    }
+
     /**
      * Reference count for the object
      */
-    atomic<int> count_;
+    int count_;
 };
 
 UTL_NAMESPACE_END
@@ -0,0 +1,222 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/atomic/utl_atomic.h"
+#include "utl/exception/utl_exception_base.h"
+#include "utl/memory/utl_addressof.h"
+#include "utl/memory/utl_reference_counting_destroy.h"
+
+#include <stdint.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace details {
+namespace biased_reference_count {
+
+class counter;
+
+/**
+ * Per-thread record shared by the objects a thread created
+ */
+struct owner {
+    /** Objects queued for merging by other threads, or `closed` once the thread has exited */
+    counter* deferred;
+    /** One for the thread while it runs plus one per live object it owns */
+    intptr_t references;
+};
+
+/**
+ * Type-erased state of a biased reference count
+ *
+ * `shared` holds the references counted by other threads shifted by `count_shift`, it goes
+ * negative when references taken by the owner are released elsewhere. The low bits flag that the
+ * owner's references have been merged into it and that the object is waiting in its owner's queue
+ * to be merged; an object is destroyed when the value drops to exactly `merged_flag`.
+ */
+class counter {
+public:
+    static constexpr intptr_t merged_flag = 1;
+    static constexpr intptr_t queued_flag = 2;
+    static constexpr unsigned int count_shift = 2;
+    static constexpr intptr_t one = intptr_t(1) << count_shift;
+
+    __UTL_HIDE_FROM_ABI explicit counter(owner* o, void (*destroy)(counter*)) noexcept
+        : owner_(o)
+        , next_(nullptr)
+        , destroy_(destroy)
+        , shared_(0)
+        , biased_(1) {}
+
+    counter(counter const&) = delete;
+    counter& operator=(counter const&) = delete;
+
+    /** Creating thread, never reused while an object refers to it */
+    owner* owner_;
+    /** Link in the owner's merge queue */
+    counter* next_;
+    void (*destroy_)(counter*);
+    intptr_t shared_;
+    /** References counted by the owner without atomics, negative once merged */
+    int biased_;
+};
+
+/**
+ * Record of the calling thread, null until it first creates an object
+ */
+template <typename = void>
+struct current_thread {
+    static thread_local owner* record;
+};
+
+template <typename T>
+thread_local owner* current_thread<T>::record = nullptr;
+
+/**
+ * @return The record of the calling thread with an additional reference held by the caller
+ */
+__UTL_ABI_PUBLIC owner* acquire_current() UTL_THROWS;
+
+__UTL_ABI_PUBLIC void release(owner* record) noexcept;
+
+/**
+ * Slow path of a release by another thread that left the shared count negative, hands the object
+ * over to its owner or merges it if the owner has exited
+ */
+__UTL_ABI_PUBLIC void defer(counter* ctr) noexcept;
+
+/**
+ * Slow path of the owner dropping its last biased reference
+ */
+__UTL_ABI_PUBLIC void unbias(counter* ctr) noexcept;
+
+__UTL_ABI_PUBLIC void merge_deferred(owner* record) noexcept;
+
+/**
+ * @return `true` if other threads queued objects for `record` to merge
+ */
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) inline bool has_deferred(owner* record) noexcept {
+    return atomic_relaxed::load(&record->deferred) != nullptr;
+}
+
+} // namespace biased_reference_count
+} // namespace details
+
+/**
+ * A thread-safe reference count base class that avoids atomic operations on the creating thread.
+ *
+ * Biased reference counting, see "Biased Reference Counting: Minimizing Atomic Operations in
+ * Garbage Collection" by Jiho Choi, Thomas Shull and Josep Torrellas. The thread that constructs
+ * the object owns it and counts its references with plain increments, every other thread uses an
+ * atomic shared count. When the owner drops its last reference both counts are merged and the
+ * object behaves like an `atomic_reference_count` from then on.
+ *
+ * A reference taken by the owner and released on another thread drives the shared count negative;
+ * such objects are queued back to their owner, which merges them when it next releases a reference,
+ * calls `reference_counting::merge_deferred` or exits.
+ *
+ * @tparam T - The type of the class inheriting biased_reference_count, with the same requirements
+ *           as `atomic_reference_count`
+ */
+template <typename T>
+class __UTL_PUBLIC_TEMPLATE biased_reference_count : private details::biased_reference_count::counter {
+    using counter_type UTL_NODEBUG = details::biased_reference_count::counter;
+
+public:
+    /**
+     * The type of the value managed by biased_reference_count.
+     */
+    using value_type = T;
+
+protected:
+    /**
+     * Constructs the biased_reference_count object with an initial count of 1 owned by the calling
+     * thread.
+     *
+     * @throws If the calling thread's record could not be allocated
+     */
+    __UTL_HIDE_FROM_ABI biased_reference_count() UTL_THROWS
+        : counter_type(details::biased_reference_count::acquire_current(), &destroy_erased) {}
+
+    __UTL_HIDE_FROM_ABI ~biased_reference_count() noexcept {
+        details::biased_reference_count::release(this->owner_);
+    }
+
+    /**
+     * Copy and move operations are deleted to enforce non-copyability and non-movability
+     */
+    biased_reference_count(biased_reference_count const&) = delete;
+    biased_reference_count& operator=(biased_reference_count const&) = delete;
+    biased_reference_count(biased_reference_count&&) noexcept = delete;
+    biased_reference_count& operator=(biased_reference_count&&) noexcept = delete;
+
+private:
+    __UTL_HIDE_FROM_ABI static void destroy_erased(counter_type* ctr) noexcept {
+        reference_counting::destroy(
+            static_cast<T*>(static_cast<biased_reference_count*>(ctr)));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) bool is_biased() const noexcept {
+        return this->owner_ == details::biased_reference_count::current_thread<>::record &&
+            this->biased_ > 0;
+    }
+
+    /**
+     * ADL function to increment the reference count for objects of type T.
+     *
+     * @param obj The object of type T to increment the count for.
+     */
+    __UTL_HIDE_FROM_ABI friend void increment(T& obj) noexcept {
+        static_assert(UTL_TRAIT_is_base_of(biased_reference_count, T), "Invalid type relation");
+        auto& self = (biased_reference_count&)obj;
+        if (self.is_biased()) {
+            ++self.biased_;
+        } else {
+            atomic_relaxed::fetch_add(&self.shared_, one);
+        }
+    }
+
+    /**
+     * ADL function to decrement the reference count for objects of type T.
+     *
+     * @param obj The object of type T to decrement the count for.
+     */
+    __UTL_HIDE_FROM_ABI friend void decrement(T& obj) noexcept {
+        static_assert(UTL_TRAIT_is_base_of(biased_reference_count, T), "Invalid type relation");
+        auto& self = (biased_reference_count&)obj;
+        if (self.is_biased()) {
+            auto const record = self.owner_;
+            if (--self.biased_ == 0) {
+                details::biased_reference_count::unbias(&self);
+            }
+
+            if (details::biased_reference_count::has_deferred(record)) {
+                details::biased_reference_count::merge_deferred(record);
+            }
+
+            return;
+        }
+
+        intptr_t const result = atomic_acq_rel::fetch_sub(&self.shared_, one) - one;
+        if (result == merged_flag) {
+            reference_counting::destroy(__UTL addressof(obj));
+        } else if (result < 0 && !(result & (merged_flag | queued_flag))) {
+            details::biased_reference_count::defer(&self);
+        }
+    }
+};
+
+namespace reference_counting {
+/**
+ * Merges the objects owned by the calling thread whose last references were released by other
+ * threads, destroying those that are no longer referenced
+ *
+ * Owners merge on their own whenever they release a biased reference; threads that hold on to
+ * their references for long periods should call this at regular points instead.
+ */
+__UTL_ABI_PUBLIC void merge_deferred() noexcept;
+} // namespace reference_counting
+
+UTL_NAMESPACE_END
@@ -0,0 +1,102 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/compare/utl_pointer_comparable.h"
+#include "utl/memory/utl_addressof.h"
+#include "utl/memory/utl_intrusive_ptr.h"
+
+UTL_NAMESPACE_BEGIN
+
+/**
+ * Observer pointer class (non-owning) for intrusive reference-counted objects.
+ *
+ * Passing a borrowed_ptr instead of an `intrusive_ptr` lets a callee use the object without
+ * touching its reference count; the caller's reference keeps the object alive for the duration of
+ * the call. A callee that needs to extend the object's lifetime calls `retain` to obtain a new
+ * owning reference.
+ *
+ * @tparam T The type of the observed object.
+ */
+template <typename T>
+class __UTL_PUBLIC_TEMPLATE borrowed_ptr : private pointer_comparable<borrowed_ptr<T>> {
+public:
+    /**
+     * Default constructor.
+     * Constructs a borrowed_ptr with a null pointer.
+     */
+    __UTL_HIDE_FROM_ABI constexpr borrowed_ptr() noexcept : ptr_(nullptr) {}
+    __UTL_HIDE_FROM_ABI constexpr borrowed_ptr(decltype(nullptr)) noexcept : ptr_(nullptr) {}
+
+    /**
+     * Borrows the object owned by an intrusive_ptr.
+     *
+     * @param owner The intrusive_ptr that must outlive the borrowed_ptr.
+     */
+    __UTL_HIDE_FROM_ABI constexpr borrowed_ptr(intrusive_ptr<T> const& owner UTL_LIFETIMEBOUND) noexcept
+        : ptr_(owner.get()) {}
+
+    /**
+     * Borrows an object kept alive by a reference held elsewhere.
+     *
+     * @param ptr A pointer to the object.
+     */
+    __UTL_HIDE_FROM_ABI constexpr explicit borrowed_ptr(T* ptr) noexcept : ptr_(ptr) {}
+
+    /**
+     * Borrows an object kept alive by a reference held elsewhere.
+     *
+     * @param ref A reference to the object.
+     */
+    __UTL_HIDE_FROM_ABI constexpr explicit borrowed_ptr(T& ref) noexcept
+        : ptr_(__UTL addressof(ref)) {}
+
+    /**
+     * Default copy operation
+     */
+    constexpr borrowed_ptr(borrowed_ptr const&) noexcept = default;
+    UTL_CONSTEXPR_CXX14 borrowed_ptr& operator=(borrowed_ptr const&) noexcept = default;
+
+    /**
+     * Dereference operators to access the object pointed to by the borrowed_ptr.
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE) constexpr T* operator->() const noexcept {
+        return ptr_;
+    }
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE) constexpr T& operator*() const noexcept { return *ptr_; }
+
+    /**
+     * Returns the underlying raw pointer.
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE) constexpr T* get() const noexcept { return ptr_; }
+
+    /**
+     * Conversion operator to convert borrowed_ptr to boolean indicating non-nullness.
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE) constexpr explicit operator bool() const noexcept {
+        return ptr_ != nullptr;
+    }
+
+    /**
+     * Takes a new reference to the observed object.
+     *
+     * @return An intrusive_ptr sharing ownership of the object, or null if nothing is borrowed
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) UTL_CONSTEXPR_CXX14 intrusive_ptr<T> retain() const noexcept {
+        return ptr_ != nullptr ? intrusive_ptr<T>(retain_object, ptr_) : intrusive_ptr<T>();
+    }
+
+private:
+    T* ptr_;
+};
+
+#if UTL_CXX17
+template <typename T>
+borrowed_ptr(intrusive_ptr<T> const&) -> borrowed_ptr<T>;
+template <typename T>
+explicit borrowed_ptr(T* p) -> borrowed_ptr<T>;
+#endif
+
+UTL_NAMESPACE_END
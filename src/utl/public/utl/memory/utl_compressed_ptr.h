@@ -0,0 +1,127 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/assert/utl_assert.h"
+#include "utl/bit/utl_countr_zero.h"
+#include "utl/memory/utl_addressof.h"
+
+#include <stdint.h>
+
+UTL_NAMESPACE_BEGIN
+
+/**
+ * A 32-bit pointer to an object inside an arena.
+ *
+ * The pointer is stored as the distance from the start of the arena in units of `alignof(T)`, so
+ * an arena of up to `4 GiB * alignof(T)` can be addressed with half the storage of a native
+ * pointer; nodes of trees, lists and hash tables allocated from one arena shrink accordingly. The
+ * null pointer is represented by 0, so zero-initialized memory holds null pointers.
+ *
+ * The arena is a type providing a static `base()` function that returns the start of the region
+ * the objects are allocated from; the base must not change while pointers into the arena exist.
+ * The alignment is only required when the pointer is converted, so T may be incomplete where the
+ * `compressed_ptr` is declared.
+ *
+ * @tparam T The type of the object pointed to.
+ * @tparam Arena The type providing the base address of the arena.
+ */
+template <typename T, typename Arena>
+class __UTL_PUBLIC_TEMPLATE compressed_ptr {
+public:
+    using element_type = T;
+    using difference_type = decltype((char*)(0) - (char*)(0));
+    using offset_type = uint32_t;
+    template <typename U>
+    using rebind = compressed_ptr<U, Arena>;
+
+    __UTL_HIDE_FROM_ABI constexpr compressed_ptr() noexcept : offset_(0) {}
+    __UTL_HIDE_FROM_ABI constexpr compressed_ptr(decltype(nullptr)) noexcept : offset_(0) {}
+
+    /**
+     * @param ptr A null pointer or a pointer into the arena aligned to `alignof(T)`
+     */
+    __UTL_HIDE_FROM_ABI explicit compressed_ptr(T* ptr) noexcept : offset_(encode(ptr)) {}
+
+    constexpr compressed_ptr(compressed_ptr const&) noexcept = default;
+    UTL_CONSTEXPR_CXX14 compressed_ptr& operator=(compressed_ptr const&) noexcept = default;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, ALWAYS_INLINE) static compressed_ptr pointer_to(
+        T& ref) noexcept {
+        return compressed_ptr(__UTL addressof(ref));
+    }
+
+    /**
+     * Reconstructs a pointer from its offset, e.g. after an atomic load.
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, ALWAYS_INLINE)
+    static constexpr compressed_ptr from_offset(offset_type offset) noexcept {
+        return compressed_ptr(offset, offset_tag{});
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE, ALWAYS_INLINE)
+    constexpr offset_type offset() const noexcept {
+        return offset_;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE, ALWAYS_INLINE) T* get() const noexcept {
+        if (offset_ == 0) {
+            return nullptr;
+        }
+
+        return reinterpret_cast<T*>(
+            base() + (static_cast<uintptr_t>(offset_ - 1) << alignment_bits()));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE) T& operator*() const noexcept { return *get(); }
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE) T* operator->() const noexcept { return get(); }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE)
+    constexpr explicit operator bool() const noexcept {
+        return offset_ != 0;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, ALWAYS_INLINE) friend constexpr bool operator==(
+        compressed_ptr const& l, compressed_ptr const& r) noexcept {
+        return l.offset_ == r.offset_;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, ALWAYS_INLINE) friend constexpr bool operator!=(
+        compressed_ptr const& l, compressed_ptr const& r) noexcept {
+        return l.offset_ != r.offset_;
+    }
+
+private:
+    struct offset_tag {};
+
+    __UTL_HIDE_FROM_ABI constexpr compressed_ptr(offset_type offset, offset_tag) noexcept
+        : offset_(offset) {}
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, CONST, ALWAYS_INLINE)
+    static constexpr unsigned int alignment_bits() noexcept {
+        return static_cast<unsigned int>(__UTL countr_zero(alignof(T)));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, PURE, ALWAYS_INLINE) static uintptr_t base() noexcept {
+        return reinterpret_cast<uintptr_t>(Arena::base());
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) static offset_type encode(T* ptr) noexcept {
+        if (ptr == nullptr) {
+            return 0;
+        }
+
+        uintptr_t const address = reinterpret_cast<uintptr_t>(ptr);
+        UTL_ASSERT(address >= base(), "Pointer is outside of the arena");
+        uintptr_t const distance = address - base();
+        UTL_ASSERT((distance & (alignof(T) - 1)) == 0, "Pointer is not sufficiently aligned");
+        UTL_ASSERT((distance >> alignment_bits()) < UINT32_MAX, "Pointer is outside of the arena");
+        return static_cast<offset_type>((distance >> alignment_bits()) + 1);
+    }
+
+    offset_type offset_;
+};
+
+UTL_NAMESPACE_END
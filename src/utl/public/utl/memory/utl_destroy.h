@@ -0,0 +1,74 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/iterator/utl_iterator_traits_fwd.h"
+
+#include "utl/iterator/utl_iterator_traits.h"
+#include "utl/memory/utl_addressof.h"
+#include "utl/memory/utl_destroy_at.h"
+#include "utl/type_traits/utl_constants.h"
+#include "utl/type_traits/utl_is_pointer.h"
+#include "utl/type_traits/utl_is_trivially_destructible.h"
+
+UTL_NAMESPACE_BEGIN
+
+namespace details {
+namespace destroy {
+
+/**
+ * Whether destroying the objects of a range can be skipped entirely
+ */
+template <typename It>
+using is_trivial UTL_NODEBUG = bool_constant<UTL_TRAIT_is_pointer(It) &&
+    UTL_TRAIT_is_trivially_destructible(typename iterator_traits<It>::value_type)>;
+
+template <typename It>
+__UTL_HIDE_FROM_ABI inline void range(It, It, true_type) noexcept {}
+
+template <typename It>
+__UTL_HIDE_FROM_ABI inline void range(It first, It last, false_type) noexcept {
+    for (; first != last; ++first) {
+        __UTL destroy_at(__UTL addressof(*first));
+    }
+}
+
+template <typename It, typename Size>
+__UTL_HIDE_FROM_ABI inline It count(It first, Size n, true_type) noexcept {
+    return first + n;
+}
+
+template <typename It, typename Size>
+__UTL_HIDE_FROM_ABI inline It count(It first, Size n, false_type) noexcept {
+    for (; n > 0; --n, ++first) {
+        __UTL destroy_at(__UTL addressof(*first));
+    }
+
+    return first;
+}
+
+} // namespace destroy
+} // namespace details
+
+/**
+ * Destroys the objects of `[first, last)`, trivially destructible objects in contiguous ranges
+ * are left untouched.
+ */
+template <typename It>
+__UTL_HIDE_FROM_ABI inline void destroy(It first, It last) noexcept {
+    details::destroy::range(first, last, details::destroy::is_trivial<It>{});
+}
+
+/**
+ * Destroys the `n` objects starting at `first`
+ *
+ * @return The end of the destroyed range
+ */
+template <typename It, typename Size>
+__UTL_HIDE_FROM_ABI inline It destroy_n(It first, Size n) noexcept {
+    return details::destroy::count(first, n, details::destroy::is_trivial<It>{});
+}
+
+UTL_NAMESPACE_END
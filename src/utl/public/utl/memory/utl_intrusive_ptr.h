@@ -4,12 +4,12 @@
 
 #include "utl/utl_config.h"
 
-#include "utl/atomic.h"
 #include "utl/compare/utl_pointer_comparable.h"
 #include "utl/exception/utl_program_exception.h"
 #include "utl/memory/utl_addressof.h"
-#include "utl/memory/utl_reference_counter.h"
-#include "utl/type_traits/declval.h"
+#include "utl/type_traits/utl_declval.h"
+#include "utl/type_traits/utl_is_trivially_relocatable.h"
+#include "utl/type_traits/utl_remove_const.h"
 #include "utl/utility/utl_exchange.h"
 #include "utl/utility/utl_forward.h"
 
@@ -345,4 +345,7 @@ __UTL_HIDE_FROM_ABI UTL_CONSTEXPR_CXX20 intrusive_ptr<T> make_intrusive_ptr(Args
     return intrusive_ptr<T>(adopt_object, new object_type(forward<Args>(args)...));
 }
 
+template <typename T>
+struct __UTL_PUBLIC_TEMPLATE is_trivially_relocatable<intrusive_ptr<T>> : true_type {};
+
 UTL_NAMESPACE_END
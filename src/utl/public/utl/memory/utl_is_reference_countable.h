@@ -14,8 +14,8 @@ UTL_NAMESPACE_BEGIN
  * Type trait to determine if a type is reference countable.
  *
  * This type trait determines whether a given type `T` supports reference counting. It checks
- * if `T` is either derived from `atomic_reference_count`, derived from `reference_count`, or
- * if `T` itself is `atomic_reference_count` or `reference_count`.
+ * if `T` is derived from `atomic_reference_count`, `reference_count` or `biased_reference_count`,
+ * or if `T` itself is one of them.
  *
  * @tparam T The type to be checked for reference countability.
  *
@@ -24,7 +24,8 @@ UTL_NAMESPACE_BEGIN
  */
 template <typename T>
 struct __UTL_PUBLIC_TEMPLATE is_reference_countable :
-    disjunction<is_base_of<atomic_reference_count<T>, T>, is_base_of<reference_count<T>, T>> {};
+    disjunction<is_base_of<atomic_reference_count<T>, T>, is_base_of<reference_count<T>, T>,
+        is_base_of<biased_reference_count<T>, T>> {};
 
 /**
  * Specialization of `is_reference_countable` for `atomic_reference_count`.
@@ -43,6 +44,12 @@ struct __UTL_PUBLIC_TEMPLATE is_reference_countable<atomic_reference_count<T>> :
 template <typename T>
 struct __UTL_PUBLIC_TEMPLATE is_reference_countable<reference_count<T>> : true_type {};
 
+/**
+ * Specialization of `is_reference_countable` for `biased_reference_count`.
+ */
+template <typename T>
+struct __UTL_PUBLIC_TEMPLATE is_reference_countable<biased_reference_count<T>> : true_type {};
+
 /**
  * Specialization of `is_reference_countable` for `const`-qualified types.
  *
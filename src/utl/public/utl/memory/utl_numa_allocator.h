@@ -0,0 +1,216 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/memory/utl_allocator_fwd.h"
+
+#include "utl/exception/utl_exception_base.h"
+#include "utl/exception/utl_program_exception.h"
+#include "utl/memory/utl_allocator_decl.h"
+#include "utl/memory/utl_page_allocator.h"
+#include "utl/type_traits/utl_constants.h"
+
+#include <stddef.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace numa {
+
+/**
+ * Returns the number of memory nodes of the system, 1 where NUMA is not supported
+ */
+UTL_ATTRIBUTES(_ABI_PUBLIC, NODISCARD) unsigned int node_count() noexcept;
+
+/**
+ * Returns the memory node of the CPU the calling thread is running on, 0 where NUMA is not
+ * supported
+ */
+UTL_ATTRIBUTES(_ABI_PUBLIC, NODISCARD) unsigned int current_node() noexcept;
+
+} // namespace numa
+
+/**
+ * Node placement of the memory obtained from a `numa_allocator`
+ */
+class numa_placement {
+public:
+    enum class mode : unsigned char {
+        /** On the node of the thread performing the allocation */
+        local,
+        /** Restricted to a single node */
+        bind,
+        /** Spread page by page across every node */
+        interleave
+    };
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static constexpr numa_placement local() noexcept {
+        return numa_placement(mode::local, 0);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static constexpr numa_placement on_node(
+        unsigned int node) noexcept {
+        return numa_placement(mode::bind, node);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static constexpr numa_placement interleaved() noexcept {
+        return numa_placement(mode::interleave, 0);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) constexpr mode policy() const noexcept { return mode_; }
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) constexpr unsigned int node() const noexcept {
+        return node_;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend constexpr bool operator==(
+        numa_placement const& l, numa_placement const& r) noexcept {
+        return l.mode_ == r.mode_ && l.node_ == r.node_;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend constexpr bool operator!=(
+        numa_placement const& l, numa_placement const& r) noexcept {
+        return !(l == r);
+    }
+
+private:
+    __UTL_HIDE_FROM_ABI constexpr numa_placement(mode m, unsigned int node) noexcept
+        : node_(node)
+        , mode_(m) {}
+
+    unsigned int node_;
+    mode mode_;
+};
+
+namespace details {
+namespace numa_allocator {
+
+/**
+ * Maps at least `size` bytes and applies `placement` before any page is committed
+ *
+ * @throws bad_alloc - if the mapping fails or the placement names a node that does not exist
+ */
+UTL_ATTRIBUTES(_ABI_PUBLIC, NODISCARD) allocation_result<void*, size_t> map(
+    size_t size, page_policy policy, numa_placement placement) UTL_THROWS;
+
+} // namespace numa_allocator
+} // namespace details
+
+/**
+ * An allocator placing its memory on chosen NUMA nodes.
+ *
+ * Allocations are page mappings, as with `page_allocator`, whose node policy is set before they
+ * are first touched, so the placement does not depend on which thread initializes the memory.
+ * `local` placement picks the node of the allocating thread at the time of the allocation,
+ * `on_node` pins the memory to a node and `interleaved` spreads tables shared by every socket
+ * evenly across nodes. Reallocation keeps the placement of the original allocation.
+ *
+ * The placement is part of the allocator's state: allocators only compare equal, and so only
+ * release each other's memory in containers, if they have the same placement. On systems without
+ * NUMA support the placement is ignored.
+ *
+ * @tparam T The type of the objects allocated.
+ * @tparam Policy The page size requested for each mapping.
+ */
+template <typename T, page_policy Policy = page_policy::standard>
+class __UTL_PUBLIC_TEMPLATE numa_allocator {
+    using pages_type UTL_NODEBUG = page_allocator<T, Policy>;
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = decltype((char*)(0) - (char*)(0));
+    using propagate_on_container_copy_assignment = true_type;
+    using propagate_on_container_move_assignment = true_type;
+    using propagate_on_container_swap = true_type;
+    using is_always_equal = false_type;
+
+    template <typename U>
+    struct rebind {
+        using other = numa_allocator<U, Policy>;
+    };
+
+private:
+    using pointer UTL_NODEBUG = value_type*;
+    using result_type UTL_NODEBUG = allocation_result<pointer, size_t>;
+
+public:
+    /**
+     * Constructs an allocator placing memory on the node of the allocating thread.
+     */
+    __UTL_HIDE_FROM_ABI constexpr numa_allocator() noexcept
+        : placement_(numa_placement::local()) {}
+
+    __UTL_HIDE_FROM_ABI constexpr explicit numa_allocator(numa_placement placement) noexcept
+        : placement_(placement) {}
+
+    __UTL_HIDE_FROM_ABI constexpr numa_allocator(numa_allocator const&) noexcept = default;
+    __UTL_HIDE_FROM_ABI UTL_CONSTEXPR_CXX14 numa_allocator& operator=(
+        numa_allocator const&) noexcept = default;
+
+    template <typename U>
+    __UTL_HIDE_FROM_ABI constexpr numa_allocator(numa_allocator<U, Policy> const& other) noexcept
+        : placement_(other.placement()) {}
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) constexpr numa_placement placement() const noexcept {
+        return placement_;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) result_type allocate_at_least(size_type count) UTL_THROWS {
+        UTL_THROW_IF(count > memory::max_size<T>::value,
+            bad_array_new_length(
+                UTL_MESSAGE_FORMAT("[UTL] numa_allocator operation failed, Reason=[element count "
+                                   "limit exceeded], count=[%zu], limit=[%zu]"),
+                count, memory::max_size<T>::value));
+        auto const result = details::numa_allocator::map(count * sizeof(T), Policy, placement_);
+        return {static_cast<pointer>(result.ptr), result.size / sizeof(T)};
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) pointer allocate(size_type count) UTL_THROWS {
+        return allocate_at_least(count).ptr;
+    }
+
+    __UTL_HIDE_FROM_ABI void deallocate(pointer ptr, size_type count) noexcept {
+        pages_type().deallocate(ptr, count);
+    }
+
+    /**
+     * Resizes an allocation, the pages keep their node policy when they are moved.
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) result_type reallocate_at_least(
+        result_type arg, size_type count) UTL_THROWS {
+        if (arg.ptr == nullptr) {
+            return allocate_at_least(count);
+        }
+
+        return pages_type().reallocate_at_least(arg, count);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) pointer reallocate(result_type arg, size_type count) UTL_THROWS {
+        return reallocate_at_least(arg, count).ptr;
+    }
+
+    /**
+     * Returns the physical memory backing the whole pages of `[ptr, ptr + count)` to the system.
+     */
+    __UTL_HIDE_FROM_ABI void decommit(pointer ptr, size_type count) noexcept {
+        pages_type().decommit(ptr, count);
+    }
+
+    template <typename U>
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend constexpr bool operator==(
+        numa_allocator const& l, numa_allocator<U, Policy> const& r) noexcept {
+        return l.placement() == r.placement();
+    }
+
+    template <typename U>
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend constexpr bool operator!=(
+        numa_allocator const& l, numa_allocator<U, Policy> const& r) noexcept {
+        return !(l == r);
+    }
+
+private:
+    numa_placement placement_;
+};
+
+UTL_NAMESPACE_END
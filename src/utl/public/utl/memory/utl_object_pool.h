@@ -0,0 +1,334 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/atomic/utl_atomic.h"
+#include "utl/memory/utl_allocator_decl.h"
+#include "utl/memory/utl_tagged_ptr.h"
+#include "utl/utility/utl_exchange.h"
+
+#include <new>
+#include <stdint.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace details {
+namespace object_pool {
+
+UTL_INLINE_CXX17 constexpr size_t magazine_capacity = 32;
+
+/**
+ * A fixed-size stack of free blocks, moved between threads as a unit
+ */
+struct magazine {
+    magazine* next;
+    /** Link in the depot's list of every magazine it created */
+    magazine* created_next;
+    size_t count;
+    void* blocks[magazine_capacity];
+};
+
+// The ABA tag of a 64-bit head is kept in the 16 bits above a 48-bit address, targets whose
+// addresses may use those bits would have their magazine pointers corrupted by the tag
+static_assert(sizeof(void*) != 8 || UTL_POINTER_ADDRESS_BITS == 48,
+    "object_pool requires 48-bit user-space addresses on 64-bit targets");
+
+/**
+ * Lock-free stack of magazines
+ *
+ * Magazines are never freed, so a pop may read the link of a magazine that was taken concurrently;
+ * the tag in the upper bits of the head is bumped by every exchange so that the stale link is never
+ * installed.
+ */
+class magazine_stack {
+    static constexpr unsigned int tag_shift = sizeof(void*) == 8 ? 48 : 32;
+    static constexpr uint64_t pointer_mask = (uint64_t(1) << tag_shift) - 1;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, CONST) static magazine* pointer_of(uint64_t head) noexcept {
+        return reinterpret_cast<magazine*>(static_cast<uintptr_t>(head & pointer_mask));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, CONST) static uint64_t next_head(
+        uint64_t head, magazine* top) noexcept {
+        return ((head & ~pointer_mask) + (uint64_t(1) << tag_shift)) |
+            static_cast<uint64_t>(reinterpret_cast<uintptr_t>(top));
+    }
+
+public:
+    __UTL_HIDE_FROM_ABI constexpr magazine_stack() noexcept : head_(0) {}
+
+    __UTL_HIDE_FROM_ABI void push(magazine* mag) noexcept {
+        uint64_t head = atomic_relaxed::load(&head_);
+        do {
+            atomic_relaxed::store(&mag->next, pointer_of(head));
+        } while (!atomic_release::compare_exchange_weak(
+            &head_, &head, next_head(head, mag), atomics::relaxed_failure));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) magazine* pop() noexcept {
+        uint64_t head = atomic_acquire::load(&head_);
+        while (pointer_of(head) != nullptr) {
+            magazine* const top = pointer_of(head);
+            magazine* const next = atomic_relaxed::load(&top->next);
+            if (atomic_acquire::compare_exchange_weak(
+                    &head_, &head, next_head(head, next), atomics::acquire_failure)) {
+                return top;
+            }
+        }
+
+        return nullptr;
+    }
+
+private:
+    uint64_t head_;
+};
+
+/**
+ * Magazines shared by all threads, the full list also holds the partially filled magazines of
+ * exited threads
+ */
+struct depot {
+    /**
+     * Allocates a magazine and records it in `created`, the untagged list keeps magazines and their
+     * blocks reachable for leak checkers
+     */
+    __UTL_HIDE_FROM_ABI magazine* create() noexcept {
+        auto const mag = new (::std::nothrow) magazine;
+        if (mag != nullptr) {
+            magazine* head = atomic_relaxed::load(&created);
+            do {
+                mag->created_next = head;
+            } while (!atomic_relaxed::compare_exchange_weak(
+                &created, &head, mag, atomics::relaxed_failure));
+        }
+
+        return mag;
+    }
+
+    magazine_stack full;
+    magazine_stack empty;
+    magazine* created;
+};
+
+/**
+ * Per-thread cache of two magazines, allocations and deallocations only reach the depot when both
+ * are exhausted or both are full
+ */
+struct thread_cache {
+    magazine* loaded;
+    magazine* previous;
+    bool enrolled;
+    bool closed;
+};
+
+/**
+ * Pool of blocks shared by every type with the same size and alignment
+ */
+template <size_t Size, size_t Align>
+class pool {
+    static constexpr size_t block_size = Size < sizeof(void*) ? sizeof(void*) : Size;
+
+    /**
+     * Returns the calling thread's magazines to the depot on exit, blocks released afterwards go
+     * straight back to the heap
+     */
+    struct thread_exit {
+        ~thread_exit() noexcept {
+            auto& cache = local;
+            cache.closed = true;
+            release(exchange(cache.loaded, nullptr));
+            release(exchange(cache.previous, nullptr));
+        }
+    };
+
+    __UTL_HIDE_FROM_ABI static void release(magazine* mag) noexcept {
+        if (mag == nullptr) {
+            return;
+        }
+
+        if (mag->count != 0) {
+            shared.full.push(mag);
+        } else {
+            shared.empty.push(mag);
+        }
+    }
+
+    __UTL_HIDE_FROM_ABI static void enroll(thread_cache& cache) noexcept {
+        static thread_local thread_exit registration;
+        (void)registration;
+        cache.enrolled = true;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NOINLINE) static void* allocate_slow() UTL_THROWS {
+        auto& cache = local;
+        if (!cache.closed) {
+            if (!cache.enrolled) {
+                enroll(cache);
+            }
+
+            if (cache.previous != nullptr && cache.previous->count != 0) {
+                cache.previous = exchange(cache.loaded, cache.previous);
+                return cache.loaded->blocks[--cache.loaded->count];
+            }
+
+            if (magazine* const mag = shared.full.pop()) {
+                release(exchange(cache.loaded, mag));
+                return mag->blocks[--mag->count];
+            }
+        }
+
+        return memory::details::allocate(block_size, Align);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NOINLINE) static void deallocate_slow(void* block) noexcept {
+        auto& cache = local;
+        if (cache.closed) {
+            memory::details::deallocate(block, block_size, Align);
+            return;
+        }
+
+        if (!cache.enrolled) {
+            enroll(cache);
+        }
+
+        if (cache.previous != nullptr && cache.previous->count == 0) {
+            cache.previous = exchange(cache.loaded, cache.previous);
+        } else {
+            magazine* mag = shared.empty.pop();
+            if (mag == nullptr && (mag = shared.create()) == nullptr) {
+                memory::details::deallocate(block, block_size, Align);
+                return;
+            }
+
+            mag->count = 0;
+            if (cache.loaded != nullptr) {
+                release(exchange(cache.previous, cache.loaded));
+            }
+            cache.loaded = mag;
+        }
+
+        cache.loaded->blocks[cache.loaded->count++] = block;
+    }
+
+public:
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static void* allocate() UTL_THROWS {
+        magazine* const mag = local.loaded;
+        if (mag != nullptr && mag->count != 0) {
+            return mag->blocks[--mag->count];
+        }
+
+        return allocate_slow();
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) static void deallocate(void* block) noexcept {
+        magazine* const mag = local.loaded;
+        if (mag != nullptr && mag->count != magazine_capacity) {
+            mag->blocks[mag->count++] = block;
+            return;
+        }
+
+        deallocate_slow(block);
+    }
+
+    __UTL_HIDE_FROM_ABI static void trim() noexcept {
+        while (magazine* const mag = shared.full.pop()) {
+            while (mag->count != 0) {
+                memory::details::deallocate(mag->blocks[--mag->count], block_size, Align);
+            }
+
+            shared.empty.push(mag);
+        }
+    }
+
+private:
+    static depot shared;
+    static thread_local thread_cache local;
+};
+
+template <size_t Size, size_t Align>
+depot pool<Size, Align>::shared{};
+
+template <size_t Size, size_t Align>
+thread_local thread_cache pool<Size, Align>::local{nullptr, nullptr, false, false};
+
+} // namespace object_pool
+} // namespace details
+
+/**
+ * A thread-caching pool of blocks for objects of type T.
+ *
+ * Each thread keeps two magazines of free blocks and serves allocations and deallocations from them
+ * without synchronization. When both are exhausted or both are full, the thread swaps a magazine
+ * with a global lock-free depot, so blocks freed on one thread are reused by others. Blocks are
+ * only returned to the heap by `trim`, or when released by a thread that is exiting. Types with the
+ * same size and alignment share a pool.
+ *
+ * @tparam T The type of the objects stored in the pool's blocks.
+ */
+template <typename T>
+class __UTL_PUBLIC_TEMPLATE object_pool {
+    using pool_type UTL_NODEBUG = details::object_pool::pool<sizeof(T), alignof(T)>;
+
+public:
+    object_pool() = delete;
+
+    /**
+     * Allocates uninitialized storage for one object of type T.
+     *
+     * @throws std::bad_alloc - if the pool is empty and the heap allocation fails
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static void* allocate() UTL_THROWS {
+        return pool_type::allocate();
+    }
+
+    /**
+     * Returns storage obtained from `allocate` to the pool.
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) static void deallocate(void* block) noexcept {
+        pool_type::deallocate(block);
+    }
+
+    /**
+     * Returns the blocks held by the depot to the heap, the calling thread's magazines are kept.
+     */
+    __UTL_HIDE_FROM_ABI static void trim() noexcept { pool_type::trim(); }
+};
+
+/**
+ * Base class routing the allocation of T through its `object_pool`.
+ *
+ * The class-specific allocation functions are picked up by every new- and delete-expression for T,
+ * so objects created with `make_intrusive_ptr` and released through `reference_counting::destroy`
+ * reuse pooled blocks without further changes. Types derived from T that are larger than T are
+ * allocated from the heap.
+ *
+ * @tparam T The type of the class inheriting pool_allocated.
+ */
+template <typename T>
+class __UTL_PUBLIC_TEMPLATE pool_allocated {
+public:
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static void* operator new(size_t size) UTL_THROWS {
+        if (size != sizeof(T)) {
+            return memory::details::allocate(size, alignof(T));
+        }
+
+        return object_pool<T>::allocate();
+    }
+
+    __UTL_HIDE_FROM_ABI static void operator delete(void* ptr, size_t size) noexcept {
+        if (size != sizeof(T)) {
+            memory::details::deallocate(ptr, size, alignof(T));
+            return;
+        }
+
+        object_pool<T>::deallocate(ptr);
+    }
+
+protected:
+    __UTL_HIDE_FROM_ABI constexpr pool_allocated() noexcept = default;
+    __UTL_HIDE_FROM_ABI UTL_CONSTEXPR_CXX20 ~pool_allocated() noexcept = default;
+};
+
+UTL_NAMESPACE_END
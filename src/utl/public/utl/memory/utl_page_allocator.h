@@ -0,0 +1,185 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/memory/utl_allocator_fwd.h"
+
+#include "utl/exception/utl_exception_base.h"
+#include "utl/exception/utl_program_exception.h"
+#include "utl/memory/utl_allocator_decl.h"
+#include "utl/type_traits/utl_constants.h"
+
+#include <stddef.h>
+
+UTL_NAMESPACE_BEGIN
+
+/**
+ * Page size requested for the mappings of a `page_allocator`
+ */
+enum class page_policy : unsigned char {
+    /** Base pages of the system */
+    standard,
+    /**
+     * Base pages, aligned and advised so that the kernel may back them with huge pages; equivalent
+     * to `standard` where transparent huge pages are not supported
+     */
+    transparent_huge,
+    /**
+     * Huge pages reserved by the system, falling back to `transparent_huge` if none are available
+     */
+    explicit_huge
+};
+
+namespace details {
+namespace page_allocator {
+
+/**
+ * Returns the size every mapping made with `policy` is rounded up to
+ */
+UTL_ATTRIBUTES(_ABI_PUBLIC, NODISCARD) size_t granularity(page_policy policy) noexcept;
+
+/**
+ * Reserves at least `size` bytes of zeroed memory, pages are only committed on first access
+ *
+ * @throws bad_alloc - if the mapping fails
+ */
+UTL_ATTRIBUTES(_ABI_PUBLIC, NODISCARD) allocation_result<void*, size_t> map(
+    size_t size, page_policy policy) UTL_THROWS;
+
+/**
+ * Releases a mapping obtained from `map` or `remap` with the same policy
+ */
+__UTL_ABI_PUBLIC void unmap(void* pointer, size_t size, page_policy policy) noexcept;
+
+/**
+ * Resizes a mapping, moving its pages rather than copying them where the system allows it
+ *
+ * @throws bad_alloc - if the mapping cannot be resized, the original mapping is left intact
+ */
+UTL_ATTRIBUTES(_ABI_PUBLIC, NODISCARD) allocation_result<void*, size_t> remap(
+    void* pointer, size_t old_size, size_t new_size, page_policy policy) UTL_THROWS;
+
+/**
+ * Returns the pages of `granularity(policy)` wholly contained in a range of a mapping obtained with
+ * `policy` to the system, the range stays mapped and reads back as zeros
+ */
+__UTL_ABI_PUBLIC void decommit(void* pointer, size_t size, page_policy policy) noexcept;
+
+} // namespace page_allocator
+} // namespace details
+
+/**
+ * An allocator obtaining every allocation directly from the system's virtual memory.
+ *
+ * Each allocation is a separate mapping rounded up to the page granularity of the policy, and
+ * `allocate_at_least` reports the rounded capacity back to the container. Memory is reserved
+ * without being committed so that untouched pages cost nothing; `reallocate` moves the pages of a
+ * mapping instead of copying them where the system allows it (`mremap` on Linux). Suited to large
+ * arenas and tables, where the allocation overhead is dwarfed by TLB misses, not to small objects.
+ *
+ * Since reallocation moves the bytes of the allocation, T must be trivially relocatable for
+ * `reallocate` to be used.
+ *
+ * @tparam T The type of the objects allocated.
+ * @tparam Policy The page size requested for each mapping.
+ */
+template <typename T, page_policy Policy = page_policy::standard>
+class __UTL_PUBLIC_TEMPLATE page_allocator {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = decltype((char*)(0) - (char*)(0));
+    using propagate_on_container_move_assignment = true_type;
+    using is_always_equal = true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = page_allocator<U, Policy>;
+    };
+
+private:
+    using pointer UTL_NODEBUG = value_type*;
+    using result_type UTL_NODEBUG = allocation_result<pointer, size_t>;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) static size_t bytes(size_type count) UTL_THROWS {
+        UTL_THROW_IF(count > memory::max_size<T>::value,
+            bad_array_new_length(
+                UTL_MESSAGE_FORMAT("[UTL] page_allocator operation failed, Reason=[element count "
+                                   "limit exceeded], count=[%zu], limit=[%zu]"),
+                count, memory::max_size<T>::value));
+        return count * sizeof(T);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) static result_type convert(
+        allocation_result<void*, size_t> result) noexcept {
+        return {static_cast<pointer>(result.ptr), result.size / sizeof(T)};
+    }
+
+public:
+    __UTL_HIDE_FROM_ABI constexpr page_allocator() noexcept = default;
+    __UTL_HIDE_FROM_ABI constexpr page_allocator(page_allocator const&) noexcept = default;
+    __UTL_HIDE_FROM_ABI UTL_CONSTEXPR_CXX14 page_allocator& operator=(
+        page_allocator const&) noexcept = default;
+
+    template <typename U>
+    __UTL_HIDE_FROM_ABI constexpr page_allocator(page_allocator<U, Policy> const&) noexcept {}
+
+    /**
+     * Returns the number of bytes every allocation is rounded up to.
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static size_t granularity() noexcept {
+        return details::page_allocator::granularity(Policy);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) result_type allocate_at_least(size_type count) UTL_THROWS {
+        return convert(details::page_allocator::map(bytes(count), Policy));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) pointer allocate(size_type count) UTL_THROWS {
+        return allocate_at_least(count).ptr;
+    }
+
+    /**
+     * Releases an allocation, `count` is either the requested or the reported count.
+     */
+    __UTL_HIDE_FROM_ABI void deallocate(pointer ptr, size_type count) noexcept {
+        details::page_allocator::unmap(ptr, count * sizeof(T), Policy);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) result_type reallocate_at_least(
+        result_type arg, size_type count) UTL_THROWS {
+        return convert(details::page_allocator::remap(
+            arg.ptr, arg.size * sizeof(T), bytes(count), Policy));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) pointer reallocate(result_type arg, size_type count) UTL_THROWS {
+        return reallocate_at_least(arg, count).ptr;
+    }
+
+    /**
+     * Returns the physical memory backing the whole pages of `[ptr, ptr + count)` to the system,
+     * pages being `granularity()` bytes.
+     *
+     * The range stays allocated, its pages are committed again on their next access and read back
+     * as zeros.
+     */
+    __UTL_HIDE_FROM_ABI void decommit(pointer ptr, size_type count) noexcept {
+        details::page_allocator::decommit(ptr, count * sizeof(T), Policy);
+    }
+
+    template <typename U>
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend constexpr bool operator==(
+        page_allocator const&, page_allocator<U, Policy> const&) noexcept {
+        return true;
+    }
+
+    template <typename U>
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend constexpr bool operator!=(
+        page_allocator const&, page_allocator<U, Policy> const&) noexcept {
+        return false;
+    }
+};
+
+UTL_NAMESPACE_END
@@ -10,6 +10,8 @@ template <typename T>
 class __UTL_PUBLIC_TEMPLATE atomic_reference_count;
 template <typename T>
 class __UTL_PUBLIC_TEMPLATE reference_count;
+template <typename T>
+class __UTL_PUBLIC_TEMPLATE biased_reference_count;
 
 template <typename T>
 struct __UTL_PUBLIC_TEMPLATE is_reference_countable;
@@ -0,0 +1,152 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/exception/utl_exception_base.h"
+#include "utl/memory/utl_construct_at.h"
+#include "utl/memory/utl_destroy.h"
+#include "utl/memory/utl_destroy_at.h"
+#include "utl/string/utl_libc_runtime.h"
+#include "utl/type_traits/utl_constants.h"
+#include "utl/type_traits/utl_is_nothrow_move_constructible.h"
+#include "utl/type_traits/utl_is_trivially_relocatable.h"
+#include "utl/utility/utl_move.h"
+
+UTL_NAMESPACE_BEGIN
+
+namespace details {
+namespace relocate {
+
+template <typename T>
+using is_nothrow UTL_NODEBUG = bool_constant<UTL_TRAIT_is_trivially_relocatable(T) ||
+    UTL_TRAIT_is_nothrow_move_constructible(T)>;
+
+/**
+ * Copies the representation of `count` objects, the ranges may overlap
+ */
+template <typename T>
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) inline void move_bytes(
+    T* dest, T const* source, size_t count) noexcept {
+    // T is not necessarily trivially copyable, so the objects are copied as bytes
+    __UTL libc::runtime::memmove((unsigned char*)dest, (unsigned char const*)source,
+        libc::element_count_t(count * sizeof(T)));
+}
+
+template <typename T>
+__UTL_HIDE_FROM_ABI inline T* relocate_at(T* source, T* dest, true_type) noexcept {
+    move_bytes(dest, source, 1);
+    return dest;
+}
+
+template <typename T>
+__UTL_HIDE_FROM_ABI inline T* relocate_at(T* source, T* dest, false_type) noexcept(
+    UTL_TRAIT_is_nothrow_move_constructible(T)) {
+    T* const result = __UTL construct_at(dest, __UTL move(*source));
+    __UTL destroy_at(source);
+    return result;
+}
+
+template <typename T>
+__UTL_HIDE_FROM_ABI inline T* forward(T* first, T* last, T* dest, true_type) noexcept {
+    move_bytes(dest, first, size_t(last - first));
+    return dest + (last - first);
+}
+
+template <typename T>
+__UTL_HIDE_FROM_ABI inline T* forward(T* first, T* last, T* dest, false_type) noexcept(
+    UTL_TRAIT_is_nothrow_move_constructible(T)) {
+    T* const start = dest;
+    UTL_TRY {
+        for (; first != last; ++first, ++dest) {
+            __UTL construct_at(dest, __UTL move(*first));
+            __UTL destroy_at(first);
+        }
+    } UTL_CATCH(...) {
+        __UTL destroy(start, dest);
+        __UTL destroy(first, last);
+        UTL_RETHROW();
+    }
+
+    return dest;
+}
+
+template <typename T>
+__UTL_HIDE_FROM_ABI inline T* backward(T* first, T* last, T* dest_last, true_type) noexcept {
+    move_bytes(dest_last - (last - first), first, size_t(last - first));
+    return dest_last - (last - first);
+}
+
+template <typename T>
+__UTL_HIDE_FROM_ABI inline T* backward(T* first, T* last, T* dest_last, false_type) noexcept(
+    UTL_TRAIT_is_nothrow_move_constructible(T)) {
+    T* const end = dest_last;
+    UTL_TRY {
+        for (; last != first; --last, --dest_last) {
+            __UTL construct_at(dest_last - 1, __UTL move(*(last - 1)));
+            __UTL destroy_at(last - 1);
+        }
+    } UTL_CATCH(...) {
+        __UTL destroy(dest_last, end);
+        __UTL destroy(first, last);
+        UTL_RETHROW();
+    }
+
+    return dest_last;
+}
+
+} // namespace relocate
+} // namespace details
+
+/**
+ * Relocates an object into uninitialized storage.
+ *
+ * The object at `source` is moved into `dest` and destroyed, leaving `source` as uninitialized
+ * storage. Trivially relocatable objects are copied as bytes instead.
+ *
+ * @param source The object to relocate
+ * @param dest The uninitialized storage to relocate to, must not overlap `source`
+ *
+ * @return A pointer to the relocated object
+ */
+template <typename T>
+__UTL_HIDE_FROM_ABI inline T* relocate_at(T* source, T* dest) noexcept(
+    details::relocate::is_nothrow<T>::value) {
+    return details::relocate::relocate_at(
+        source, dest, bool_constant<UTL_TRAIT_is_trivially_relocatable(T)>{});
+}
+
+/**
+ * Relocates the objects of `[first, last)` into the uninitialized storage starting at `dest`.
+ *
+ * Trivially relocatable objects are relocated with a single `memmove`, the others one at a time
+ * in increasing order, so the ranges may overlap if `dest` is before `first`. Afterwards
+ * `[first, last)` is uninitialized storage; if a move constructor throws, every object of both
+ * ranges is destroyed before the exception is propagated.
+ *
+ * @return The end of the relocated range
+ */
+template <typename T>
+__UTL_HIDE_FROM_ABI inline T* uninitialized_relocate(T* first, T* last, T* dest) noexcept(
+    details::relocate::is_nothrow<T>::value) {
+    return details::relocate::forward(
+        first, last, dest, bool_constant<UTL_TRAIT_is_trivially_relocatable(T)>{});
+}
+
+/**
+ * Relocates the objects of `[first, last)` into the uninitialized storage ending at `dest_last`.
+ *
+ * The counterpart of `uninitialized_relocate` for ranges where `dest_last` is after `last`, such
+ * as shifting elements towards the end of a buffer to make room for an insertion.
+ *
+ * @return The beginning of the relocated range
+ */
+template <typename T>
+__UTL_HIDE_FROM_ABI inline T* uninitialized_relocate_backward(T* first, T* last,
+    T* dest_last) noexcept(details::relocate::is_nothrow<T>::value) {
+    return details::relocate::backward(
+        first, last, dest_last, bool_constant<UTL_TRAIT_is_trivially_relocatable(T)>{});
+}
+
+UTL_NAMESPACE_END
@@ -0,0 +1,193 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/assert/utl_assert.h"
+#include "utl/bit/utl_countr_zero.h"
+#include "utl/memory/utl_addressof.h"
+
+#include <stdint.h>
+
+/**
+ * The number of significant bits in a user-space address. On x86-64 and AArch64 addresses are
+ * sign-extended from bit 47, which leaves the bits above it free to hold a tag.
+ */
+#ifndef UTL_POINTER_ADDRESS_BITS
+#  if UTL_ARCH_x86_64 | UTL_ARCH_AARCH64
+#    define UTL_POINTER_ADDRESS_BITS 48
+#  else
+#    define UTL_POINTER_ADDRESS_BITS (sizeof(void*) * 8)
+#  endif
+#endif
+
+UTL_NAMESPACE_BEGIN
+
+namespace details {
+namespace tagged_ptr {
+
+constexpr unsigned int word_bits = sizeof(uintptr_t) * 8;
+constexpr unsigned int address_bits = UTL_POINTER_ADDRESS_BITS;
+// Position of the high tag bits, kept below the word size so that shifts are always defined even
+// where no bits are left above the address
+constexpr unsigned int high_shift = address_bits < word_bits ? address_bits : 0;
+constexpr unsigned int extension_shift = address_bits < word_bits ? word_bits - address_bits : 0;
+
+template <typename T>
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, CONST, ALWAYS_INLINE)
+constexpr unsigned int alignment_bits() noexcept {
+    return static_cast<unsigned int>(__UTL countr_zero(alignof(T)));
+}
+
+/**
+ * Number of tag bits stored in the alignment bits of the address, the rest go above the address
+ */
+template <typename T>
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, CONST, ALWAYS_INLINE) constexpr unsigned int low_bits(
+    unsigned int bits) noexcept {
+    return bits < alignment_bits<T>() ? bits : alignment_bits<T>();
+}
+
+} // namespace tagged_ptr
+} // namespace details
+
+/**
+ * A pointer carrying a small integer tag in bits the address does not use.
+ *
+ * The tag first fills the low bits that are always zero because of the alignment of T, then the
+ * high bits that are unused by user-space addresses on 64-bit targets, so a node pointer in a
+ * lock-free structure can carry a version counter or a mark bit in a single word that is updated
+ * with one compare-and-swap through `raw` and `from_raw`. The alignment is only required when the
+ * pointer is stored, so T may be incomplete where the `tagged_ptr` is declared.
+ *
+ * @tparam T The type of the object pointed to.
+ * @tparam Bits The number of bits in the tag.
+ */
+template <typename T, unsigned int Bits>
+class __UTL_PUBLIC_TEMPLATE tagged_ptr {
+public:
+    using element_type = T;
+    using difference_type = decltype((char*)(0) - (char*)(0));
+    using tag_type = uintptr_t;
+    template <typename U>
+    using rebind = tagged_ptr<U, Bits>;
+
+    static constexpr unsigned int tag_bits = Bits;
+    static constexpr tag_type max_tag = (tag_type(1) << Bits) - 1;
+
+    __UTL_HIDE_FROM_ABI constexpr tagged_ptr() noexcept : value_(0) {}
+    __UTL_HIDE_FROM_ABI constexpr tagged_ptr(decltype(nullptr)) noexcept : value_(0) {}
+
+    /**
+     * @param ptr A pointer aligned to `alignof(T)`
+     * @param tag A value no greater than `max_tag`
+     */
+    __UTL_HIDE_FROM_ABI explicit tagged_ptr(T* ptr, tag_type tag = 0) noexcept
+        : value_(encode(ptr, tag)) {}
+
+    constexpr tagged_ptr(tagged_ptr const&) noexcept = default;
+    UTL_CONSTEXPR_CXX14 tagged_ptr& operator=(tagged_ptr const&) noexcept = default;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, ALWAYS_INLINE) static tagged_ptr pointer_to(
+        T& ref) noexcept {
+        return tagged_ptr(__UTL addressof(ref));
+    }
+
+    /**
+     * Reconstructs a tagged pointer from its representation, e.g. after an atomic load.
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, ALWAYS_INLINE) static constexpr tagged_ptr from_raw(
+        uintptr_t raw) noexcept {
+        return tagged_ptr(raw, raw_tag{});
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE, ALWAYS_INLINE) uintptr_t raw() const noexcept {
+        return value_;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE, ALWAYS_INLINE) T* get() const noexcept {
+        uintptr_t const address = value_ & ~low_mask();
+        if (high_bits() == 0) {
+            return reinterpret_cast<T*>(address);
+        }
+
+        // Restore the canonical form of the address by sign-extending its top bit
+        constexpr unsigned int shift = details::tagged_ptr::extension_shift;
+        return reinterpret_cast<T*>(static_cast<uintptr_t>(
+            static_cast<intptr_t>(address << shift) >> shift));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE, ALWAYS_INLINE) tag_type tag() const noexcept {
+        if (high_bits() == 0) {
+            return value_ & low_mask();
+        }
+
+        return (value_ & low_mask()) | ((value_ >> high_shift) << low_bits());
+    }
+
+    __UTL_HIDE_FROM_ABI void reset(T* ptr, tag_type tag = 0) noexcept { value_ = encode(ptr, tag); }
+    __UTL_HIDE_FROM_ABI void set_tag(tag_type tag) noexcept { value_ = encode(get(), tag); }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE) T& operator*() const noexcept { return *get(); }
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE) T* operator->() const noexcept { return get(); }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE) explicit operator bool() const noexcept {
+        return get() != nullptr;
+    }
+
+    /**
+     * Tagged pointers are equal if both their addresses and their tags are equal
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, ALWAYS_INLINE) friend constexpr bool operator==(
+        tagged_ptr const& l, tagged_ptr const& r) noexcept {
+        return l.value_ == r.value_;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, ALWAYS_INLINE) friend constexpr bool operator!=(
+        tagged_ptr const& l, tagged_ptr const& r) noexcept {
+        return l.value_ != r.value_;
+    }
+
+private:
+    static constexpr unsigned int address_bits = details::tagged_ptr::address_bits;
+    static constexpr unsigned int high_shift = details::tagged_ptr::high_shift;
+
+    struct raw_tag {};
+
+    __UTL_HIDE_FROM_ABI constexpr tagged_ptr(uintptr_t raw, raw_tag) noexcept : value_(raw) {}
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, CONST, ALWAYS_INLINE)
+    static constexpr unsigned int low_bits() noexcept {
+        return details::tagged_ptr::low_bits<T>(Bits);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, CONST, ALWAYS_INLINE)
+    static constexpr unsigned int high_bits() noexcept {
+        return Bits - low_bits();
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, CONST, ALWAYS_INLINE)
+    static constexpr uintptr_t low_mask() noexcept {
+        return (uintptr_t(1) << low_bits()) - 1;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) static uintptr_t encode(
+        T* ptr, tag_type tag) noexcept {
+        static_assert(high_bits() <= details::tagged_ptr::word_bits - address_bits,
+            "Tag does not fit in the unused bits of the pointer");
+        uintptr_t const address = reinterpret_cast<uintptr_t>(ptr);
+        UTL_ASSERT((address & low_mask()) == 0, "Pointer is not sufficiently aligned");
+        UTL_ASSERT(tag <= max_tag, "Tag is out of range");
+        if (high_bits() == 0) {
+            return address | tag;
+        }
+
+        uintptr_t const address_mask = (uintptr_t(1) << high_shift) - 1;
+        return (address & address_mask) | (tag & low_mask()) | ((tag >> low_bits()) << high_shift);
+    }
+
+    uintptr_t value_;
+};
+
+UTL_NAMESPACE_END
@@ -0,0 +1,148 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/memory/utl_allocator_fwd.h"
+
+#include "utl/exception/utl_exception_base.h"
+#include "utl/memory/utl_addressof.h"
+#include "utl/memory/utl_allocation_tracker.h"
+#include "utl/memory/utl_allocator.h"
+#include "utl/memory/utl_allocator_traits.h"
+#include "utl/source_location/utl_source_location.h"
+#include "utl/type_traits/utl_constants.h"
+
+UTL_NAMESPACE_BEGIN
+
+/**
+ * An allocator adaptor recording every allocation of the wrapped allocator in an
+ * `allocation_tracker`.
+ *
+ * Samples are attributed to the site where the adaptor was constructed, which for a container is
+ * where the container was given its allocator; copies and rebound copies keep the site and the
+ * tracker, so every node or buffer a container allocates is attributed to the same place.
+ * Allocators compare equal if they share a tracker and their wrapped allocators compare equal.
+ *
+ * @tparam Alloc The allocator performing the allocations.
+ */
+template <typename Alloc = allocator<unsigned char>>
+class __UTL_PUBLIC_TEMPLATE tracking_allocator {
+    using traits_type UTL_NODEBUG = allocator_traits<Alloc>;
+
+    template <typename>
+    friend class tracking_allocator;
+
+public:
+    using allocator_type = Alloc;
+    using value_type = typename traits_type::value_type;
+    using pointer = typename traits_type::pointer;
+    using size_type = typename traits_type::size_type;
+    using difference_type = typename traits_type::difference_type;
+    using propagate_on_container_copy_assignment = true_type;
+    using propagate_on_container_move_assignment = true_type;
+    using propagate_on_container_swap = true_type;
+    using is_always_equal = false_type;
+
+    template <typename U>
+    struct rebind {
+        using other = tracking_allocator<typename traits_type::template rebind_alloc<U>>;
+    };
+
+private:
+    using result_type UTL_NODEBUG = typename traits_type::allocation_result;
+
+public:
+    /**
+     * Constructs an adaptor recording into `allocation_tracker::adaptors()`.
+     *
+     * Not the global tracker, which already counts the allocations of `allocator` when
+     * `UTL_ALLOCATION_HOOKS` is enabled.
+     */
+    __UTL_HIDE_FROM_ABI tracking_allocator(source_location site = UTL_SOURCE_LOCATION()) noexcept
+        : tracker_(__UTL addressof(memory::allocation_tracker::adaptors()))
+        , site_(site) {}
+
+    __UTL_HIDE_FROM_ABI explicit tracking_allocator(memory::allocation_tracker& tracker,
+        Alloc const& alloc = Alloc(), source_location site = UTL_SOURCE_LOCATION()) noexcept
+        : alloc_(alloc)
+        , tracker_(__UTL addressof(tracker))
+        , site_(site) {}
+
+    __UTL_HIDE_FROM_ABI tracking_allocator(tracking_allocator const&) noexcept = default;
+    __UTL_HIDE_FROM_ABI tracking_allocator& operator=(tracking_allocator const&) noexcept = default;
+
+    template <typename A>
+    __UTL_HIDE_FROM_ABI tracking_allocator(tracking_allocator<A> const& other) noexcept
+        : alloc_(other.alloc_)
+        , tracker_(other.tracker_)
+        , site_(other.site_) {}
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) allocator_type const& base() const noexcept {
+        return alloc_;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) memory::allocation_tracker& tracker() const noexcept {
+        return *tracker_;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) source_location site() const noexcept { return site_; }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) pointer allocate(size_type count) UTL_THROWS {
+        pointer const result = traits_type::allocate(alloc_, count);
+        tracker_->record_allocation(count * sizeof(value_type), site_);
+        return result;
+    }
+
+    /**
+     * Records the capacity obtained rather than the one requested.
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) result_type allocate_at_least(size_type count) UTL_THROWS {
+        result_type const result = traits_type::allocate_at_least(alloc_, count);
+        tracker_->record_allocation(result.size * sizeof(value_type), site_);
+        return result;
+    }
+
+    __UTL_HIDE_FROM_ABI void deallocate(pointer ptr, size_type count) noexcept {
+        tracker_->record_deallocation(count * sizeof(value_type));
+        traits_type::deallocate(alloc_, ptr, count);
+    }
+
+    /**
+     * Recorded as the release of the old allocation followed by a new allocation.
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) result_type reallocate_at_least(
+        result_type arg, size_type count) UTL_THROWS {
+        result_type const result = traits_type::reallocate_at_least(alloc_, arg, count);
+        tracker_->record_deallocation(arg.size * sizeof(value_type));
+        tracker_->record_allocation(result.size * sizeof(value_type), site_);
+        return result;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) pointer reallocate(result_type arg, size_type count) UTL_THROWS {
+        pointer const result = traits_type::reallocate(alloc_, arg, count);
+        tracker_->record_deallocation(arg.size * sizeof(value_type));
+        tracker_->record_allocation(count * sizeof(value_type), site_);
+        return result;
+    }
+
+    template <typename A>
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend bool operator==(
+        tracking_allocator const& l, tracking_allocator<A> const& r) noexcept {
+        return l.tracker_ == __UTL addressof(r.tracker()) && l.alloc_ == r.base();
+    }
+
+    template <typename A>
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend bool operator!=(
+        tracking_allocator const& l, tracking_allocator<A> const& r) noexcept {
+        return !(l == r);
+    }
+
+private:
+    Alloc alloc_;
+    memory::allocation_tracker* tracker_;
+    source_location site_;
+};
+
+UTL_NAMESPACE_END
@@ -0,0 +1,404 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/iterator/utl_iterator_traits_fwd.h"
+
+#include "utl/exception/utl_exception_base.h"
+#include "utl/iterator/utl_iterator_traits.h"
+#include "utl/memory/utl_addressof.h"
+#include "utl/memory/utl_destroy.h"
+#include "utl/string/utl_libc_runtime.h"
+#include "utl/type_traits/utl_constants.h"
+#include "utl/type_traits/utl_is_arithmetic.h"
+#include "utl/type_traits/utl_is_enum.h"
+#include "utl/type_traits/utl_is_pointer.h"
+#include "utl/type_traits/utl_is_same.h"
+#include "utl/type_traits/utl_is_trivially_constructible.h"
+#include "utl/type_traits/utl_is_trivially_copyable.h"
+#include "utl/type_traits/utl_is_trivially_default_constructible.h"
+#include "utl/type_traits/utl_remove_cv.h"
+#include "utl/type_traits/utl_remove_pointer.h"
+#include "utl/utility/utl_move.h"
+#include "utl/utility/utl_pair.h"
+
+#include <new>
+
+UTL_NAMESPACE_BEGIN
+
+namespace details {
+namespace uninitialized {
+
+template <typename It>
+using value_type UTL_NODEBUG = typename iterator_traits<It>::value_type;
+
+/**
+ * Whether constructing the objects at `Out` from the objects at `In` is a copy of their bytes
+ *
+ * @tparam Ref The reference type the objects are constructed from
+ */
+template <typename In, typename Out, typename Ref>
+using is_bitwise UTL_NODEBUG = bool_constant<UTL_TRAIT_is_pointer(In) &&
+    UTL_TRAIT_is_pointer(Out) && UTL_TRAIT_is_same(remove_cv_t<remove_pointer_t<In>>, remove_pointer_t<Out>) &&
+    UTL_TRAIT_is_trivially_copyable(remove_pointer_t<Out>) &&
+    UTL_TRAIT_is_trivially_constructible(remove_pointer_t<Out>, Ref)>;
+
+template <typename In, typename Out>
+using is_bitwise_copy UTL_NODEBUG = is_bitwise<In, Out, remove_pointer_t<In> const&>;
+
+template <typename In, typename Out>
+using is_bitwise_move UTL_NODEBUG = is_bitwise<In, Out, remove_pointer_t<In>&&>;
+
+/**
+ * Whether filling a contiguous range with a value is a `memset`
+ */
+template <typename It, typename T>
+using is_byte_fill UTL_NODEBUG = bool_constant<UTL_TRAIT_is_pointer(It) &&
+    UTL_TRAIT_is_same(remove_cv_t<T>, remove_pointer_t<It>) && sizeof(T) == 1 &&
+    UTL_TRAIT_is_trivially_copyable(remove_pointer_t<It>)>;
+
+/**
+ * Whether value-initialized objects of a contiguous range are all zero bytes, which holds for
+ * arithmetic types, enums and pointers but not for member pointers or arbitrary class types
+ */
+template <typename It>
+using is_zero_fill UTL_NODEBUG = bool_constant<UTL_TRAIT_is_pointer(It) &&
+    (UTL_TRAIT_is_arithmetic(remove_pointer_t<It>) || UTL_TRAIT_is_enum(remove_pointer_t<It>) ||
+        UTL_TRAIT_is_pointer(remove_pointer_t<It>))>;
+
+/**
+ * Whether default-initializing the objects of a contiguous range does nothing
+ */
+template <typename It>
+using is_noop_default UTL_NODEBUG = bool_constant<UTL_TRAIT_is_pointer(It) &&
+    UTL_TRAIT_is_trivially_default_constructible(remove_pointer_t<It>)>;
+
+template <typename Size>
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) inline size_t to_count(Size n) noexcept {
+    return n > 0 ? size_t(n) : 0;
+}
+
+template <typename T>
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) inline T* copy_bytes(
+    T const* first, size_t count, T* dest) noexcept {
+    // Empty ranges may be null, which memcpy does not accept
+    if (count != 0) {
+        __UTL libc::runtime::memcpy(dest, first, libc::element_count_t(count));
+    }
+
+    return dest + count;
+}
+
+template <typename T>
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) inline T* zero_bytes(
+    T* first, size_t count) noexcept {
+    if (count != 0) {
+        __UTL libc::runtime::memset(
+            (unsigned char*)first, (unsigned char)0, libc::element_count_t(count * sizeof(T)));
+    }
+
+    return first + count;
+}
+
+template <typename In, typename Out>
+__UTL_HIDE_FROM_ABI inline Out copy(In first, In last, Out dest, true_type) noexcept {
+    return copy_bytes(first, size_t(last - first), dest);
+}
+
+template <typename In, typename Out>
+__UTL_HIDE_FROM_ABI inline Out copy(In first, In last, Out dest, false_type) {
+    Out const start = dest;
+    UTL_TRY {
+        for (; first != last; ++first, ++dest) {
+            ::new (static_cast<void*>(__UTL addressof(*dest))) value_type<Out>(*first);
+        }
+    } UTL_CATCH(...) {
+        __UTL destroy(start, dest);
+        UTL_RETHROW();
+    }
+
+    return dest;
+}
+
+template <typename In, typename Size, typename Out>
+__UTL_HIDE_FROM_ABI inline Out copy_n(In first, Size n, Out dest, true_type) noexcept {
+    return copy_bytes(first, to_count(n), dest);
+}
+
+template <typename In, typename Size, typename Out>
+__UTL_HIDE_FROM_ABI inline Out copy_n(In first, Size n, Out dest, false_type) {
+    Out const start = dest;
+    UTL_TRY {
+        for (; n > 0; --n, ++first, ++dest) {
+            ::new (static_cast<void*>(__UTL addressof(*dest))) value_type<Out>(*first);
+        }
+    } UTL_CATCH(...) {
+        __UTL destroy(start, dest);
+        UTL_RETHROW();
+    }
+
+    return dest;
+}
+
+template <typename In, typename Out>
+__UTL_HIDE_FROM_ABI inline Out move(In first, In last, Out dest, true_type) noexcept {
+    return copy_bytes(first, size_t(last - first), dest);
+}
+
+template <typename In, typename Out>
+__UTL_HIDE_FROM_ABI inline Out move(In first, In last, Out dest, false_type) {
+    Out const start = dest;
+    UTL_TRY {
+        for (; first != last; ++first, ++dest) {
+            ::new (static_cast<void*>(__UTL addressof(*dest))) value_type<Out>(__UTL move(*first));
+        }
+    } UTL_CATCH(...) {
+        __UTL destroy(start, dest);
+        UTL_RETHROW();
+    }
+
+    return dest;
+}
+
+template <typename In, typename Size, typename Out>
+__UTL_HIDE_FROM_ABI inline pair<In, Out> move_n(In first, Size n, Out dest, true_type) noexcept {
+    size_t const count = to_count(n);
+    return {first + count, copy_bytes(first, count, dest)};
+}
+
+template <typename In, typename Size, typename Out>
+__UTL_HIDE_FROM_ABI inline pair<In, Out> move_n(In first, Size n, Out dest, false_type) {
+    Out const start = dest;
+    UTL_TRY {
+        for (; n > 0; --n, ++first, ++dest) {
+            ::new (static_cast<void*>(__UTL addressof(*dest))) value_type<Out>(__UTL move(*first));
+        }
+    } UTL_CATCH(...) {
+        __UTL destroy(start, dest);
+        UTL_RETHROW();
+    }
+
+    return {first, dest};
+}
+
+template <typename It, typename T>
+__UTL_HIDE_FROM_ABI inline It fill_n(It first, size_t count, T const& value, true_type) noexcept {
+    if (count != 0) {
+        __UTL libc::runtime::memset(first, value, libc::element_count_t(count));
+    }
+
+    return first + count;
+}
+
+template <typename It, typename T>
+__UTL_HIDE_FROM_ABI inline It fill_n(It first, size_t count, T const& value, false_type) {
+    It current = first;
+    UTL_TRY {
+        for (; count != 0; --count, ++current) {
+            ::new (static_cast<void*>(__UTL addressof(*current))) value_type<It>(value);
+        }
+    } UTL_CATCH(...) {
+        __UTL destroy(first, current);
+        UTL_RETHROW();
+    }
+
+    return current;
+}
+
+template <typename It, typename T>
+__UTL_HIDE_FROM_ABI inline void fill(It first, It last, T const& value, true_type) noexcept {
+    fill_n(first, size_t(last - first), value, true_type{});
+}
+
+template <typename It, typename T>
+__UTL_HIDE_FROM_ABI inline void fill(It first, It last, T const& value, false_type) {
+    It current = first;
+    UTL_TRY {
+        for (; current != last; ++current) {
+            ::new (static_cast<void*>(__UTL addressof(*current))) value_type<It>(value);
+        }
+    } UTL_CATCH(...) {
+        __UTL destroy(first, current);
+        UTL_RETHROW();
+    }
+}
+
+template <typename It>
+__UTL_HIDE_FROM_ABI inline It value_construct_n(It first, size_t count, true_type) noexcept {
+    return zero_bytes(first, count);
+}
+
+template <typename It>
+__UTL_HIDE_FROM_ABI inline It value_construct_n(It first, size_t count, false_type) {
+    It current = first;
+    UTL_TRY {
+        for (; count != 0; --count, ++current) {
+            ::new (static_cast<void*>(__UTL addressof(*current))) value_type<It>();
+        }
+    } UTL_CATCH(...) {
+        __UTL destroy(first, current);
+        UTL_RETHROW();
+    }
+
+    return current;
+}
+
+template <typename It>
+__UTL_HIDE_FROM_ABI inline void value_construct(It first, It last, true_type) noexcept {
+    zero_bytes(first, size_t(last - first));
+}
+
+template <typename It>
+__UTL_HIDE_FROM_ABI inline void value_construct(It first, It last, false_type) {
+    It current = first;
+    UTL_TRY {
+        for (; current != last; ++current) {
+            ::new (static_cast<void*>(__UTL addressof(*current))) value_type<It>();
+        }
+    } UTL_CATCH(...) {
+        __UTL destroy(first, current);
+        UTL_RETHROW();
+    }
+}
+
+template <typename It>
+__UTL_HIDE_FROM_ABI inline It default_construct_n(It first, size_t count, true_type) noexcept {
+    return first + count;
+}
+
+template <typename It>
+__UTL_HIDE_FROM_ABI inline It default_construct_n(It first, size_t count, false_type) {
+    It current = first;
+    UTL_TRY {
+        for (; count != 0; --count, ++current) {
+            ::new (static_cast<void*>(__UTL addressof(*current))) value_type<It>;
+        }
+    } UTL_CATCH(...) {
+        __UTL destroy(first, current);
+        UTL_RETHROW();
+    }
+
+    return current;
+}
+
+template <typename It>
+__UTL_HIDE_FROM_ABI inline void default_construct(It, It, true_type) noexcept {}
+
+template <typename It>
+__UTL_HIDE_FROM_ABI inline void default_construct(It first, It last, false_type) {
+    It current = first;
+    UTL_TRY {
+        for (; current != last; ++current) {
+            ::new (static_cast<void*>(__UTL addressof(*current))) value_type<It>;
+        }
+    } UTL_CATCH(...) {
+        __UTL destroy(first, current);
+        UTL_RETHROW();
+    }
+}
+
+} // namespace uninitialized
+} // namespace details
+
+/**
+ * Copy-constructs the objects of `[first, last)` into the uninitialized storage at `dest`.
+ *
+ * Trivially copyable objects copied between contiguous ranges of the same type are copied with
+ * `memcpy`. Otherwise, if a constructor throws, the objects already constructed are destroyed
+ * before the exception is propagated.
+ *
+ * @return The end of the constructed range
+ */
+template <typename In, typename Out>
+__UTL_HIDE_FROM_ABI inline Out uninitialized_copy(In first, In last, Out dest) {
+    return details::uninitialized::copy(
+        first, last, dest, details::uninitialized::is_bitwise_copy<In, Out>{});
+}
+
+template <typename In, typename Size, typename Out>
+__UTL_HIDE_FROM_ABI inline Out uninitialized_copy_n(In first, Size n, Out dest) {
+    return details::uninitialized::copy_n(
+        first, n, dest, details::uninitialized::is_bitwise_copy<In, Out>{});
+}
+
+/**
+ * Move-constructs the objects of `[first, last)` into the uninitialized storage at `dest`, the
+ * source objects are left in their moved-from state.
+ *
+ * @return The end of the constructed range
+ */
+template <typename In, typename Out>
+__UTL_HIDE_FROM_ABI inline Out uninitialized_move(In first, In last, Out dest) {
+    return details::uninitialized::move(
+        first, last, dest, details::uninitialized::is_bitwise_move<In, Out>{});
+}
+
+/**
+ * @return The end of the source range and the end of the constructed range
+ */
+template <typename In, typename Size, typename Out>
+__UTL_HIDE_FROM_ABI inline pair<In, Out> uninitialized_move_n(In first, Size n, Out dest) {
+    return details::uninitialized::move_n(
+        first, n, dest, details::uninitialized::is_bitwise_move<In, Out>{});
+}
+
+/**
+ * Copy-constructs every object of `[first, last)` from `value`, contiguous ranges of byte-sized
+ * objects are filled with `memset`.
+ */
+template <typename It, typename T>
+__UTL_HIDE_FROM_ABI inline void uninitialized_fill(It first, It last, T const& value) {
+    details::uninitialized::fill(
+        first, last, value, details::uninitialized::is_byte_fill<It, T>{});
+}
+
+/**
+ * @return The end of the constructed range
+ */
+template <typename It, typename Size, typename T>
+__UTL_HIDE_FROM_ABI inline It uninitialized_fill_n(It first, Size n, T const& value) {
+    return details::uninitialized::fill_n(first, details::uninitialized::to_count(n), value,
+        details::uninitialized::is_byte_fill<It, T>{});
+}
+
+/**
+ * Value-initializes the objects of `[first, last)`, contiguous ranges of arithmetic, enum and
+ * pointer objects are zeroed with `memset`.
+ */
+template <typename It>
+__UTL_HIDE_FROM_ABI inline void uninitialized_value_construct(It first, It last) {
+    details::uninitialized::value_construct(
+        first, last, details::uninitialized::is_zero_fill<It>{});
+}
+
+/**
+ * @return The end of the constructed range
+ */
+template <typename It, typename Size>
+__UTL_HIDE_FROM_ABI inline It uninitialized_value_construct_n(It first, Size n) {
+    return details::uninitialized::value_construct_n(
+        first, details::uninitialized::to_count(n), details::uninitialized::is_zero_fill<It>{});
+}
+
+/**
+ * Default-initializes the objects of `[first, last)`, which does nothing for contiguous ranges of
+ * trivially default constructible objects.
+ */
+template <typename It>
+__UTL_HIDE_FROM_ABI inline void uninitialized_default_construct(It first, It last) {
+    details::uninitialized::default_construct(
+        first, last, details::uninitialized::is_noop_default<It>{});
+}
+
+/**
+ * @return The end of the constructed range
+ */
+template <typename It, typename Size>
+__UTL_HIDE_FROM_ABI inline It uninitialized_default_construct_n(It first, Size n) {
+    return details::uninitialized::default_construct_n(first,
+        details::uninitialized::to_count(n), details::uninitialized::is_noop_default<It>{});
+}
+
+UTL_NAMESPACE_END
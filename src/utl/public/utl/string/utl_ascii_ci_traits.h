@@ -0,0 +1,183 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/string/utl_string_fwd.h"
+
+#include "utl/string/utl_basic_short_string.h"
+#include "utl/string/utl_basic_string_view.h"
+#include "utl/string/utl_char_traits.h"
+#include "utl/string/utl_libc_simd.h"
+#include "utl/type_traits/utl_make_unsigned.h"
+#include "utl/utility/utl_constant_p.h"
+
+#include <stdint.h>
+
+UTL_NAMESPACE_BEGIN
+#define __UTL_ATTRIBUTE_PURE_API (PURE)(NODISCARD)(ALWAYS_INLINE)__UTL_ATTRIBUTE__HIDE_FROM_ABI
+#define __UTL_ATTRIBUTE_TYPE_AGGREGATE_PURE_API
+#define __UTL_ATTRIBUTE_CONST_API (CONST)(NODISCARD)(ALWAYS_INLINE)__UTL_ATTRIBUTE__HIDE_FROM_ABI
+#define __UTL_ATTRIBUTE_TYPE_AGGREGATE_CONST_API
+
+namespace details {
+namespace ascii_ci {
+
+template <typename T>
+UTL_ATTRIBUTE(CONST_API) inline constexpr T to_lower(T ch) noexcept {
+    return ch >= T('A') && ch <= T('Z') ? T(ch + ('a' - 'A')) : ch;
+}
+
+template <typename T>
+UTL_ATTRIBUTE(CONST_API) inline constexpr make_unsigned_t<T> to_unsigned_lower(T ch) noexcept {
+    return static_cast<make_unsigned_t<T>>(to_lower(ch));
+}
+
+/**
+ * Compares element by element from `offset`, the elements before it are known to be equal
+ */
+template <typename T>
+UTL_ATTRIBUTE(PURE_API) inline constexpr int compare(
+    T const* lhs, T const* rhs, size_t count, size_t offset = 0) noexcept {
+    for (; offset != count; ++offset) {
+        auto const l = to_unsigned_lower(lhs[offset]);
+        auto const r = to_unsigned_lower(rhs[offset]);
+        if (l != r) {
+            return l < r ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+template <typename T>
+UTL_ATTRIBUTE(PURE_API) inline constexpr T const* find(
+    T const* str, size_t count, T lower, size_t offset = 0) noexcept {
+    for (; offset != count; ++offset) {
+        if (to_lower(str[offset]) == lower) {
+            return str + offset;
+        }
+    }
+
+    return nullptr;
+}
+
+template <typename T>
+UTL_ATTRIBUTE(PURE_API) inline int runtime_compare(T const* lhs, T const* rhs, size_t count) noexcept {
+    return compare(lhs, rhs, count);
+}
+
+template <typename T>
+UTL_ATTRIBUTE(PURE_API) inline T const* runtime_find(T const* str, size_t count, T lower) noexcept {
+    return find(str, count, lower);
+}
+
+#if UTL_LIBC_SIMD
+template <>
+UTL_ATTRIBUTE(PURE_API) inline int runtime_compare(
+    char const* lhs, char const* rhs, size_t count) noexcept {
+    return compare(lhs, rhs, count, libc::runtime::simd::ascii_ci_mismatch(lhs, rhs, count));
+}
+
+template <>
+UTL_ATTRIBUTE(PURE_API) inline char const* runtime_find(
+    char const* str, size_t count, char lower) noexcept {
+    return find(str, count, lower, libc::runtime::simd::ascii_ci_find(str, count, lower));
+}
+#endif
+
+} // namespace ascii_ci
+} // namespace details
+
+/**
+ * @class ascii_ci_traits
+ * @brief Character traits that compare and search ignoring the case of ASCII letters
+ *
+ * Only 'A'-'Z' fold to 'a'-'z', every other value including non-ASCII code units compares as
+ * is, which is the matching rule for protocol tokens such as HTTP header names. Narrow strings
+ * are folded a vector at a time when the libc SIMD kernels are enabled.
+ */
+template <typename T>
+struct __UTL_PUBLIC_TEMPLATE ascii_ci_traits : char_traits<T> {
+    using char_type = T;
+#if UTL_CXX20
+    using comparison_category = ::std::weak_ordering;
+#endif
+
+    UTL_ATTRIBUTE(CONST_API) static inline constexpr char_type to_lower(char_type ch) noexcept {
+        return details::ascii_ci::to_lower(ch);
+    }
+
+    UTL_ATTRIBUTE(PURE_API) static inline constexpr int compare(
+        char_type const* lhs, char_type const* rhs, size_t length) noexcept {
+        return UTL_CONSTANT_P(details::ascii_ci::compare(lhs, rhs, length))
+            ? details::ascii_ci::compare(lhs, rhs, length)
+            : details::ascii_ci::runtime_compare(lhs, rhs, length);
+    }
+
+    UTL_ATTRIBUTE(PURE_API) static inline constexpr char_type const* find(
+        char_type const* str, size_t length, char_type const ch) noexcept {
+        return UTL_CONSTANT_P(details::ascii_ci::find(str, length, to_lower(ch)))
+            ? details::ascii_ci::find(str, length, to_lower(ch))
+            : details::ascii_ci::runtime_find(str, length, to_lower(ch));
+    }
+
+    UTL_ATTRIBUTE(CONST_API) static inline constexpr bool eq(char_type l, char_type r) noexcept {
+        return to_lower(l) == to_lower(r);
+    }
+
+    UTL_ATTRIBUTE(CONST_API) static inline constexpr bool lt(char_type l, char_type r) noexcept {
+        return details::ascii_ci::to_unsigned_lower(l) < details::ascii_ci::to_unsigned_lower(r);
+    }
+};
+
+/**
+ * @class ascii_ci_hash
+ * @brief Hashes strings so that strings equal under `ascii_ci_traits` have equal hashes
+ *
+ * FNV-1a over the lowercased code units, accepts views with any traits so that exact strings can
+ * be looked up in case-insensitive tables.
+ */
+template <typename CharType>
+struct __UTL_PUBLIC_TEMPLATE ascii_ci_hash {
+    template <typename Traits>
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, PURE, NODISCARD) inline constexpr size_t operator()(
+        basic_string_view<CharType, Traits> str) const noexcept {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (auto const ch : str) {
+            h = (h ^ details::ascii_ci::to_unsigned_lower(ch)) * 0x100000001b3ull;
+        }
+
+        return static_cast<size_t>(h);
+    }
+};
+
+template <typename>
+struct hash;
+
+template <typename CharType>
+struct __UTL_PUBLIC_TEMPLATE hash<basic_string_view<CharType, ascii_ci_traits<CharType>>> :
+    ascii_ci_hash<CharType> {};
+
+using ci_string_view = basic_string_view<char, ascii_ci_traits<char>>;
+using ci_wstring_view = basic_string_view<wchar_t, ascii_ci_traits<wchar_t>>;
+#if UTL_SUPPORTS_CHAR8_T
+using ci_u8string_view = basic_string_view<char8_t, ascii_ci_traits<char8_t>>;
+#endif
+using ci_u16string_view = basic_string_view<char16_t, ascii_ci_traits<char16_t>>;
+using ci_u32string_view = basic_string_view<char32_t, ascii_ci_traits<char32_t>>;
+
+using ci_string = basic_string<char, ascii_ci_traits<char>>;
+using ci_wstring = basic_string<wchar_t, ascii_ci_traits<wchar_t>>;
+#if UTL_SUPPORTS_CHAR8_T
+using ci_u8string = basic_string<char8_t, ascii_ci_traits<char8_t>>;
+#endif
+using ci_u16string = basic_string<char16_t, ascii_ci_traits<char16_t>>;
+using ci_u32string = basic_string<char32_t, ascii_ci_traits<char32_t>>;
+
+#undef __UTL_ATTRIBUTE_PURE_API
+#undef __UTL_ATTRIBUTE_TYPE_AGGREGATE_PURE_API
+#undef __UTL_ATTRIBUTE_CONST_API
+#undef __UTL_ATTRIBUTE_TYPE_AGGREGATE_CONST_API
+UTL_NAMESPACE_END
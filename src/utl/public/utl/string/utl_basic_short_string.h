@@ -33,6 +33,8 @@
 #include "utl/string/utl_string_details.h"
 #include "utl/type_traits/utl_is_convertible.h"
 #include "utl/type_traits/utl_is_nothrow_convertible.h"
+#include "utl/type_traits/utl_is_trivially_relocatable.h"
+#include "utl/type_traits/utl_logical_traits.h"
 #include "utl/type_traits/utl_type_identity.h"
 #include "utl/utility/utl_as_const.h"
 #include "utl/utility/utl_compressed_pair.h"
@@ -383,7 +385,7 @@ public:
             size_ = move(operation)(data(), new_size);
             data()[size_] = value_type();
             // Thrown exception is UB so assert
-            UTL_ASSERT(size_ < new_size);
+            UTL_ASSERT(size_ <= new_size);
         } UTL_CATCH(...) {
             UTL_ASSERT(false);
         }
@@ -1801,6 +1803,19 @@ UTL_NAMESPACE_END
 
 #endif
 
+UTL_NAMESPACE_BEGIN
+
+/**
+ * Short strings hold no pointer into themselves, so they relocate like their allocator and the
+ * pointer to their heap buffer.
+ */
+template <typename CharT, size_t N, typename Traits, typename Alloc>
+struct __UTL_PUBLIC_TEMPLATE is_trivially_relocatable<basic_short_string<CharT, N, Traits, Alloc>> :
+    conjunction<is_trivially_relocatable<Alloc>,
+        is_trivially_relocatable<typename allocator_traits<Alloc>::pointer>> {};
+
+UTL_NAMESPACE_END
+
 #undef __UTL_ATTRIBUTE_STRING_PURE
 #undef __UTL_ATTRIBUTE_TYPE_AGGREGATE_STRING_PURE
 #undef __UTL_ATTRIBUTE_STRING_CONST
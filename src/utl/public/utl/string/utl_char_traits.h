@@ -41,7 +41,7 @@ struct __UTL_PUBLIC_TEMPLATE char_traits {
 
     UTL_ATTRIBUTE(PURE_API) static inline constexpr char_type const* find(
         char_type const* str, size_t length, char_type const ch) noexcept {
-        return libc::strnchr(str, ch, libc::element_count_t(length));
+        return libc::find(str, ch, libc::element_count_t(length));
     }
 
     UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) static inline constexpr char_type* move(
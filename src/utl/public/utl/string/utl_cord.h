@@ -0,0 +1,679 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/string/utl_string_fwd.h"
+
+#include "utl/assert/utl_assert.h"
+#include "utl/exception.h"
+#include "utl/iterator/utl_iterator_tags.h"
+#include "utl/memory/utl_allocator_decl.h"
+#include "utl/memory/utl_atomic_reference_count.h"
+#include "utl/memory/utl_construct_at.h"
+#include "utl/memory/utl_intrusive_ptr.h"
+#include "utl/string/utl_basic_string_view.h"
+#include "utl/utility/utl_forward.h"
+#include "utl/utility/utl_move.h"
+
+#include <stddef.h>
+
+UTL_NAMESPACE_BEGIN
+
+template <typename CharType, typename Traits = char_traits<CharType>>
+class __UTL_PUBLIC_TEMPLATE basic_cord;
+
+namespace details {
+namespace cord {
+
+enum class node_kind : unsigned char {
+    flat,
+    substring,
+    concat
+};
+
+/**
+ * Common header of every cord node
+ *
+ * Leaves are either `flat` nodes that own their characters or `substring` nodes that reference a
+ * range of a `flat` node. Interior nodes are `concat` nodes. Nodes are immutable once published,
+ * so subtrees are freely shared between cords and threads.
+ */
+template <typename CharType>
+struct node : atomic_reference_count<node<CharType>> {
+    __UTL_HIDE_FROM_ABI node(node_kind k, size_t s, unsigned int d) noexcept
+        : size(s)
+        , depth(d)
+        , kind(k) {}
+
+    size_t size;
+    unsigned int depth;
+    node_kind kind;
+};
+
+template <typename CharType>
+using node_ptr = intrusive_ptr<node<CharType>>;
+
+template <typename CharType>
+struct flat : node<CharType> {
+    __UTL_HIDE_FROM_ABI explicit flat(size_t s) noexcept : node<CharType>(node_kind::flat, s, 0) {}
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, CONST) static constexpr size_t bytes(
+        size_t count) noexcept {
+        return sizeof(flat) + count * sizeof(CharType);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) CharType* data() noexcept {
+        return reinterpret_cast<CharType*>(this + 1);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) CharType const* data() const noexcept {
+        return reinterpret_cast<CharType const*>(this + 1);
+    }
+};
+
+template <typename CharType>
+struct substring : node<CharType> {
+    __UTL_HIDE_FROM_ABI substring(node_ptr<CharType> b, size_t o, size_t s) noexcept
+        : node<CharType>(node_kind::substring, s, 0)
+        , base(__UTL move(b))
+        , offset(o) {}
+
+    /** Always a `flat` node */
+    node_ptr<CharType> base;
+    size_t offset;
+};
+
+template <typename CharType>
+struct concat : node<CharType> {
+    __UTL_HIDE_FROM_ABI concat(node_ptr<CharType> l, node_ptr<CharType> r) noexcept
+        : node<CharType>(node_kind::concat, l->size + r->size,
+              (l->depth > r->depth ? l->depth : r->depth) + 1)
+        , left(__UTL move(l))
+        , right(__UTL move(r)) {}
+
+    node_ptr<CharType> left;
+    node_ptr<CharType> right;
+};
+
+/**
+ * Found by `reference_counting::destroy` through ADL
+ */
+template <typename CharType>
+__UTL_HIDE_FROM_ABI void destroy(node<CharType>* ptr) noexcept {
+    switch (ptr->kind) {
+    case node_kind::flat: {
+        auto const leaf = static_cast<flat<CharType>*>(ptr);
+        auto const bytes = flat<CharType>::bytes(leaf->size);
+        leaf->~flat();
+        __UTL memory::details::deallocate(leaf, bytes, alignof(flat<CharType>));
+        break;
+    }
+    case node_kind::substring:
+        delete static_cast<substring<CharType>*>(ptr);
+        break;
+    case node_kind::concat:
+        delete static_cast<concat<CharType>*>(ptr);
+        break;
+    }
+}
+
+} // namespace cord
+} // namespace details
+
+/**
+ * @class basic_cord
+ * @brief Immutable-node rope for large strings that are frequently spliced
+ *
+ * A cord is a binary tree of reference counted nodes whose leaves hold contiguous runs of
+ * characters. Copies share the whole tree, substrings share the leaves they cover, and
+ * concatenation only allocates a new interior node, so `insert`, `erase` and `replace` in the
+ * middle of large strings cost O(log n) rather than a memmove of the whole buffer. Small pieces
+ * are coalesced into flat leaves to keep trees of tiny fragments from forming, and trees that
+ * grow too deep are rebalanced.
+ *
+ * Contents are accessed by iterating over contiguous `basic_string_view` chunks with `chunks()`
+ * or `for_each_chunk`, or by copying out with `copy`. Cords are not NUL terminated.
+ *
+ * Distinct cord objects may be used concurrently from different threads even if they share nodes.
+ */
+template <typename CharType, typename Traits>
+class __UTL_PUBLIC_TEMPLATE basic_cord {
+    using node_type UTL_NODEBUG = details::cord::node<CharType>;
+    using node_ptr UTL_NODEBUG = details::cord::node_ptr<CharType>;
+    using flat_type UTL_NODEBUG = details::cord::flat<CharType>;
+    using substring_type UTL_NODEBUG = details::cord::substring<CharType>;
+    using concat_type UTL_NODEBUG = details::cord::concat<CharType>;
+    using node_kind UTL_NODEBUG = details::cord::node_kind;
+
+public:
+    using traits_type = Traits;
+    using value_type = CharType;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using view_type = basic_string_view<CharType, Traits>;
+
+    static constexpr size_type npos = size_type(-1);
+    /** Pieces up to this many characters are copied into a flat leaf rather than shared */
+    static constexpr size_type small_size = 512 / sizeof(CharType);
+    /** Trees deeper than this are rebalanced on concatenation */
+    static constexpr unsigned int max_depth = 64;
+
+    /**
+     * @class chunk_iterator
+     * @brief Forward iterator over the contiguous chunks of a cord
+     *
+     * Each increment descends from the root, costing O(log n). The iterator is invalidated by any
+     * modification of the cord it was obtained from.
+     */
+    class chunk_iterator {
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = view_type;
+        using difference_type = ptrdiff_t;
+        using reference = view_type;
+        using pointer = void;
+
+        __UTL_HIDE_FROM_ABI constexpr chunk_iterator() noexcept : root_(nullptr), offset_(0) {}
+
+        UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) view_type operator*() const noexcept { return current_; }
+
+        __UTL_HIDE_FROM_ABI chunk_iterator& operator++() noexcept {
+            offset_ += current_.size();
+            current_ = offset_ < root_->size ? chunk_at(root_, offset_) : view_type();
+            return *this;
+        }
+
+        __UTL_HIDE_FROM_ABI chunk_iterator operator++(int) noexcept {
+            auto const copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend bool operator==(
+            chunk_iterator const& l, chunk_iterator const& r) noexcept {
+            return l.offset_ == r.offset_;
+        }
+
+        UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend bool operator!=(
+            chunk_iterator const& l, chunk_iterator const& r) noexcept {
+            return l.offset_ != r.offset_;
+        }
+
+    private:
+        friend basic_cord;
+
+        __UTL_HIDE_FROM_ABI chunk_iterator(node_type const* root, size_type offset) noexcept
+            : root_(root)
+            , offset_(offset)
+            , current_(root != nullptr && offset < root->size ? chunk_at(root, offset)
+                                                               : view_type()) {}
+
+        node_type const* root_;
+        size_type offset_;
+        view_type current_;
+    };
+
+    struct chunk_range {
+        UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) chunk_iterator begin() const noexcept {
+            return first;
+        }
+        UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) chunk_iterator end() const noexcept {
+            return last;
+        }
+
+        chunk_iterator first;
+        chunk_iterator last;
+    };
+
+    __UTL_HIDE_FROM_ABI constexpr basic_cord() noexcept = default;
+    __UTL_HIDE_FROM_ABI explicit basic_cord(view_type str) UTL_THROWS : root_(make_flat(str)) {}
+    __UTL_HIDE_FROM_ABI explicit basic_cord(value_type const* str) UTL_THROWS
+        : root_(make_flat(view_type(str))) {}
+    __UTL_HIDE_FROM_ABI basic_cord(basic_cord const&) noexcept = default;
+    __UTL_HIDE_FROM_ABI basic_cord(basic_cord&&) noexcept = default;
+    __UTL_HIDE_FROM_ABI basic_cord& operator=(basic_cord const&) noexcept = default;
+    __UTL_HIDE_FROM_ABI basic_cord& operator=(basic_cord&&) noexcept = default;
+    __UTL_HIDE_FROM_ABI ~basic_cord() noexcept = default;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) size_type size() const noexcept {
+        return root_ ? root_->size : 0;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) size_type length() const noexcept { return size(); }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) bool empty() const noexcept { return !root_; }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, REINITIALIZES) void clear() noexcept { root_.reset(); }
+
+    /**
+     * @return The character at `pos`, found in O(log n)
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) value_type operator[](size_type pos) const noexcept {
+        UTL_ASSERT(pos < size());
+        return chunk_at(root_.get(), pos)[0];
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) chunk_range chunks() const noexcept {
+        return chunk_range{chunk_iterator(root_.get(), 0), chunk_iterator(root_.get(), size())};
+    }
+
+    /**
+     * @brief Invokes `func(view_type)` for every chunk in order
+     */
+    template <typename F>
+    __UTL_HIDE_FROM_ABI void for_each_chunk(F&& func) const {
+        if (root_) {
+            visit(root_.get(), func);
+        }
+    }
+
+    /**
+     * @brief Copies up to `count` characters starting at `pos` into `dest`
+     *
+     * @return The number of characters copied
+     *
+     * @throws utl::out_of_range - if `pos > size()`
+     */
+    __UTL_HIDE_FROM_ABI size_type copy(
+        value_type* dest, size_type count, size_type pos = 0) const UTL_THROWS {
+        UTL_THROW_IF(pos > size(),
+            out_of_range(UTL_MESSAGE_FORMAT("[UTL] `basic_cord::copy` operation failed, "
+                                            "Reason=[index out of range], pos=[%zu], size=[%zu]"),
+                pos, size()));
+        count = count > size() - pos ? size() - pos : count;
+        auto it = chunk_iterator(root_.get(), pos);
+        for (size_type copied = 0; copied < count; ++it) {
+            auto const chunk = *it;
+            auto const n = chunk.size() < count - copied ? chunk.size() : count - copied;
+            traits_type::copy(dest + copied, chunk.data(), n);
+            copied += n;
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Returns the characters in [pos, pos + count) sharing the leaves of this cord
+     *
+     * @throws utl::out_of_range - if `pos > size()`
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) basic_cord substr(
+        size_type pos = 0, size_type count = npos) const UTL_THROWS {
+        UTL_THROW_IF(pos > size(),
+            out_of_range(UTL_MESSAGE_FORMAT("[UTL] `basic_cord::substr` operation failed, "
+                                            "Reason=[index out of range], pos=[%zu], size=[%zu]"),
+                pos, size()));
+        count = count > size() - pos ? size() - pos : count;
+        return basic_cord(count ? slice(root_.get(), pos, count) : node_ptr());
+    }
+
+    __UTL_HIDE_FROM_ABI basic_cord& append(basic_cord const& other) UTL_THROWS {
+        root_ = concat(__UTL move(root_), other.root_);
+        return *this;
+    }
+
+    __UTL_HIDE_FROM_ABI basic_cord& append(view_type str) UTL_THROWS {
+        root_ = concat(__UTL move(root_), make_flat(str));
+        return *this;
+    }
+
+    __UTL_HIDE_FROM_ABI basic_cord& prepend(basic_cord const& other) UTL_THROWS {
+        root_ = concat(other.root_, __UTL move(root_));
+        return *this;
+    }
+
+    __UTL_HIDE_FROM_ABI basic_cord& prepend(view_type str) UTL_THROWS {
+        root_ = concat(make_flat(str), __UTL move(root_));
+        return *this;
+    }
+
+    __UTL_HIDE_FROM_ABI basic_cord& operator+=(basic_cord const& other) UTL_THROWS {
+        return append(other);
+    }
+
+    __UTL_HIDE_FROM_ABI basic_cord& operator+=(view_type str) UTL_THROWS { return append(str); }
+
+    /**
+     * @throws utl::out_of_range - if `pos > size()`
+     */
+    __UTL_HIDE_FROM_ABI basic_cord& insert(size_type pos, basic_cord const& other) UTL_THROWS {
+        return replace(pos, 0, other);
+    }
+
+    /**
+     * @throws utl::out_of_range - if `pos > size()`
+     */
+    __UTL_HIDE_FROM_ABI basic_cord& insert(size_type pos, view_type str) UTL_THROWS {
+        return replace(pos, 0, basic_cord(str));
+    }
+
+    /**
+     * @throws utl::out_of_range - if `pos > size()`
+     */
+    __UTL_HIDE_FROM_ABI basic_cord& erase(size_type pos = 0, size_type count = npos) UTL_THROWS {
+        return replace(pos, count, basic_cord());
+    }
+
+    /**
+     * @brief Replaces the characters in [pos, pos + count) with `other`
+     *
+     * @throws utl::out_of_range - if `pos > size()`
+     */
+    __UTL_HIDE_FROM_ABI basic_cord& replace(
+        size_type pos, size_type count, basic_cord const& other) UTL_THROWS {
+        UTL_THROW_IF(pos > size(),
+            out_of_range(UTL_MESSAGE_FORMAT("[UTL] `basic_cord::replace` operation failed, "
+                                            "Reason=[index out of range], pos=[%zu], size=[%zu]"),
+                pos, size()));
+        count = count > size() - pos ? size() - pos : count;
+        auto const tail = size() - pos - count;
+        auto head = pos ? slice(root_.get(), 0, pos) : node_ptr();
+        auto rest = tail ? slice(root_.get(), pos + count, tail) : node_ptr();
+        root_ = concat(concat(__UTL move(head), other.root_), __UTL move(rest));
+        return *this;
+    }
+
+    /**
+     * @throws utl::out_of_range - if `pos > size()`
+     */
+    __UTL_HIDE_FROM_ABI basic_cord& replace(size_type pos, size_type count, view_type str) UTL_THROWS {
+        return replace(pos, count, basic_cord(str));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) int compare(basic_cord const& other) const noexcept {
+        auto l = chunks().begin();
+        auto r = other.chunks().begin();
+        view_type lchunk = *l;
+        view_type rchunk = *r;
+        while (!lchunk.empty() && !rchunk.empty()) {
+            auto const n = lchunk.size() < rchunk.size() ? lchunk.size() : rchunk.size();
+            if (int const result = traits_type::compare(lchunk.data(), rchunk.data(), n)) {
+                return result;
+            }
+
+            lchunk = lchunk.substr(n);
+            rchunk = rchunk.substr(n);
+            if (lchunk.empty()) {
+                lchunk = *++l;
+            }
+            if (rchunk.empty()) {
+                rchunk = *++r;
+            }
+        }
+
+        return (size() > other.size()) - (size() < other.size());
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) int compare(view_type other) const noexcept {
+        size_type offset = 0;
+        for (auto const chunk : chunks()) {
+            auto const n =
+                chunk.size() < other.size() - offset ? chunk.size() : other.size() - offset;
+            if (int const result = traits_type::compare(chunk.data(), other.data() + offset, n)) {
+                return result;
+            }
+
+            offset += n;
+            if (offset == other.size()) {
+                break;
+            }
+        }
+
+        return (size() > other.size()) - (size() < other.size());
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend bool operator==(
+        basic_cord const& l, basic_cord const& r) noexcept {
+        return l.size() == r.size() && (l.root_ == r.root_ || l.compare(r) == 0);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend bool operator!=(
+        basic_cord const& l, basic_cord const& r) noexcept {
+        return !(l == r);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend bool operator==(
+        basic_cord const& l, view_type r) noexcept {
+        return l.size() == r.size() && l.compare(r) == 0;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend bool operator!=(
+        basic_cord const& l, view_type r) noexcept {
+        return !(l == r);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend basic_cord operator+(
+        basic_cord const& l, basic_cord const& r) UTL_THROWS {
+        return basic_cord(concat(l.root_, r.root_));
+    }
+
+private:
+    /** Enough Fibonacci slots to cover any size representable by size_t */
+    static constexpr unsigned int forest_size = 92;
+
+    __UTL_HIDE_FROM_ABI explicit basic_cord(node_ptr root) noexcept : root_(__UTL move(root)) {}
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static node_ptr retain(node_type* n) noexcept {
+        return node_ptr(retain_object, n);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static flat_type* allocate_flat(size_type count) UTL_THROWS {
+        auto const memory =
+            __UTL memory::details::allocate(flat_type::bytes(count), alignof(flat_type));
+        return __UTL construct_at(static_cast<flat_type*>(memory), count);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static node_ptr make_flat(view_type str) UTL_THROWS {
+        if (str.empty()) {
+            return node_ptr();
+        }
+
+        auto const leaf = allocate_flat(str.size());
+        traits_type::copy(leaf->data(), str.data(), str.size());
+        return node_ptr(adopt_object, leaf);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE) static view_type leaf(node_type const* n) noexcept {
+        UTL_ASSERT(n->kind != node_kind::concat);
+        if (n->kind == node_kind::flat) {
+            return view_type(static_cast<flat_type const*>(n)->data(), n->size);
+        }
+
+        auto const sub = static_cast<substring_type const*>(n);
+        return view_type(
+            static_cast<flat_type const*>(sub->base.get())->data() + sub->offset, n->size);
+    }
+
+    /**
+     * @return The remainder of the leaf containing `pos`
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD, PURE) static view_type chunk_at(
+        node_type const* n, size_type pos) noexcept {
+        while (n->kind == node_kind::concat) {
+            auto const c = static_cast<concat_type const*>(n);
+            if (pos < c->left->size) {
+                n = c->left.get();
+            } else {
+                pos -= c->left->size;
+                n = c->right.get();
+            }
+        }
+
+        return leaf(n).substr(pos);
+    }
+
+    template <typename F>
+    __UTL_HIDE_FROM_ABI static void visit(node_type const* n, F& func) {
+        while (n->kind == node_kind::concat) {
+            auto const c = static_cast<concat_type const*>(n);
+            visit(c->left.get(), func);
+            n = c->right.get();
+        }
+
+        func(leaf(n));
+    }
+
+    /**
+     * Copies both operands into a single flat leaf, used to coalesce small pieces
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static node_ptr merge(
+        node_type const* l, node_type const* r) UTL_THROWS {
+        auto const result = allocate_flat(l->size + r->size);
+        auto out = result->data();
+        auto const append = [&out](view_type chunk) {
+            traits_type::copy(out, chunk.data(), chunk.size());
+            out += chunk.size();
+        };
+        visit(l, append);
+        visit(r, append);
+        return node_ptr(adopt_object, result);
+    }
+
+    /**
+     * Concatenates without coalescing or rebalancing
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static node_ptr join(node_ptr l, node_ptr r) UTL_THROWS {
+        if (!l) {
+            return r;
+        }
+
+        if (!r) {
+            return l;
+        }
+
+        return node_ptr(adopt_object, new concat_type(__UTL move(l), __UTL move(r)));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static node_ptr concat(node_ptr l, node_ptr r) UTL_THROWS {
+        if (!l || !r) {
+            return join(__UTL move(l), __UTL move(r));
+        }
+
+        if (l->size + r->size <= small_size) {
+            return merge(l.get(), r.get());
+        }
+
+        if (l->kind == node_kind::concat && r->size <= small_size) {
+            // Coalesce repeated small appends into the rightmost leaf
+            auto const c = static_cast<concat_type const*>(l.get());
+            if (c->right->kind != node_kind::concat && c->right->size + r->size <= small_size) {
+                return concat(c->left, merge(c->right.get(), r.get()));
+            }
+        }
+
+        auto result = join(__UTL move(l), __UTL move(r));
+        return result->depth > max_depth ? rebalance(result.get()) : result;
+    }
+
+    /**
+     * @pre `count > 0` and `pos + count <= n->size`
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static node_ptr slice(
+        node_type* n, size_type pos, size_type count) UTL_THROWS {
+        if (pos == 0 && count == n->size) {
+            return retain(n);
+        }
+
+        switch (n->kind) {
+        case node_kind::concat: {
+            auto const c = static_cast<concat_type*>(n);
+            auto const split = c->left->size;
+            if (pos + count <= split) {
+                return slice(c->left.get(), pos, count);
+            }
+
+            if (pos >= split) {
+                return slice(c->right.get(), pos - split, count);
+            }
+
+            return concat(slice(c->left.get(), pos, split - pos),
+                slice(c->right.get(), 0, pos + count - split));
+        }
+        case node_kind::substring: {
+            auto const sub = static_cast<substring_type*>(n);
+            pos += sub->offset;
+            n = sub->base.get();
+            break;
+        }
+        default:
+            break;
+        }
+
+        if (count <= small_size) {
+            return make_flat(view_type(static_cast<flat_type*>(n)->data() + pos, count));
+        }
+
+        return node_ptr(adopt_object, new substring_type(retain(n), pos, count));
+    }
+
+    /**
+     * Rebalances a tree using the Fibonacci forest algorithm of Boehm, Atkinson and Plass. Slot
+     * `i` of the forest only holds trees at least `min_length[i]` characters long, so the result
+     * is balanced in the sense that a tree of depth `d` holds at least `fib(d + 2)` characters.
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static node_ptr rebalance(node_type* root) UTL_THROWS {
+        size_type min_length[forest_size + 1];
+        min_length[0] = 1;
+        min_length[1] = 2;
+        for (unsigned int i = 2; i <= forest_size; ++i) {
+            auto const next = min_length[i - 1] + min_length[i - 2];
+            min_length[i] = next < min_length[i - 1] ? npos : next;
+        }
+
+        node_ptr forest[forest_size];
+        add_to_forest(root, forest, min_length);
+        node_ptr result;
+        for (unsigned int i = 0; i < forest_size; ++i) {
+            if (forest[i]) {
+                result = join(__UTL move(forest[i]), __UTL move(result));
+            }
+        }
+
+        return result;
+    }
+
+    __UTL_HIDE_FROM_ABI static void add_to_forest(
+        node_type* n, node_ptr* forest, size_type const* min_length) UTL_THROWS {
+        if (n->kind == node_kind::concat && n->size < min_length[n->depth]) {
+            auto const c = static_cast<concat_type*>(n);
+            add_to_forest(c->left.get(), forest, min_length);
+            add_to_forest(c->right.get(), forest, min_length);
+            return;
+        }
+
+        // Leaves and balanced subtrees are inserted whole
+        node_ptr too_tiny;
+        unsigned int i = 0;
+        for (; i + 1 < forest_size && n->size >= min_length[i + 1]; ++i) {
+            if (forest[i]) {
+                too_tiny = join(__UTL move(forest[i]), __UTL move(too_tiny));
+            }
+        }
+
+        auto insertee = join(__UTL move(too_tiny), retain(n));
+        for (;; ++i) {
+            if (forest[i]) {
+                insertee = join(__UTL move(forest[i]), __UTL move(insertee));
+            }
+
+            if (i + 1 == forest_size || insertee->size < min_length[i + 1]) {
+                forest[i] = __UTL move(insertee);
+                return;
+            }
+        }
+    }
+
+    node_ptr root_;
+};
+
+using cord = basic_cord<char>;
+using wcord = basic_cord<wchar_t>;
+#if UTL_SUPPORTS_CHAR8_T
+using u8cord = basic_cord<char8_t>;
+#endif
+using u16cord = basic_cord<char16_t>;
+using u32cord = basic_cord<char32_t>;
+
+UTL_NAMESPACE_END
@@ -127,6 +127,17 @@ UTL_ATTRIBUTE(LIBC_PURE) inline constexpr T* strnchr(
         ? compile_time::strnchr(str, ch, max_len)
         : runtime::strnchr(str, ch, max_len);
 }
+
+template <UTL_CONCEPT_CXX20(string_char) T UTL_CONSTRAINT_CXX11(is_string_char<T>::value)>
+UTL_ATTRIBUTE(LIBC_PURE) inline constexpr T* find(
+    T const* str, T const ch, element_count_t count) noexcept {
+    return UTL_CONSTANT_P(compile_time::find(str, ch, count))
+        ? compile_time::find(str, ch, count)
+        : runtime::find(str, ch, count);
+}
+
+using runtime::memcpy_stream;
+using runtime::memset_stream;
 } // namespace libc
 
 #undef __UTL_ATTRIBUTE_LIBC_PURE
@@ -104,6 +104,14 @@ __UTL_HIDE_FROM_ABI inline constexpr T* strnchr(
                        : __UTL libc::compile_time::recursive::strnchr(str + 1, ch, len - 1);
 }
 
+template <typename T>
+__UTL_HIDE_FROM_ABI inline constexpr T* find(
+    T const* str, T const ch, element_count_t len) noexcept {
+    return len == 0    ? nullptr
+        : (*str == ch) ? const_cast<T*>(str)
+                       : __UTL libc::compile_time::recursive::find(str + 1, ch, len - 1);
+}
+
 template <typename T>
 __UTL_HIDE_FROM_ABI inline constexpr T* strnset(
     T* dst, T const val, element_count_t count, T* org) noexcept {
@@ -225,6 +233,12 @@ __UTL_HIDE_FROM_ABI inline constexpr T* strnchr(
     return recursive::strnchr(str, val, max_len);
 }
 
+template <UTL_CONCEPT_CXX20(string_char) T UTL_CONSTRAINT_CXX11(is_string_char<T>::value)>
+__UTL_HIDE_FROM_ABI inline constexpr T* find(
+    T const* str, T const val, element_count_t max_len) noexcept {
+    return recursive::find(str, val, max_len);
+}
+
 } // namespace compile_time
 } // namespace libc
 
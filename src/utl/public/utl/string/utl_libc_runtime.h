@@ -5,6 +5,7 @@
 #include "utl/utl_config.h"
 
 #include "utl/string/utl_libc_common.h"
+#include "utl/string/utl_libc_simd.h"
 #include "utl/utility/utl_signs.h"
 
 UTL_NAMESPACE_BEGIN
@@ -17,6 +18,21 @@ UTL_NAMESPACE_BEGIN
 
 namespace libc {
 namespace runtime {
+/**
+ * Bulk memory operations that bypass the cache for buffers too large to stay resident in it,
+ * such as zeroing arenas or copying large payloads. Smaller buffers are forwarded to the
+ * regular functions.
+ */
+namespace stream {
+/**
+ * @return Size in bytes past which non-temporal stores are used, three quarters of the last
+ * level cache unless overridden with `UTL_LIBC_STREAM_THRESHOLD`
+ */
+__UTL_ABI_PUBLIC size_t threshold() noexcept;
+__UTL_ABI_PUBLIC void* copy(void* UTL_RESTRICT dst, void const* UTL_RESTRICT src, size_t bytes) noexcept;
+__UTL_ABI_PUBLIC void* fill(void* dst, unsigned char value, size_t bytes) noexcept;
+} // namespace stream
+
 namespace standard {
 
 template <UTL_CONCEPT_CXX20(trivially_copyable) T UTL_CONSTRAINT_CXX11(is_trivially_copyable<T>::value)>
@@ -90,6 +106,12 @@ UTL_ATTRIBUTES(LIBC_INLINE_PURE) inline size_t strlen(wchar_t const* str) noexce
 
 template <UTL_CONCEPT_CXX20(string_char) T UTL_CONSTRAINT_CXX11(is_string_char<T>::value)>
 UTL_ATTRIBUTES(LIBC_PURE) inline size_t strlen(T const* str) noexcept {
+#if UTL_LIBC_SIMD
+    if (simd::is_eligible(str)) {
+        return simd::strlen(str);
+    }
+#endif
+
     size_t count = 0;
     while (*str) {
         ++str;
@@ -117,6 +139,12 @@ UTL_ATTRIBUTES(LIBC_INLINE_PURE) inline wchar_t* strchr(wchar_t const* str, wcha
 
 template <UTL_CONCEPT_CXX20(string_char) T UTL_CONSTRAINT_CXX11(is_string_char<T>::value)>
 UTL_ATTRIBUTES(LIBC_PURE) inline T* strnchr(T const* str, T const ch, element_count_t count) noexcept {
+#if UTL_LIBC_SIMD
+    if (simd::is_eligible(str)) {
+        return simd::strnchr(str, ch, size_t(count));
+    }
+#endif
+
     size_t len = size_t(count);
     while (len) {
         if (*str == ch) {
@@ -135,6 +163,12 @@ UTL_ATTRIBUTES(LIBC_PURE) inline T* strnchr(T const* str, T const ch, element_co
 
 template <UTL_CONCEPT_CXX20(string_char) T UTL_CONSTRAINT_CXX11(is_string_char<T>::value)>
 UTL_ATTRIBUTES(LIBC_PURE) inline T* strchr(T const* str, T const ch) noexcept {
+#if UTL_LIBC_SIMD
+    if (simd::is_eligible(str)) {
+        return simd::strchr(str, ch);
+    }
+#endif
+
     while (*str != ch) {
         if (!*str) {
             return nullptr;
@@ -145,6 +179,31 @@ UTL_ATTRIBUTES(LIBC_PURE) inline T* strchr(T const* str, T const ch) noexcept {
     return (T*)str;
 }
 
+/**
+ * Finds the first occurrence of `ch` in the `count` elements starting at `str`; unlike `strnchr`,
+ * NUL characters do not terminate the search
+ */
+UTL_ATTRIBUTES(LIBC_INLINE_PURE) inline char* find(char const* str, char const ch, element_count_t count) noexcept {
+    return memchr(str, ch, size_t(count));
+}
+
+template <UTL_CONCEPT_CXX20(string_char) T UTL_CONSTRAINT_CXX11(is_string_char<T>::value)>
+UTL_ATTRIBUTES(LIBC_PURE) inline T* find(T const* str, T const ch, element_count_t count) noexcept {
+#if UTL_LIBC_SIMD
+    if (simd::is_eligible(str)) {
+        return simd::find(str, ch, size_t(count));
+    }
+#endif
+
+    for (size_t len = size_t(count); len; --len, ++str) {
+        if (*str == ch) {
+            return const_cast<T*>(str);
+        }
+    }
+
+    return nullptr;
+}
+
 #if UTL_COMPILER_MSVC
 #  pragma intrinsic(strcmp)
 #endif
@@ -219,6 +278,12 @@ UTL_ATTRIBUTES(LIBC_PURE) inline int strncmp(T const* left, T const* right, elem
 
 template <UTL_CONCEPT_CXX20(string_char) T UTL_CONSTRAINT_CXX11(is_string_char<T>::value)>
 UTL_ATTRIBUTES(LIBC_PURE) inline T* strnset(T* dst, T const val, element_count_t elements) noexcept {
+#if UTL_LIBC_SIMD
+    if (simd::is_eligible(dst)) {
+        return simd::strnset(dst, val, size_t(elements));
+    }
+#endif
+
     size_t len = (size_t)elements;
     if (!len) {
         return dst;
@@ -240,13 +305,30 @@ UTL_ATTRIBUTES(LIBC_PURE) inline T* strnset(T* dst, T const val, element_count_t
 
     return dst;
 }
+
+template <UTL_CONCEPT_CXX20(trivially_copyable) T UTL_CONSTRAINT_CXX11(is_trivially_copyable<T>::value)>
+UTL_ATTRIBUTES(ALWAYS_INLINE, _HIDE_FROM_ABI) inline T* memcpy_stream(
+    T* UTL_RESTRICT dst, T const* UTL_RESTRICT src, element_count_t count) noexcept {
+    return (T*)stream::copy(dst, src, byte_count<T>(count));
+}
+
+template <UTL_CONCEPT_CXX20(trivially_copyable) T UTL_CONSTRAINT_CXX11(
+    is_trivially_copyable<T>::value && exact_size<T, 1>::value)>
+UTL_CONSTRAINT_CXX20(exact_size<T, 1>)
+UTL_ATTRIBUTES(ALWAYS_INLINE, _HIDE_FROM_ABI) inline T* memset_stream(
+    T* dst, T const value, element_count_t count) noexcept {
+    return (T*)stream::fill(dst, as_byte(value), byte_count<T>(count));
+}
 } // namespace standard
 
+using standard::find;
 using standard::memchr;
 using standard::memcmp;
 using standard::memcpy;
+using standard::memcpy_stream;
 using standard::memmove;
 using standard::memset;
+using standard::memset_stream;
 using standard::strchr;
 using standard::strcmp;
 using standard::strlen;
@@ -0,0 +1,575 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/bit/utl_countr_zero.h"
+#include "utl/configuration/utl_simd.h"
+
+#include <stdint.h>
+
+/**
+ * Vectorized element search kernels for 1, 2 and 4-byte string characters
+ *
+ * Every load is aligned to the vector width so that reads never cross a page boundary, the
+ * lanes before the start of the string (head) and past the end of a bounded search (tail) are
+ * masked off. Such over-reads are invisible to the program but not to address sanitizers, so the
+ * kernels are disabled in sanitized builds.
+ */
+
+#if !defined(UTL_LIBC_DISABLE_SIMD) && !defined(__SANITIZE_ADDRESS__)
+#  if defined(__has_feature)
+#    if __has_feature(address_sanitizer)
+#      define __UTL_LIBC_SANITIZED 1
+#    endif
+#  endif
+
+#  if !defined(__UTL_LIBC_SANITIZED) && \
+      (UTL_SIMD_X86_AVX2 || UTL_SIMD_X86_SSE2 || (UTL_SIMD_ARM_NEON && UTL_ARCH_AARCH64))
+#    define UTL_LIBC_SIMD 1
+#  endif
+
+#  undef __UTL_LIBC_SANITIZED
+#endif
+
+#if UTL_LIBC_SIMD
+
+#  if UTL_ARCH_x86
+#    include <immintrin.h>
+#  else
+#    include <arm_neon.h>
+#  endif
+
+/**
+ * Builds targeting the x86-64 baseline bind the widest kernel the CPU supports on first use
+ * instead of settling for SSE2, see `cpu_features`
+ */
+#  if UTL_ARCH_x86 && !UTL_SIMD_X86_AVX2 && !defined(UTL_LIBC_DISABLE_DISPATCH) && \
+      (UTL_COMPILER_GNU_BASED || UTL_COMPILER_MSVC)
+#    define UTL_LIBC_SIMD_DISPATCH 1
+#  endif
+
+#  if UTL_SIMD_X86_AVX2 || UTL_COMPILER_MSVC
+#    define __UTL_LIBC_SIMD_TARGET_AVX2
+#  else
+#    define __UTL_LIBC_SIMD_TARGET_AVX2 __attribute__((__target__("avx2")))
+#  endif
+
+UTL_NAMESPACE_BEGIN
+
+#  define __UTL_ATTRIBUTE_LIBC_SIMD_PURE (PURE)(NODISCARD) __UTL_ATTRIBUTE__HIDE_FROM_ABI
+#  define __UTL_ATTRIBUTE_TYPE_AGGREGATE_LIBC_SIMD_PURE
+#  define __UTL_ATTRIBUTE_LIBC_SIMD_INLINE (ALWAYS_INLINE)__UTL_ATTRIBUTE__HIDE_FROM_ABI
+#  define __UTL_ATTRIBUTE_TYPE_AGGREGATE_LIBC_SIMD_INLINE
+
+namespace libc {
+namespace runtime {
+namespace simd {
+namespace details {
+
+#  if UTL_ARCH_x86
+
+struct sse2_ops {
+    using vector_type = __m128i;
+    using mask_type = uint32_t;
+    static constexpr size_t width = 16;
+    static constexpr unsigned int bits_per_byte = 1;
+
+    template <size_t N>
+    struct lanes;
+
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type load(uintptr_t addr) noexcept {
+        return _mm_load_si128(reinterpret_cast<vector_type const*>(addr));
+    }
+
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type load_unaligned(uintptr_t addr) noexcept {
+        return _mm_loadu_si128(reinterpret_cast<vector_type const*>(addr));
+    }
+
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline void store_unaligned(
+        uintptr_t addr, vector_type v) noexcept {
+        _mm_storeu_si128(reinterpret_cast<vector_type*>(addr), v);
+    }
+
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type either(
+        vector_type l, vector_type r) noexcept {
+        return _mm_or_si128(l, r);
+    }
+
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline mask_type to_mask(vector_type v) noexcept {
+        return static_cast<mask_type>(_mm_movemask_epi8(v));
+    }
+};
+
+template <>
+struct sse2_ops::lanes<1> {
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type broadcast(uint32_t v) noexcept {
+        return _mm_set1_epi8(static_cast<char>(v));
+    }
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type equal(
+        vector_type l, vector_type r) noexcept {
+        return _mm_cmpeq_epi8(l, r);
+    }
+    /**
+     * Shifts 'A'-'Z' to the bottom of the signed range, selects them with a single compare and
+     * adds the case bit to the selected lanes
+     */
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type ascii_lower(vector_type v) noexcept {
+        auto const shifted = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(0x80 - 'A')));
+        auto const upper = _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(0x80 + 26)), shifted);
+        return _mm_add_epi8(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+    }
+};
+
+template <>
+struct sse2_ops::lanes<2> {
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type broadcast(uint32_t v) noexcept {
+        return _mm_set1_epi16(static_cast<short>(v));
+    }
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type equal(
+        vector_type l, vector_type r) noexcept {
+        return _mm_cmpeq_epi16(l, r);
+    }
+};
+
+template <>
+struct sse2_ops::lanes<4> {
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type broadcast(uint32_t v) noexcept {
+        return _mm_set1_epi32(static_cast<int>(v));
+    }
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type equal(
+        vector_type l, vector_type r) noexcept {
+        return _mm_cmpeq_epi32(l, r);
+    }
+};
+
+#    if UTL_SIMD_X86_AVX2 || UTL_LIBC_SIMD_DISPATCH
+
+/**
+ * Not force-inlined as the operations may be called from generic code compiled for the baseline
+ * target, kernels using them are flattened instead
+ */
+struct avx2_ops {
+    using vector_type = __m256i;
+    using mask_type = uint32_t;
+    static constexpr size_t width = 32;
+    static constexpr unsigned int bits_per_byte = 1;
+
+    template <size_t N>
+    struct lanes;
+
+    __UTL_HIDE_FROM_ABI __UTL_LIBC_SIMD_TARGET_AVX2 static inline vector_type load(
+        uintptr_t addr) noexcept {
+        return _mm256_load_si256(reinterpret_cast<vector_type const*>(addr));
+    }
+
+    __UTL_HIDE_FROM_ABI __UTL_LIBC_SIMD_TARGET_AVX2 static inline vector_type load_unaligned(
+        uintptr_t addr) noexcept {
+        return _mm256_loadu_si256(reinterpret_cast<vector_type const*>(addr));
+    }
+
+    __UTL_HIDE_FROM_ABI __UTL_LIBC_SIMD_TARGET_AVX2 static inline void store_unaligned(
+        uintptr_t addr, vector_type v) noexcept {
+        _mm256_storeu_si256(reinterpret_cast<vector_type*>(addr), v);
+    }
+
+    __UTL_HIDE_FROM_ABI __UTL_LIBC_SIMD_TARGET_AVX2 static inline vector_type either(
+        vector_type l, vector_type r) noexcept {
+        return _mm256_or_si256(l, r);
+    }
+
+    __UTL_HIDE_FROM_ABI __UTL_LIBC_SIMD_TARGET_AVX2 static inline mask_type to_mask(
+        vector_type v) noexcept {
+        return static_cast<mask_type>(_mm256_movemask_epi8(v));
+    }
+};
+
+template <>
+struct avx2_ops::lanes<1> {
+    __UTL_HIDE_FROM_ABI __UTL_LIBC_SIMD_TARGET_AVX2 static inline vector_type broadcast(
+        uint32_t v) noexcept {
+        return _mm256_set1_epi8(static_cast<char>(v));
+    }
+    __UTL_HIDE_FROM_ABI __UTL_LIBC_SIMD_TARGET_AVX2 static inline vector_type equal(
+        vector_type l, vector_type r) noexcept {
+        return _mm256_cmpeq_epi8(l, r);
+    }
+    __UTL_HIDE_FROM_ABI __UTL_LIBC_SIMD_TARGET_AVX2 static inline vector_type ascii_lower(
+        vector_type v) noexcept {
+        auto const shifted = _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(0x80 - 'A')));
+        auto const upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(0x80 + 26)), shifted);
+        return _mm256_add_epi8(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+    }
+};
+
+template <>
+struct avx2_ops::lanes<2> {
+    __UTL_HIDE_FROM_ABI __UTL_LIBC_SIMD_TARGET_AVX2 static inline vector_type broadcast(
+        uint32_t v) noexcept {
+        return _mm256_set1_epi16(static_cast<short>(v));
+    }
+    __UTL_HIDE_FROM_ABI __UTL_LIBC_SIMD_TARGET_AVX2 static inline vector_type equal(
+        vector_type l, vector_type r) noexcept {
+        return _mm256_cmpeq_epi16(l, r);
+    }
+};
+
+template <>
+struct avx2_ops::lanes<4> {
+    __UTL_HIDE_FROM_ABI __UTL_LIBC_SIMD_TARGET_AVX2 static inline vector_type broadcast(
+        uint32_t v) noexcept {
+        return _mm256_set1_epi32(static_cast<int>(v));
+    }
+    __UTL_HIDE_FROM_ABI __UTL_LIBC_SIMD_TARGET_AVX2 static inline vector_type equal(
+        vector_type l, vector_type r) noexcept {
+        return _mm256_cmpeq_epi32(l, r);
+    }
+};
+
+#    endif // UTL_SIMD_X86_AVX2 || UTL_LIBC_SIMD_DISPATCH
+
+#    if UTL_SIMD_X86_AVX2
+using vector_ops = avx2_ops;
+#    else
+using vector_ops = sse2_ops;
+#    endif
+
+#  else // NEON
+
+struct neon_ops {
+    using vector_type = uint8x16_t;
+    using mask_type = uint64_t;
+    static constexpr size_t width = 16;
+    static constexpr unsigned int bits_per_byte = 4;
+
+    template <size_t N>
+    struct lanes;
+
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type load(uintptr_t addr) noexcept {
+        return vld1q_u8(reinterpret_cast<uint8_t const*>(addr));
+    }
+
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type load_unaligned(uintptr_t addr) noexcept {
+        return vld1q_u8(reinterpret_cast<uint8_t const*>(addr));
+    }
+
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline void store_unaligned(
+        uintptr_t addr, vector_type v) noexcept {
+        vst1q_u8(reinterpret_cast<uint8_t*>(addr), v);
+    }
+
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type either(
+        vector_type l, vector_type r) noexcept {
+        return vorrq_u8(l, r);
+    }
+
+    /**
+     * Narrows each byte to a nibble, there is no movemask equivalent
+     */
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline mask_type to_mask(vector_type v) noexcept {
+        return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(v), 4)), 0);
+    }
+};
+
+template <>
+struct neon_ops::lanes<1> {
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type broadcast(uint32_t v) noexcept {
+        return vdupq_n_u8(static_cast<uint8_t>(v));
+    }
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type equal(
+        vector_type l, vector_type r) noexcept {
+        return vceqq_u8(l, r);
+    }
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type ascii_lower(vector_type v) noexcept {
+        auto const upper = vcltq_u8(vsubq_u8(v, vdupq_n_u8('A')), vdupq_n_u8(26));
+        return vaddq_u8(v, vandq_u8(upper, vdupq_n_u8(0x20)));
+    }
+};
+
+template <>
+struct neon_ops::lanes<2> {
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type broadcast(uint32_t v) noexcept {
+        return vreinterpretq_u8_u16(vdupq_n_u16(static_cast<uint16_t>(v)));
+    }
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type equal(
+        vector_type l, vector_type r) noexcept {
+        return vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(l), vreinterpretq_u16_u8(r)));
+    }
+};
+
+template <>
+struct neon_ops::lanes<4> {
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type broadcast(uint32_t v) noexcept {
+        return vreinterpretq_u8_u32(vdupq_n_u32(v));
+    }
+    UTL_ATTRIBUTE(LIBC_SIMD_INLINE) static inline vector_type equal(
+        vector_type l, vector_type r) noexcept {
+        return vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(l), vreinterpretq_u32_u8(r)));
+    }
+};
+
+using vector_ops = neon_ops;
+
+#  endif
+
+template <size_t N>
+struct lane_type;
+template <>
+struct lane_type<1> {
+    using type = uint8_t;
+};
+template <>
+struct lane_type<2> {
+    using type = uint16_t;
+};
+template <>
+struct lane_type<4> {
+    using type = uint32_t;
+};
+
+template <typename T>
+UTL_ATTRIBUTE(LIBC_SIMD_INLINE) inline typename lane_type<sizeof(T)>::type to_lane(T value) noexcept {
+    return static_cast<typename lane_type<sizeof(T)>::type>(value);
+}
+
+/**
+ * @return Mask with the lowest `bytes` bytes' bits set, `bytes` must be less than the width
+ */
+template <typename Ops>
+UTL_ATTRIBUTE(LIBC_SIMD_INLINE) inline typename Ops::mask_type low_bytes(size_t bytes) noexcept {
+    return (typename Ops::mask_type(1) << (bytes * Ops::bits_per_byte)) - 1;
+}
+
+/**
+ * @return Mask with every lane's bits set
+ */
+template <typename Ops>
+UTL_ATTRIBUTE(LIBC_SIMD_INLINE) inline typename Ops::mask_type all_lanes() noexcept {
+    using mask_type = typename Ops::mask_type;
+    return mask_type(~mask_type(0)) >> (sizeof(mask_type) * 8 - Ops::width * Ops::bits_per_byte);
+}
+
+template <typename Ops, typename Lanes, bool Bounded, bool CheckNul>
+UTL_ATTRIBUTE(LIBC_SIMD_INLINE) inline typename Ops::mask_type block_matches(uintptr_t block,
+    uintptr_t end, typename Ops::vector_type const& target,
+    typename Ops::vector_type const& zero) noexcept {
+    auto const v = Ops::load(block);
+    auto const eq = Lanes::equal(v, target);
+    auto mask = Ops::to_mask(CheckNul ? Ops::either(eq, Lanes::equal(v, zero)) : eq);
+    if (Bounded && end - block < Ops::width) {
+        mask &= low_bytes<Ops>(end - block);
+    }
+
+    return mask;
+}
+
+/**
+ * Finds the first element equal to `value`, or NUL if `CheckNul`, in [str, str + count)
+ *
+ * Always inlined so that callers compiled for a wider target than the translation unit can
+ * instantiate it with the corresponding `Ops`
+ *
+ * @tparam Bounded If false, `count` is ignored and the string must be NUL-terminated
+ */
+template <typename Ops, bool Bounded, bool CheckNul, typename T>
+UTL_ATTRIBUTE(LIBC_SIMD_INLINE) inline T* first_match(T const* str, T value, size_t count) noexcept {
+    using lanes = typename Ops::template lanes<sizeof(T)>;
+    static_assert(Bounded || CheckNul, "Unbounded search requires a terminator");
+    static constexpr uintptr_t align_mask = Ops::width - 1;
+
+    auto const start = reinterpret_cast<uintptr_t>(str);
+    uintptr_t end = uintptr_t(-1);
+    if (Bounded) {
+        if (!count) {
+            return nullptr;
+        }
+
+        // Treat oversized counts as unbounded
+        end = count < (uintptr_t(-1) - start) / sizeof(T) ? start + count * sizeof(T) : end;
+    }
+
+    auto const target = lanes::broadcast(to_lane(value));
+    auto const zero = lanes::broadcast(0);
+    auto block = start & ~align_mask;
+    auto mask = block_matches<Ops, lanes, Bounded, CheckNul>(block, end, target, zero) >>
+        ((start - block) * Ops::bits_per_byte);
+    if (mask) {
+        auto const offset = __UTL countr_zero(mask) / Ops::bits_per_byte;
+        return reinterpret_cast<T*>(start + offset);
+    }
+
+    while (true) {
+        block += Ops::width;
+        if (Bounded && block >= end) {
+            return nullptr;
+        }
+
+        mask = block_matches<Ops, lanes, Bounded, CheckNul>(block, end, target, zero);
+        if (mask) {
+            auto const offset = __UTL countr_zero(mask) / Ops::bits_per_byte;
+            return reinterpret_cast<T*>(block + offset);
+        }
+    }
+}
+
+#  if UTL_LIBC_SIMD_DISPATCH
+
+/**
+ * Kernels bound on first use to the widest implementation supported by the CPU
+ *
+ * Elements are passed as unsigned lanes of the same width, the kernels never dereference the
+ * result so the search can be shared by every character type of that width.
+ */
+__UTL_ABI_PUBLIC uint8_t* find_or_nul(uint8_t const* str, uint8_t value, size_t count) noexcept;
+__UTL_ABI_PUBLIC uint16_t* find_or_nul(uint16_t const* str, uint16_t value, size_t count) noexcept;
+__UTL_ABI_PUBLIC uint32_t* find_or_nul(uint32_t const* str, uint32_t value, size_t count) noexcept;
+__UTL_ABI_PUBLIC uint8_t* find(uint8_t const* str, uint8_t value, size_t count) noexcept;
+__UTL_ABI_PUBLIC uint16_t* find(uint16_t const* str, uint16_t value, size_t count) noexcept;
+__UTL_ABI_PUBLIC uint32_t* find(uint32_t const* str, uint32_t value, size_t count) noexcept;
+
+template <typename T>
+UTL_ATTRIBUTE(LIBC_SIMD_INLINE) inline typename lane_type<sizeof(T)>::type const* as_lanes(
+    T const* str) noexcept {
+    return reinterpret_cast<typename lane_type<sizeof(T)>::type const*>(str);
+}
+
+template <bool Bounded, bool CheckNul, typename T>
+UTL_ATTRIBUTE(LIBC_SIMD_INLINE) inline T* search(T const* str, T value, size_t count) noexcept {
+    return CheckNul
+        ? reinterpret_cast<T*>(find_or_nul(as_lanes(str), to_lane(value), Bounded ? count : size_t(-1)))
+        : reinterpret_cast<T*>(find(as_lanes(str), to_lane(value), count));
+}
+
+#  else // UTL_LIBC_SIMD_DISPATCH
+
+template <bool Bounded, bool CheckNul, typename T>
+UTL_ATTRIBUTE(LIBC_SIMD_INLINE) inline T* search(T const* str, T value, size_t count) noexcept {
+    return first_match<vector_ops, Bounded, CheckNul>(str, value, count);
+}
+
+#  endif // UTL_LIBC_SIMD_DISPATCH
+
+} // namespace details
+
+/**
+ * Whether the kernels can be used for `str`; misaligned elements would straddle lanes
+ */
+template <typename T>
+UTL_ATTRIBUTE(LIBC_SIMD_INLINE) inline bool is_eligible(T const* str) noexcept {
+    return (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4) &&
+        (reinterpret_cast<uintptr_t>(str) & (sizeof(T) - 1)) == 0;
+}
+
+template <typename T>
+UTL_ATTRIBUTE(LIBC_SIMD_PURE) inline size_t strlen(T const* str) noexcept {
+    return static_cast<size_t>(details::search<false, true>(str, T(), 0) - str);
+}
+
+template <typename T>
+UTL_ATTRIBUTE(LIBC_SIMD_PURE) inline T* strchr(T const* str, T const ch) noexcept {
+    auto const result = details::search<false, true>(str, ch, 0);
+    return *result == ch ? result : nullptr;
+}
+
+template <typename T>
+UTL_ATTRIBUTE(LIBC_SIMD_PURE) inline T* strnchr(T const* str, T const ch, size_t count) noexcept {
+    auto const result = details::search<true, true>(str, ch, count);
+    return result != nullptr && *result == ch ? result : nullptr;
+}
+
+template <typename T>
+UTL_ATTRIBUTE(LIBC_SIMD_PURE) inline T* find(T const* str, T const ch, size_t count) noexcept {
+    return details::search<true, false>(str, ch, count);
+}
+
+/**
+ * Fills `count` elements with a broadcast vector; the last store overlaps the previous one
+ * instead of finishing element by element. Stores are not worth dispatching so the baseline
+ * vector width is used.
+ */
+template <typename T>
+UTL_ATTRIBUTE(LIBC_SIMD_INLINE) inline T* strnset(T* dst, T const value, size_t count) noexcept {
+    using ops = details::vector_ops;
+    using lanes = typename ops::template lanes<sizeof(T)>;
+    auto const bytes = count * sizeof(T);
+    if (bytes < ops::width) {
+        for (size_t idx = 0; idx < count; ++idx) {
+            dst[idx] = value;
+        }
+
+        return dst;
+    }
+
+    auto const v = lanes::broadcast(details::to_lane(value));
+    auto const start = reinterpret_cast<uintptr_t>(dst);
+    auto const last = start + bytes - ops::width;
+    for (auto block = start; block < last; block += ops::width) {
+        ops::store_unaligned(block, v);
+    }
+
+    ops::store_unaligned(last, v);
+    return dst;
+}
+
+/**
+ * ASCII case-insensitive kernels over whole vectors of bytes; loads are unaligned and never
+ * leave the ranges, so the remainder is left to the caller
+ *
+ * @return The offset of the first mismatching byte, or of the first byte past the last vector
+ */
+UTL_ATTRIBUTE(LIBC_SIMD_PURE) inline size_t ascii_ci_mismatch(
+    char const* lhs, char const* rhs, size_t count) noexcept {
+    using ops = details::vector_ops;
+    using lanes = ops::lanes<1>;
+    auto const l = reinterpret_cast<uintptr_t>(lhs);
+    auto const r = reinterpret_cast<uintptr_t>(rhs);
+    size_t offset = 0;
+    for (; count - offset >= ops::width; offset += ops::width) {
+        auto const eq = lanes::equal(lanes::ascii_lower(ops::load_unaligned(l + offset)),
+            lanes::ascii_lower(ops::load_unaligned(r + offset)));
+        auto const mask = ~ops::to_mask(eq) & details::all_lanes<ops>();
+        if (mask) {
+            return offset + __UTL countr_zero(mask) / ops::bits_per_byte;
+        }
+    }
+
+    return offset;
+}
+
+/**
+ * @param lower The lowercase byte to search for
+ * @return The offset of the first byte that lowercases to `lower`, or of the first byte past the
+ * last vector
+ */
+UTL_ATTRIBUTE(LIBC_SIMD_PURE) inline size_t ascii_ci_find(
+    char const* str, size_t count, char lower) noexcept {
+    using ops = details::vector_ops;
+    using lanes = ops::lanes<1>;
+    auto const start = reinterpret_cast<uintptr_t>(str);
+    auto const target = lanes::broadcast(details::to_lane(lower));
+    size_t offset = 0;
+    for (; count - offset >= ops::width; offset += ops::width) {
+        auto const eq =
+            lanes::equal(lanes::ascii_lower(ops::load_unaligned(start + offset)), target);
+        auto const mask = ops::to_mask(eq);
+        if (mask) {
+            return offset + __UTL countr_zero(mask) / ops::bits_per_byte;
+        }
+    }
+
+    return offset;
+}
+
+} // namespace simd
+} // namespace runtime
+} // namespace libc
+
+#  undef __UTL_ATTRIBUTE_LIBC_SIMD_PURE
+#  undef __UTL_ATTRIBUTE_TYPE_AGGREGATE_LIBC_SIMD_PURE
+#  undef __UTL_ATTRIBUTE_LIBC_SIMD_INLINE
+#  undef __UTL_ATTRIBUTE_TYPE_AGGREGATE_LIBC_SIMD_INLINE
+
+UTL_NAMESPACE_END
+
+#endif // UTL_LIBC_SIMD
@@ -0,0 +1,501 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/string/utl_string_fwd.h"
+
+#include "utl/assert/utl_assert.h"
+#include "utl/memory/utl_allocator_decl.h"
+#include "utl/string/utl_basic_string_view.h"
+#include "utl/type_traits/utl_make_unsigned.h"
+
+#include <stdint.h>
+#include <string.h>
+
+UTL_NAMESPACE_BEGIN
+
+template <typename CharType>
+class __UTL_PUBLIC_TEMPLATE basic_multi_search;
+
+namespace details {
+namespace multi_search {
+
+/**
+ * Teddy fingerprint tables, patterns are spread over 8 buckets and each table maps a nibble of
+ * the k-th fingerprint byte to the set of buckets containing a pattern with that nibble
+ */
+struct teddy_masks {
+    static constexpr size_t max_fingerprint = 3;
+
+    uint8_t low[max_fingerprint][16];
+    uint8_t high[max_fingerprint][16];
+    /** Number of leading bytes of every pattern in the tables, 0 if the prefilter is disabled */
+    size_t fingerprint;
+};
+
+/**
+ * Finds the first position that may start a pattern, vectorized with byte shuffles
+ *
+ * @return The offset of the first candidate, or of the first position too close to the end of
+ * the text to hold a fingerprint if there is none
+ */
+__UTL_ABI_PUBLIC size_t teddy_find(
+    teddy_masks const& masks, unsigned char const* str, size_t count) noexcept;
+
+/**
+ * Zero initialized array of state indices
+ */
+class buffer {
+public:
+    __UTL_HIDE_FROM_ABI buffer() noexcept : data_(nullptr), size_(0) {}
+
+    __UTL_HIDE_FROM_ABI explicit buffer(size_t size) UTL_THROWS
+        : data_(__UTL memory::runtime::allocate<uint32_t>(size))
+        , size_(size) {
+        ::memset(data_, 0, size * sizeof(uint32_t));
+    }
+
+    buffer(buffer const&) = delete;
+    buffer& operator=(buffer const&) = delete;
+
+    __UTL_HIDE_FROM_ABI buffer(buffer&& other) noexcept : data_(other.data_), size_(other.size_) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    __UTL_HIDE_FROM_ABI buffer& operator=(buffer&& other) noexcept {
+        buffer tmp(static_cast<buffer&&>(other));
+        auto const data = data_;
+        auto const size = size_;
+        data_ = tmp.data_;
+        size_ = tmp.size_;
+        tmp.data_ = data;
+        tmp.size_ = size;
+        return *this;
+    }
+
+    __UTL_HIDE_FROM_ABI ~buffer() noexcept {
+        if (data_ != nullptr) {
+            __UTL memory::runtime::deallocate<uint32_t>(data_, size_);
+        }
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) uint32_t* data() const noexcept {
+        return data_;
+    }
+
+private:
+    uint32_t* data_;
+    size_t size_;
+};
+
+/**
+ * Maps characters to dense equivalence classes, class 0 holds every character absent from the
+ * patterns so that the automaton only needs a column per distinct pattern character
+ */
+template <typename CharType, bool = (sizeof(CharType) == 1)>
+class alphabet {
+public:
+    __UTL_HIDE_FROM_ABI alphabet() noexcept : size_(1) { ::memset(classes_, 0, sizeof(classes_)); }
+
+    __UTL_HIDE_FROM_ABI void build(basic_string_view<CharType> const* patterns, size_t count) noexcept {
+        for (size_t idx = 0; idx != count; ++idx) {
+            for (auto const ch : patterns[idx]) {
+                auto& cls = classes_[static_cast<unsigned char>(ch)];
+                if (cls == 0) {
+                    cls = static_cast<uint16_t>(size_++);
+                }
+            }
+        }
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) size_t size() const noexcept {
+        return size_;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) uint32_t operator()(
+        CharType ch) const noexcept {
+        return classes_[static_cast<unsigned char>(ch)];
+    }
+
+private:
+    uint16_t classes_[256];
+    size_t size_;
+};
+
+/**
+ * Wide characters are looked up in an open addressing table of (character, class) pairs
+ */
+template <typename CharType>
+class alphabet<CharType, false> {
+public:
+    __UTL_HIDE_FROM_ABI alphabet() noexcept : mask_(0), size_(1) {}
+
+    __UTL_HIDE_FROM_ABI void build(basic_string_view<CharType> const* patterns, size_t count) UTL_THROWS {
+        size_t total = 0;
+        for (size_t idx = 0; idx != count; ++idx) {
+            total += patterns[idx].size();
+        }
+
+        size_t capacity = 2;
+        while (capacity < 2 * total) {
+            capacity *= 2;
+        }
+
+        slots_ = buffer(2 * capacity);
+        mask_ = capacity - 1;
+        for (size_t idx = 0; idx != count; ++idx) {
+            for (auto const ch : patterns[idx]) {
+                auto const slot = probe(ch);
+                if (slot[1] == 0) {
+                    slot[0] = key(ch);
+                    slot[1] = static_cast<uint32_t>(size_++);
+                }
+            }
+        }
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) size_t size() const noexcept {
+        return size_;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) uint32_t operator()(CharType ch) const noexcept {
+        return mask_ ? probe(ch)[1] : 0;
+    }
+
+private:
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, CONST) static uint32_t key(CharType ch) noexcept {
+        return static_cast<uint32_t>(static_cast<make_unsigned_t<CharType>>(ch));
+    }
+
+    __UTL_HIDE_FROM_ABI uint32_t* probe(CharType ch) const noexcept {
+        auto const k = key(ch);
+        auto index = (k * 0x9e3779b1u) & mask_;
+        while (true) {
+            auto const slot = slots_.data() + 2 * index;
+            if (slot[1] == 0 || slot[0] == k) {
+                return slot;
+            }
+
+            index = (index + 1) & mask_;
+        }
+    }
+
+    buffer slots_;
+    size_t mask_;
+    size_t size_;
+};
+
+/**
+ * The prefilter is only built for narrow strings
+ */
+template <typename CharType>
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) inline size_t skip(
+    teddy_masks const&, CharType const*, size_t) noexcept {
+    return 0;
+}
+
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) inline size_t skip(
+    teddy_masks const& masks, char const* str, size_t count) noexcept {
+    return teddy_find(masks, reinterpret_cast<unsigned char const*>(str), count);
+}
+
+#if UTL_SUPPORTS_CHAR8_T
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) inline size_t skip(
+    teddy_masks const& masks, char8_t const* str, size_t count) noexcept {
+    return teddy_find(masks, reinterpret_cast<unsigned char const*>(str), count);
+}
+#endif
+
+} // namespace multi_search
+} // namespace details
+
+/**
+ * @class basic_multi_search
+ * @brief Matcher compiled from a set of patterns that finds every occurrence of each of them in
+ * a single pass over the text
+ *
+ * The patterns are compiled into an Aho-Corasick automaton stored as a dense transition table
+ * over the equivalence classes of the pattern characters, so each character of the text costs a
+ * single lookup. For narrow strings and up to `prefilter_max_patterns` patterns, a Teddy
+ * fingerprint filter over the first bytes of the patterns skips the text between candidate
+ * positions whenever the automaton is in its start state.
+ *
+ * Matches are reported with the offset of their first character in the text. Overlapping matches
+ * and matches spanning chunks fed to a `scanner` are all reported, in order of their end
+ * position. Empty patterns never match and duplicate patterns are reported under the lowest
+ * index. The matcher is immutable once built and may be shared between threads.
+ */
+template <typename CharType>
+class __UTL_PUBLIC_TEMPLATE basic_multi_search {
+    using alphabet_type UTL_NODEBUG = details::multi_search::alphabet<CharType>;
+    using buffer_type UTL_NODEBUG = details::multi_search::buffer;
+
+public:
+    using value_type = CharType;
+    using size_type = size_t;
+    using view_type = basic_string_view<CharType>;
+
+    struct match {
+        /** Index of the pattern in the set the matcher was built from */
+        size_type pattern;
+        /** Offset of the first character of the match */
+        size_type position;
+    };
+
+    class scanner;
+
+    static constexpr size_type prefilter_max_patterns = 64;
+
+    __UTL_HIDE_FROM_ABI basic_multi_search(view_type const* patterns, size_type count) UTL_THROWS
+        : state_count_(1) {
+        alphabet_.build(patterns, count);
+        classes_ = alphabet_.size();
+
+        size_t total = 0;
+        for (size_type idx = 0; idx != count; ++idx) {
+            total += patterns[idx].size();
+        }
+
+        UTL_ASSERT(total < UINT32_MAX && count < UINT32_MAX);
+        auto const capacity = total + 1;
+        table_ = buffer_type(capacity * (classes_ + 2) + count);
+        next_ = table_.data();
+        output_ = next_ + capacity * classes_;
+        suffix_ = output_ + capacity;
+        lengths_ = suffix_ + capacity;
+
+        insert(patterns, count);
+        link();
+        build_prefilter(patterns, count);
+    }
+
+    template <size_t N>
+    __UTL_HIDE_FROM_ABI explicit basic_multi_search(view_type const (&patterns)[N]) UTL_THROWS
+        : basic_multi_search(patterns, N) {}
+
+    basic_multi_search(basic_multi_search const&) = delete;
+    basic_multi_search& operator=(basic_multi_search const&) = delete;
+    __UTL_HIDE_FROM_ABI basic_multi_search(basic_multi_search&&) noexcept = default;
+    __UTL_HIDE_FROM_ABI basic_multi_search& operator=(basic_multi_search&&) noexcept = default;
+    __UTL_HIDE_FROM_ABI ~basic_multi_search() noexcept = default;
+
+    /**
+     * @return The number of automaton states, including the start state
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) size_type state_count() const noexcept {
+        return state_count_;
+    }
+
+    /**
+     * @return `true` if the text between candidate positions is skipped by the Teddy filter
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) bool has_prefilter() const noexcept {
+        return prefilter_.fingerprint != 0;
+    }
+
+    /**
+     * Invokes `on_match(match)` for every occurrence of every pattern in `text`
+     */
+    template <typename F>
+    __UTL_HIDE_FROM_ABI void find_all(view_type text, F&& on_match) const {
+        scan(0, 0, text.data(), text.size(), on_match);
+    }
+
+    /**
+     * @return `true` if any pattern occurs in `text`
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) bool contains_any(view_type text) const noexcept {
+        uint32_t state = 0;
+        auto const data = text.data();
+        auto const size = text.size();
+        for (size_type idx = 0; idx < size;) {
+            if (state == 0 && has_prefilter()) {
+                idx += details::multi_search::skip(prefilter_, data + idx, size - idx);
+                if (idx == size) {
+                    break;
+                }
+            }
+
+            state = next_[state * classes_ + alphabet_(data[idx++])];
+            if (output_[state] != 0 || suffix_[state] != 0) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    __UTL_HIDE_FROM_ABI void insert(view_type const* patterns, size_type count) noexcept {
+        for (size_type idx = 0; idx != count; ++idx) {
+            if (patterns[idx].empty()) {
+                continue;
+            }
+
+            uint32_t state = 0;
+            for (auto const ch : patterns[idx]) {
+                auto& edge = next_[state * classes_ + alphabet_(ch)];
+                if (edge == 0) {
+                    edge = static_cast<uint32_t>(state_count_++);
+                }
+
+                state = edge;
+            }
+
+            if (output_[state] == 0) {
+                output_[state] = static_cast<uint32_t>(idx + 1);
+            }
+
+            lengths_[idx] = static_cast<uint32_t>(patterns[idx].size());
+        }
+    }
+
+    /**
+     * Computes the failure links breadth first and folds them into the transition table, the
+     * row of a state's failure target is always complete by the time the state is visited
+     */
+    __UTL_HIDE_FROM_ABI void link() UTL_THROWS {
+        buffer_type work(2 * state_count_);
+        auto const failure = work.data();
+        auto const queue = failure + state_count_;
+        size_t head = 0;
+        size_t tail = 0;
+        for (size_type cls = 0; cls != classes_; ++cls) {
+            if (auto const child = next_[cls]) {
+                queue[tail++] = child;
+            }
+        }
+
+        while (head != tail) {
+            auto const state = queue[head++];
+            auto const row = next_ + state * classes_;
+            auto const fallback = next_ + failure[state] * classes_;
+            for (size_type cls = 0; cls != classes_; ++cls) {
+                if (auto const child = row[cls]) {
+                    auto const target = fallback[cls];
+                    failure[child] = target;
+                    suffix_[child] = output_[target] != 0 ? target : suffix_[target];
+                    queue[tail++] = child;
+                } else {
+                    row[cls] = fallback[cls];
+                }
+            }
+        }
+    }
+
+    __UTL_HIDE_FROM_ABI void build_prefilter(view_type const* patterns, size_type count) noexcept {
+        static constexpr size_t max_fingerprint = details::multi_search::teddy_masks::max_fingerprint;
+        ::memset(&prefilter_, 0, sizeof(prefilter_));
+        if (sizeof(CharType) != 1 || count > prefilter_max_patterns || state_count_ == 1) {
+            return;
+        }
+
+        size_t fingerprint = max_fingerprint;
+        for (size_type idx = 0; idx != count; ++idx) {
+            if (!patterns[idx].empty() && patterns[idx].size() < fingerprint) {
+                fingerprint = patterns[idx].size();
+            }
+        }
+
+        // Patterns sharing a first byte share a bucket, keeping the per-bucket byte sets small
+        for (size_type idx = 0; idx != count; ++idx) {
+            if (patterns[idx].empty()) {
+                continue;
+            }
+
+            auto const bytes = reinterpret_cast<unsigned char const*>(patterns[idx].data());
+            auto const bucket = static_cast<uint8_t>(1u << (bytes[0] & 7));
+            for (size_t pos = 0; pos != fingerprint; ++pos) {
+                prefilter_.low[pos][bytes[pos] & 0xf] |= bucket;
+                prefilter_.high[pos][bytes[pos] >> 4] |= bucket;
+            }
+        }
+
+        prefilter_.fingerprint = fingerprint;
+    }
+
+    template <typename F>
+    __UTL_HIDE_FROM_ABI uint32_t scan(uint32_t state, size_type offset, value_type const* data,
+        size_type size, F& on_match) const {
+        for (size_type idx = 0; idx < size;) {
+            if (state == 0 && has_prefilter()) {
+                // No pattern starts before the candidate, so the automaton stays in the start state
+                idx += details::multi_search::skip(prefilter_, data + idx, size - idx);
+                if (idx == size) {
+                    break;
+                }
+            }
+
+            state = next_[state * classes_ + alphabet_(data[idx++])];
+            auto found = output_[state] != 0 ? state : suffix_[state];
+            while (found != 0) {
+                auto const pattern = output_[found] - 1;
+                on_match(match{pattern, offset + idx - lengths_[pattern]});
+                found = suffix_[found];
+            }
+        }
+
+        return state;
+    }
+
+    alphabet_type alphabet_;
+    buffer_type table_;
+    details::multi_search::teddy_masks prefilter_;
+    size_type classes_;
+    size_type state_count_;
+    uint32_t* next_;
+    uint32_t* output_;
+    uint32_t* suffix_;
+    uint32_t* lengths_;
+};
+
+/**
+ * @class basic_multi_search::scanner
+ * @brief Streams successive chunks of a text through a matcher
+ *
+ * Holds the automaton state between chunks, so matches spanning chunk boundaries are reported
+ * when the chunk holding their last character is fed. Positions are relative to the start of the
+ * stream.
+ */
+template <typename CharType>
+class __UTL_PUBLIC_TEMPLATE basic_multi_search<CharType>::scanner {
+public:
+    __UTL_HIDE_FROM_ABI explicit scanner(basic_multi_search const& matcher UTL_LIFETIMEBOUND) noexcept
+        : matcher_(&matcher)
+        , state_(0)
+        , offset_(0) {}
+
+    template <typename F>
+    __UTL_HIDE_FROM_ABI void feed(view_type chunk, F&& on_match) {
+        state_ = matcher_->scan(state_, offset_, chunk.data(), chunk.size(), on_match);
+        offset_ += chunk.size();
+    }
+
+    /**
+     * @return The number of characters fed since construction or the last reset
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) size_type offset() const noexcept { return offset_; }
+
+    __UTL_HIDE_FROM_ABI void reset() noexcept {
+        state_ = 0;
+        offset_ = 0;
+    }
+
+private:
+    basic_multi_search const* matcher_;
+    uint32_t state_;
+    size_type offset_;
+};
+
+using multi_search = basic_multi_search<char>;
+using wmulti_search = basic_multi_search<wchar_t>;
+#if UTL_SUPPORTS_CHAR8_T
+using u8multi_search = basic_multi_search<char8_t>;
+#endif
+using u16multi_search = basic_multi_search<char16_t>;
+using u32multi_search = basic_multi_search<char32_t>;
+
+UTL_NAMESPACE_END
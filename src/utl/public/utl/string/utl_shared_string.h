@@ -0,0 +1,275 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/string/utl_string_fwd.h"
+
+#include "utl/assert/utl_assert.h"
+#include "utl/memory/utl_allocator_decl.h"
+#include "utl/memory/utl_atomic_reference_count.h"
+#include "utl/memory/utl_construct_at.h"
+#include "utl/string/utl_basic_string_view.h"
+#include "utl/string/utl_basic_zstring_view.h"
+#include "utl/utility/utl_move.h"
+
+#include <limits.h>
+
+UTL_NAMESPACE_BEGIN
+
+template <typename CharType, typename Traits = char_traits<CharType>>
+class __UTL_PUBLIC_TEMPLATE basic_shared_string;
+
+namespace details {
+namespace shared_string {
+
+/**
+ * Heap block of a shared string, the NUL-terminated characters follow the header
+ */
+template <typename CharType>
+struct header : atomic_reference_count<header<CharType>> {
+    __UTL_HIDE_FROM_ABI explicit header(size_t s) noexcept : size(s) {}
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, CONST) static constexpr size_t bytes(
+        size_t count) noexcept {
+        return sizeof(header) + (count + 1) * sizeof(CharType);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) CharType* data() noexcept {
+        return reinterpret_cast<CharType*>(this + 1);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) CharType const* data() const noexcept {
+        return reinterpret_cast<CharType const*>(this + 1);
+    }
+
+    size_t size;
+};
+
+/**
+ * Found by `reference_counting::destroy` through ADL
+ */
+template <typename CharType>
+__UTL_HIDE_FROM_ABI void destroy(header<CharType>* ptr) noexcept {
+    auto const bytes = header<CharType>::bytes(ptr->size);
+    ptr->~header();
+    __UTL memory::details::deallocate(ptr, bytes, alignof(header<CharType>));
+}
+
+} // namespace shared_string
+} // namespace details
+
+/**
+ * @class basic_shared_string
+ * @brief Immutable string with O(1) copies for values shared across containers and threads
+ *
+ * Strings that fit in the same inline buffer as the default `basic_short_string` are stored
+ * inline and copied by value. Longer strings live in a single heap block headed by an
+ * `atomic_reference_count`, which copies share. The contents are always NUL terminated.
+ */
+template <typename CharType, typename Traits>
+class __UTL_PUBLIC_TEMPLATE basic_shared_string {
+    using header_type UTL_NODEBUG = details::shared_string::header<CharType>;
+
+public:
+    using traits_type = Traits;
+    using value_type = CharType;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using const_reference = value_type const&;
+    using const_pointer = value_type const*;
+    using const_iterator = const_pointer;
+    using view_type = basic_string_view<CharType, Traits>;
+    using zview_type = basic_zstring_view<CharType, Traits>;
+
+    /** The longest string stored without a heap block */
+    static constexpr size_type inline_capacity =
+        details::string::default_inline_size<CharType, allocator<CharType>>::value;
+
+    __UTL_HIDE_FROM_ABI basic_shared_string() noexcept : size_(0), is_heap_(false) {
+        storage_.inline_[0] = value_type();
+    }
+
+    __UTL_HIDE_FROM_ABI explicit basic_shared_string(view_type str) UTL_THROWS
+        : size_(str.size())
+        , is_heap_(str.size() > inline_capacity) {
+        value_type* dst = storage_.inline_;
+        if (is_heap_) {
+            auto const memory = __UTL memory::details::allocate(
+                header_type::bytes(str.size()), alignof(header_type));
+            storage_.heap_ = __UTL construct_at(static_cast<header_type*>(memory), str.size());
+            dst = storage_.heap_->data();
+        }
+
+        traits_type::copy(dst, str.data(), str.size());
+        dst[str.size()] = value_type();
+    }
+
+    __UTL_HIDE_FROM_ABI explicit basic_shared_string(const_pointer str) UTL_THROWS
+        : basic_shared_string(view_type(str)) {}
+
+    basic_shared_string(decltype(nullptr)) = delete;
+
+    __UTL_HIDE_FROM_ABI basic_shared_string(basic_shared_string const& other) noexcept
+        : storage_(other.storage_)
+        , size_(other.size_)
+        , is_heap_(other.is_heap_) {
+        if (is_heap_) {
+            increment(*storage_.heap_);
+        }
+    }
+
+    __UTL_HIDE_FROM_ABI basic_shared_string(basic_shared_string&& other) noexcept
+        : storage_(other.storage_)
+        , size_(other.size_)
+        , is_heap_(other.is_heap_) {
+        other.reset();
+    }
+
+    __UTL_HIDE_FROM_ABI basic_shared_string& operator=(basic_shared_string const& other) noexcept {
+        if (this != &other) {
+            release();
+            storage_ = other.storage_;
+            size_ = other.size_;
+            is_heap_ = other.is_heap_;
+            if (is_heap_) {
+                increment(*storage_.heap_);
+            }
+        }
+
+        return *this;
+    }
+
+    __UTL_HIDE_FROM_ABI basic_shared_string& operator=(basic_shared_string&& other) noexcept {
+        if (this != &other) {
+            release();
+            storage_ = other.storage_;
+            size_ = other.size_;
+            is_heap_ = other.is_heap_;
+            other.reset();
+        }
+
+        return *this;
+    }
+
+    __UTL_HIDE_FROM_ABI ~basic_shared_string() noexcept { release(); }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) size_type size() const noexcept { return size_; }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) size_type length() const noexcept { return size_; }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) bool empty() const noexcept { return size_ == 0; }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) const_pointer data() const noexcept UTL_LIFETIMEBOUND {
+        return is_heap_ ? storage_.heap_->data() : storage_.inline_;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) const_pointer c_str() const noexcept UTL_LIFETIMEBOUND {
+        return data();
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) const_iterator begin() const noexcept UTL_LIFETIMEBOUND {
+        return data();
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) const_iterator end() const noexcept UTL_LIFETIMEBOUND {
+        return data() + size_;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) const_reference operator[](
+        size_type pos) const noexcept UTL_LIFETIMEBOUND {
+        UTL_ASSERT(pos <= size_);
+        return data()[pos];
+    }
+
+    /**
+     * @return `true` if the contents are held in a reference counted heap block
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) bool is_shared() const noexcept { return is_heap_; }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) view_type view() const noexcept UTL_LIFETIMEBOUND {
+        return view_type(data(), size_);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) zview_type zview() const noexcept UTL_LIFETIMEBOUND {
+        return zview_type(data(), size_);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI) operator view_type() const noexcept UTL_LIFETIMEBOUND {
+        return view();
+    }
+
+    __UTL_HIDE_FROM_ABI void swap(basic_shared_string& other) noexcept {
+        basic_shared_string tmp(__UTL move(other));
+        other = __UTL move(*this);
+        *this = __UTL move(tmp);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) int compare(view_type other) const noexcept {
+        return view().compare(other);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend bool operator==(
+        basic_shared_string const& l, basic_shared_string const& r) noexcept {
+        if (l.size_ != r.size_) {
+            return false;
+        }
+
+        // Copies of the same heap block are equal without comparing characters
+        return (l.is_heap_ && r.is_heap_ && l.storage_.heap_ == r.storage_.heap_) ||
+            traits_type::compare(l.data(), r.data(), l.size_) == 0;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend bool operator!=(
+        basic_shared_string const& l, basic_shared_string const& r) noexcept {
+        return !(l == r);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend bool operator==(
+        basic_shared_string const& l, view_type r) noexcept {
+        return l.view() == r;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend bool operator!=(
+        basic_shared_string const& l, view_type r) noexcept {
+        return !(l.view() == r);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend bool operator<(
+        basic_shared_string const& l, basic_shared_string const& r) noexcept {
+        return l.view().compare(r.view()) < 0;
+    }
+
+private:
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) void reset() noexcept {
+        size_ = 0;
+        is_heap_ = false;
+        storage_.inline_[0] = value_type();
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) void release() noexcept {
+        if (is_heap_) {
+            decrement(*storage_.heap_);
+        }
+    }
+
+    union data_union {
+        header_type* heap_;
+        value_type inline_[inline_capacity + 1];
+    };
+
+    data_union storage_;
+    size_type size_ : sizeof(size_type) * CHAR_BIT - 1;
+    size_type is_heap_ : 1;
+};
+
+using shared_string = basic_shared_string<char>;
+using shared_wstring = basic_shared_string<wchar_t>;
+#if UTL_SUPPORTS_CHAR8_T
+using shared_u8string = basic_shared_string<char8_t>;
+#endif
+using shared_u16string = basic_shared_string<char16_t>;
+using shared_u32string = basic_shared_string<char32_t>;
+
+UTL_NAMESPACE_END
@@ -0,0 +1,393 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/string/utl_string_fwd.h"
+
+#include "utl/assert/utl_assert.h"
+#include "utl/exception.h"
+#include "utl/memory/utl_allocator.h"
+#include "utl/memory/utl_allocator_traits.h"
+#include "utl/string/utl_basic_short_string.h"
+#include "utl/string/utl_basic_string_view.h"
+#include "utl/string/utl_is_string_char.h"
+#include "utl/type_traits/utl_is_boolean.h"
+#include "utl/type_traits/utl_is_integral.h"
+#include "utl/type_traits/utl_is_same.h"
+#include "utl/type_traits/utl_is_signed.h"
+#include "utl/type_traits/utl_make_unsigned.h"
+#include "utl/utility/utl_exchange.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#if UTL_TARGET_UNIX
+#  include <sys/uio.h>
+#endif
+
+UTL_NAMESPACE_BEGIN
+
+template <typename CharType, typename Traits = char_traits<CharType>,
+    typename Alloc = allocator<CharType>>
+class __UTL_PUBLIC_TEMPLATE basic_string_builder;
+
+/**
+ * @class basic_string_builder
+ * @brief Append-only string accumulator backed by a list of geometrically growing chunks
+ *
+ * Appending never moves previously written characters, so building a large string costs one
+ * allocation per chunk instead of a chain of reallocations and copies. The result is either
+ * copied once into a `basic_short_string` with `str` or `finalize`, or handed to vectored I/O
+ * through `for_each_chunk` or `to_iovec`.
+ *
+ * Chunks are obtained from `Alloc` rebound to the chunk header type, so an arena or other
+ * monotonic allocator may be supplied to avoid the global heap entirely. Cleared builders retain
+ * their chunks for reuse.
+ */
+template <typename CharType, typename Traits, typename Alloc>
+class __UTL_PUBLIC_TEMPLATE basic_string_builder {
+    struct chunk {
+        chunk* next;
+        size_t capacity;
+        size_t size;
+
+        UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) CharType* data() noexcept {
+            return reinterpret_cast<CharType*>(this + 1);
+        }
+
+        UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) CharType const* data() const noexcept {
+            return reinterpret_cast<CharType const*>(this + 1);
+        }
+    };
+
+    using alloc_traits UTL_NODEBUG =
+        typename allocator_traits<Alloc>::template rebind_traits<chunk>;
+    using chunk_allocator UTL_NODEBUG = typename alloc_traits::allocator_type;
+
+public:
+    using traits_type = Traits;
+    using value_type = CharType;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using view_type = basic_string_view<CharType, Traits>;
+
+    /** Capacity in characters of the first chunk */
+    static constexpr size_type initial_capacity = 256;
+
+    __UTL_HIDE_FROM_ABI basic_string_builder() noexcept(noexcept(Alloc()))
+        : alloc_()
+        , head_(nullptr)
+        , tail_(nullptr)
+        , size_(0) {}
+
+    __UTL_HIDE_FROM_ABI explicit basic_string_builder(Alloc const& alloc) noexcept
+        : alloc_(alloc)
+        , head_(nullptr)
+        , tail_(nullptr)
+        , size_(0) {}
+
+    basic_string_builder(basic_string_builder const&) = delete;
+    basic_string_builder& operator=(basic_string_builder const&) = delete;
+
+    __UTL_HIDE_FROM_ABI basic_string_builder(basic_string_builder&& other) noexcept
+        : alloc_(__UTL move(other.alloc_))
+        , head_(__UTL exchange(other.head_, nullptr))
+        , tail_(__UTL exchange(other.tail_, nullptr))
+        , size_(__UTL exchange(other.size_, 0)) {}
+
+    __UTL_HIDE_FROM_ABI basic_string_builder& operator=(basic_string_builder&& other) noexcept {
+        if (this != &other) {
+            release();
+            alloc_ = __UTL move(other.alloc_);
+            head_ = __UTL exchange(other.head_, nullptr);
+            tail_ = __UTL exchange(other.tail_, nullptr);
+            size_ = __UTL exchange(other.size_, 0);
+        }
+
+        return *this;
+    }
+
+    __UTL_HIDE_FROM_ABI ~basic_string_builder() noexcept { release(); }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) size_type size() const noexcept { return size_; }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) bool empty() const noexcept { return size_ == 0; }
+
+    /**
+     * @return The number of non-empty chunks
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) size_type chunk_count() const noexcept {
+        size_type count = 0;
+        for (auto c = head_; c != nullptr; c = c->next) {
+            count += c->size != 0;
+        }
+
+        return count;
+    }
+
+    /**
+     * @brief Discards the contents while retaining the allocated chunks
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, REINITIALIZES) void clear() noexcept {
+        for (auto c = head_; c != nullptr; c = c->next) {
+            c->size = 0;
+        }
+
+        tail_ = head_;
+        size_ = 0;
+    }
+
+    /**
+     * @brief Ensures the next `count` characters can be appended without allocating
+     */
+    __UTL_HIDE_FROM_ABI void reserve(size_type count) UTL_THROWS { (void)prepare(count); }
+
+    __UTL_HIDE_FROM_ABI basic_string_builder& append(view_type str) UTL_THROWS {
+        auto src = str.data();
+        auto remaining = str.size();
+        while (remaining) {
+            // Fill the remainder of the current chunk before moving on
+            auto const c = prepare(1);
+            auto const available = c->capacity - c->size;
+            auto const count = available < remaining ? available : remaining;
+            traits_type::copy(c->data() + c->size, src, count);
+            commit(c, count);
+            src += count;
+            remaining -= count;
+        }
+
+        return *this;
+    }
+
+    __UTL_HIDE_FROM_ABI basic_string_builder& append(value_type const* str) UTL_THROWS {
+        return append(view_type(str));
+    }
+
+    __UTL_HIDE_FROM_ABI basic_string_builder& append(value_type ch) UTL_THROWS {
+        auto const c = prepare(1);
+        c->data()[c->size] = ch;
+        commit(c, 1);
+        return *this;
+    }
+
+    __UTL_HIDE_FROM_ABI basic_string_builder& append(size_type count, value_type ch) UTL_THROWS {
+        auto const c = prepare(count);
+        traits_type::assign(c->data() + c->size, count, ch);
+        commit(c, count);
+        return *this;
+    }
+
+    /**
+     * @brief Appends the decimal representation of an integer
+     */
+    template <typename T UTL_CONSTRAINT_CXX11(UTL_TRAIT_is_integral(T) && !UTL_TRAIT_is_boolean(T) &&
+        !is_string_char<T>::value)>
+    UTL_CONSTRAINT_CXX20(UTL_TRAIT_is_integral(T) && !UTL_TRAIT_is_boolean(T) &&
+        !is_string_char<T>::value)
+    __UTL_HIDE_FROM_ABI basic_string_builder& append(T value) UTL_THROWS {
+        using unsigned_type = make_unsigned_t<T>;
+        // Enough for the digits of a 128-bit integer and a sign
+        static constexpr size_type max_digits = 40;
+        auto const negative = UTL_TRAIT_is_signed(T) && value < 0;
+        auto magnitude = negative ? unsigned_type(0) - static_cast<unsigned_type>(value)
+                                  : static_cast<unsigned_type>(value);
+        value_type digits[max_digits];
+        auto first = digits + max_digits;
+        do {
+            *--first = static_cast<value_type>('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude);
+
+        if (negative) {
+            *--first = static_cast<value_type>('-');
+        }
+
+        return append(view_type(first, static_cast<size_type>(digits + max_digits - first)));
+    }
+
+    /**
+     * @brief Appends printf-style formatted output, only available for `char` builders
+     */
+    __UTL_HIDE_FROM_ABI basic_string_builder& append_format(char const* fmt, ...) UTL_THROWS {
+        va_list args;
+        va_start(args, fmt);
+        UTL_TRY {
+            append_vformat(fmt, args);
+        } UTL_CATCH(...) {
+            va_end(args);
+            UTL_RETHROW();
+        }
+        va_end(args);
+        return *this;
+    }
+
+    __UTL_HIDE_FROM_ABI basic_string_builder& append_vformat(char const* fmt, va_list args1) UTL_THROWS {
+        static_assert(UTL_TRAIT_is_same(CharType, char), "Formatting requires a char builder");
+        auto c = prepare(1);
+        auto const available = c->capacity - c->size;
+        va_list args2;
+        va_copy(args2, args1);
+        auto const length = ::vsnprintf(c->data() + c->size, available, fmt, args1);
+        if (length < 0) {
+            va_end(args2);
+            return *this;
+        }
+
+        // vsnprintf needs room for the terminator even though it is not kept
+        if (static_cast<size_type>(length) >= available) {
+            UTL_TRY {
+                c = prepare(static_cast<size_type>(length) + 1);
+            } UTL_CATCH(...) {
+                va_end(args2);
+                UTL_RETHROW();
+            }
+            ::vsnprintf(c->data() + c->size, static_cast<size_type>(length) + 1, fmt, args2);
+        }
+
+        va_end(args2);
+        commit(c, static_cast<size_type>(length));
+        return *this;
+    }
+
+    /**
+     * @brief Invokes `func(view_type)` for every non-empty chunk in order
+     */
+    template <typename F>
+    __UTL_HIDE_FROM_ABI void for_each_chunk(F&& func) const {
+        for (auto c = head_; c != nullptr; c = c->next) {
+            if (c->size) {
+                func(view_type(c->data(), c->size));
+            }
+        }
+    }
+
+    /**
+     * @brief Copies the contents to `dest`, which must hold at least `size()` characters
+     *
+     * @return The number of characters copied
+     */
+    __UTL_HIDE_FROM_ABI size_type copy(value_type* dest) const noexcept {
+        for (auto c = head_; c != nullptr; c = c->next) {
+            traits_type::copy(dest, c->data(), c->size);
+            dest += c->size;
+        }
+
+        return size_;
+    }
+
+    /**
+     * @brief Replaces the contents of `out` with the built string, allocating at most once
+     */
+    template <size_t N, typename A>
+    __UTL_HIDE_FROM_ABI void finalize(basic_short_string<CharType, N, Traits, A>& out) const UTL_THROWS {
+        out.resize_and_overwrite(size_, [this](value_type* dest, size_type) { return copy(dest); });
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) basic_string<CharType, Traits, Alloc> str() const UTL_THROWS {
+        basic_string<CharType, Traits, Alloc> result;
+        finalize(result);
+        return result;
+    }
+
+#if UTL_TARGET_UNIX
+    /**
+     * @brief Describes the chunks as a scatter/gather array suitable for `writev`
+     *
+     * The entries remain valid until the builder is modified or destroyed.
+     *
+     * @return The number of entries written, at most `max_count`; if it is less than
+     * `chunk_count()` the remaining chunks were not described
+     */
+    __UTL_HIDE_FROM_ABI size_type to_iovec(::iovec* out, size_type max_count) const noexcept {
+        size_type count = 0;
+        for (auto c = head_; c != nullptr && count < max_count; c = c->next) {
+            if (c->size) {
+                out[count].iov_base = const_cast<CharType*>(c->data());
+                out[count].iov_len = c->size * sizeof(CharType);
+                ++count;
+            }
+        }
+
+        return count;
+    }
+#endif
+
+private:
+    static_assert(UTL_TRAIT_is_same(typename alloc_traits::pointer, chunk*),
+        "Allocator must use raw pointers");
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, CONST) static constexpr size_type units(
+        size_type capacity) noexcept {
+        return (sizeof(chunk) + capacity * sizeof(CharType) + sizeof(chunk) - 1) / sizeof(chunk);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) void commit(chunk* c, size_type count) noexcept {
+        UTL_ASSERT(c->size + count <= c->capacity);
+        c->size += count;
+        size_ += count;
+    }
+
+    /**
+     * @return The chunk to append to, with at least `count` characters available
+     */
+    __UTL_HIDE_FROM_ABI chunk* prepare(size_type count) UTL_THROWS {
+        while (tail_ != nullptr && tail_->capacity - tail_->size < count) {
+            if (tail_->next == nullptr) {
+                break;
+            }
+
+            // Move on to the chunks retained by `clear`
+            tail_ = tail_->next;
+        }
+
+        if (tail_ != nullptr && tail_->capacity - tail_->size >= count) {
+            return tail_;
+        }
+
+        auto capacity = tail_ != nullptr ? tail_->capacity * 2 : initial_capacity;
+        capacity = capacity < count ? count : capacity;
+        auto const n = units(capacity);
+        auto const c = alloc_traits::allocate(alloc_, n);
+        c->next = nullptr;
+        c->capacity = (n * sizeof(chunk) - sizeof(chunk)) / sizeof(CharType);
+        c->size = 0;
+        if (tail_ == nullptr) {
+            head_ = c;
+        } else {
+            tail_->next = c;
+        }
+
+        tail_ = c;
+        return c;
+    }
+
+    __UTL_HIDE_FROM_ABI void release() noexcept {
+        auto c = head_;
+        while (c != nullptr) {
+            auto const next = c->next;
+            alloc_traits::deallocate(alloc_, c, units(c->capacity));
+            c = next;
+        }
+
+        head_ = nullptr;
+        tail_ = nullptr;
+        size_ = 0;
+    }
+
+    chunk_allocator alloc_;
+    chunk* head_;
+    chunk* tail_;
+    size_type size_;
+};
+
+using string_builder = basic_string_builder<char>;
+using wstring_builder = basic_string_builder<wchar_t>;
+#if UTL_SUPPORTS_CHAR8_T
+using u8string_builder = basic_string_builder<char8_t>;
+#endif
+using u16string_builder = basic_string_builder<char16_t>;
+using u32string_builder = basic_string_builder<char32_t>;
+
+UTL_NAMESPACE_END
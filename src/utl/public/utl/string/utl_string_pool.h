@@ -0,0 +1,497 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/string/utl_string_fwd.h"
+
+#include "utl/atomic/utl_atomic.h"
+#include "utl/atomic/utl_futex.h"
+#include "utl/memory/utl_allocator_decl.h"
+#include "utl/string/utl_basic_string_view.h"
+#include "utl/tempus/utl_duration.h"
+
+#include <stdint.h>
+#include <string.h>
+
+UTL_NAMESPACE_BEGIN
+
+template <typename CharType, typename Traits = char_traits<CharType>>
+class __UTL_PUBLIC_TEMPLATE basic_string_pool;
+template <typename CharType, typename Traits = char_traits<CharType>>
+class __UTL_PUBLIC_TEMPLATE basic_interned_string;
+
+namespace details {
+namespace string_pool {
+
+template <typename CharType>
+struct entry {
+    uint64_t hash;
+    size_t size;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) inline CharType const* data() const noexcept {
+        return reinterpret_cast<CharType const*>(this + 1);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) inline CharType* data() noexcept {
+        return reinterpret_cast<CharType*>(this + 1);
+    }
+};
+
+template <typename CharType>
+struct empty_entry {
+    entry<CharType> header;
+    CharType terminator;
+};
+
+/**
+ * Shared storage of the empty string so that every pool hands out the same handle for it
+ */
+template <typename CharType>
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) inline entry<CharType> const* empty() noexcept {
+    static constexpr empty_entry<CharType> storage = {{0, 0}, CharType()};
+    return &storage.header;
+}
+
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, CONST) inline constexpr uint64_t mix(uint64_t h) noexcept {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * Hashes 8 bytes at a time and finalizes with the MurmurHash3 mixer
+ */
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, PURE) inline uint64_t hash_bytes(void const* src, size_t size) noexcept {
+    static constexpr uint64_t multiplier = 0x9e3779b97f4a7c15ull;
+    auto bytes = static_cast<unsigned char const*>(src);
+    uint64_t h = size * multiplier;
+    for (; size >= 8; bytes += 8, size -= 8) {
+        uint64_t block;
+        ::memcpy(&block, bytes, 8);
+        h = (h ^ mix(block)) * multiplier;
+    }
+
+    if (size) {
+        uint64_t block = 0;
+        ::memcpy(&block, bytes, size);
+        h = (h ^ mix(block)) * multiplier;
+    }
+
+    // Zero is reserved for the empty string
+    return mix(h) | 1;
+}
+
+/**
+ * Futex based mutex, see "Futexes Are Tricky" by Ulrich Drepper
+ */
+class mutex {
+public:
+    __UTL_HIDE_FROM_ABI constexpr mutex() noexcept : state_(unlocked) {}
+    mutex(mutex const&) = delete;
+    mutex& operator=(mutex const&) = delete;
+
+    __UTL_HIDE_FROM_ABI void lock() noexcept {
+        uint32_t expected = unlocked;
+        if (atomic_acquire::compare_exchange_strong(
+                &state_, &expected, locked, atomics::relaxed_failure)) {
+            return;
+        }
+
+        if (expected != contended) {
+            expected = atomic_acquire::exchange(&state_, contended);
+        }
+
+        while (expected != unlocked) {
+            // A spurious wake, an interruption or a changed value all end the wait the same way:
+            // the exchange below re-checks the state and waits again if it is still held
+            (void)futex::wait(&state_, contended, tempus::duration::invalid());
+            expected = atomic_acquire::exchange(&state_, contended);
+        }
+    }
+
+    __UTL_HIDE_FROM_ABI void unlock() noexcept {
+        if (atomic_release::exchange(&state_, unlocked) == contended) {
+            futex::notify_one(&state_);
+        }
+    }
+
+private:
+    static constexpr uint32_t unlocked = 0;
+    static constexpr uint32_t locked = 1;
+    static constexpr uint32_t contended = 2;
+
+    uint32_t state_;
+};
+
+class lock_guard {
+public:
+    __UTL_HIDE_FROM_ABI explicit lock_guard(mutex& m) noexcept : mutex_(m) { mutex_.lock(); }
+    lock_guard(lock_guard const&) = delete;
+    lock_guard& operator=(lock_guard const&) = delete;
+    __UTL_HIDE_FROM_ABI ~lock_guard() noexcept { mutex_.unlock(); }
+
+private:
+    mutex& mutex_;
+};
+
+} // namespace string_pool
+} // namespace details
+
+/**
+ * @class basic_interned_string
+ * @brief Pointer sized handle to a string owned by a `basic_string_pool`
+ *
+ * Handles obtained from the same pool compare equal if and only if their contents are equal, so
+ * equality and hashing never touch the characters. A default constructed handle refers to the
+ * empty string and compares equal to the handle of an interned empty string. A null handle is
+ * only ever returned by an unsuccessful `basic_string_pool::find`.
+ *
+ * Handles remain valid until the pool that produced them is destroyed.
+ */
+template <typename CharType, typename Traits>
+class __UTL_PUBLIC_TEMPLATE basic_interned_string {
+    using entry_type UTL_NODEBUG = details::string_pool::entry<CharType>;
+    friend class basic_string_pool<CharType, Traits>;
+
+public:
+    using traits_type = Traits;
+    using value_type = CharType;
+    using size_type = size_t;
+    using const_pointer = value_type const*;
+    using view_type = basic_string_view<CharType, Traits>;
+
+    __UTL_HIDE_FROM_ABI basic_interned_string() noexcept
+        : entry_(details::string_pool::empty<CharType>()) {}
+    __UTL_HIDE_FROM_ABI constexpr basic_interned_string(decltype(nullptr)) noexcept
+        : entry_(nullptr) {}
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) explicit constexpr operator bool() const noexcept {
+        return entry_ != nullptr;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) const_pointer data() const noexcept {
+        return entry_->data();
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) const_pointer c_str() const noexcept {
+        return entry_->data();
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) size_type size() const noexcept {
+        return entry_->size;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) bool empty() const noexcept {
+        return entry_->size == 0;
+    }
+
+    /**
+     * @return The hash of the contents computed when the string was interned
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) size_t hash() const noexcept {
+        return static_cast<size_t>(entry_->hash);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) view_type view() const noexcept {
+        return view_type(entry_->data(), entry_->size);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) operator view_type() const noexcept {
+        return view();
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) friend constexpr bool operator==(
+        basic_interned_string const& l, basic_interned_string const& r) noexcept {
+        return l.entry_ == r.entry_;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) friend constexpr bool operator!=(
+        basic_interned_string const& l, basic_interned_string const& r) noexcept {
+        return l.entry_ != r.entry_;
+    }
+
+private:
+    __UTL_HIDE_FROM_ABI explicit constexpr basic_interned_string(entry_type const* e) noexcept
+        : entry_(e) {}
+
+    entry_type const* entry_;
+};
+
+/**
+ * @class basic_string_pool
+ * @brief Thread-safe string interning pool
+ *
+ * Interned strings are copied into arena chunks that are only released when the pool is
+ * destroyed. Entries are indexed by an open addressing hash table of pointers; lookups of strings
+ * that are already interned are lock-free, while insertions are serialized by a futex based lock.
+ *
+ * When the table grows, superseded tables are retained until destruction so that concurrent
+ * readers never observe freed memory.
+ */
+template <typename CharType, typename Traits>
+class __UTL_PUBLIC_TEMPLATE basic_string_pool {
+    using entry_type UTL_NODEBUG = details::string_pool::entry<CharType>;
+
+    struct chunk {
+        chunk* previous;
+        size_t size;
+    };
+
+    struct table {
+        table* previous;
+        size_t mask;
+
+        UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) entry_type const** slots() noexcept {
+            return reinterpret_cast<entry_type const**>(this + 1);
+        }
+    };
+
+    struct empty_table {
+        table header;
+        entry_type const* slot;
+    };
+
+public:
+    using traits_type = Traits;
+    using value_type = CharType;
+    using size_type = size_t;
+    using view_type = basic_string_view<CharType, Traits>;
+    using interned_type = basic_interned_string<CharType, Traits>;
+
+    static constexpr size_t chunk_size = 16 * 1024;
+
+    __UTL_HIDE_FROM_ABI basic_string_pool() noexcept
+        : table_(&empty_table_.header)
+        , chunks_(nullptr)
+        , cursor_(nullptr)
+        , end_(nullptr)
+        , size_(0) {}
+
+    basic_string_pool(basic_string_pool const&) = delete;
+    basic_string_pool& operator=(basic_string_pool const&) = delete;
+
+    /**
+     * @brief Releases all storage, invalidating every handle produced by this pool
+     */
+    __UTL_HIDE_FROM_ABI ~basic_string_pool() noexcept {
+        auto t = table_;
+        while (t != &empty_table_.header) {
+            auto const previous = t->previous;
+            __UTL memory::details::deallocate(t, table_bytes(t->mask + 1), alignof(table));
+            t = previous;
+        }
+
+        auto c = chunks_;
+        while (c != nullptr) {
+            auto const previous = c->previous;
+            __UTL memory::details::deallocate(c, c->size, alignof(chunk));
+            c = previous;
+        }
+    }
+
+    /**
+     * @return The number of distinct non-empty strings interned
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) size_type size() const noexcept {
+        return atomic_relaxed::load(&size_);
+    }
+
+    /**
+     * @brief Looks up a string without interning it, never blocks
+     *
+     * @return The interned handle, or a null handle if `str` has not been interned
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) interned_type find(view_type str) const noexcept {
+        if (str.empty()) {
+            return interned_type();
+        }
+
+        return interned_type(lookup(str, hash_of(str)));
+    }
+
+    /**
+     * @brief Interns a string, copying it into the pool if it is not already present
+     *
+     * @throws Any exception thrown by the global allocation function
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) interned_type intern(view_type str) UTL_THROWS {
+        if (str.empty()) {
+            return interned_type();
+        }
+
+        auto const hash = hash_of(str);
+        if (auto const found = lookup(str, hash)) {
+            return interned_type(found);
+        }
+
+        details::string_pool::lock_guard guard(mutex_);
+        // Only the lock holder modifies the table so relaxed loads suffice from here
+        auto t = atomic_relaxed::load(&table_);
+        auto index = probe(t, str, hash);
+        if (auto const found = atomic_relaxed::load(&t->slots()[index])) {
+            return interned_type(found);
+        }
+
+        auto const entry = store(str, hash);
+        if ((size_ + 1) * 2 > t->mask + 1) {
+            t = grow(t);
+            index = probe(t, str, hash);
+        }
+
+        atomic_release::store(&t->slots()[index], static_cast<entry_type const*>(entry));
+        atomic_relaxed::store(&size_, size_ + 1);
+        return interned_type(entry);
+    }
+
+private:
+    static constexpr size_t initial_capacity = 64;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, CONST) static constexpr size_t table_bytes(
+        size_t capacity) noexcept {
+        return sizeof(table) + capacity * sizeof(entry_type const*);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, CONST) static constexpr size_t align_up(
+        size_t size) noexcept {
+        return (size + alignof(entry_type) - 1) & ~(alignof(entry_type) - 1);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, PURE) static uint64_t hash_of(view_type str) noexcept {
+        return details::string_pool::hash_bytes(str.data(), str.size() * sizeof(CharType));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, PURE) static bool matches(
+        entry_type const* e, view_type str, uint64_t hash) noexcept {
+        return e->hash == hash && e->size == str.size() &&
+            traits_type::compare(e->data(), str.data(), str.size()) == 0;
+    }
+
+    /**
+     * @return The index of the slot holding `str`, or of the empty slot where it belongs
+     */
+    __UTL_HIDE_FROM_ABI static size_t probe(table* t, view_type str, uint64_t hash) noexcept {
+        auto index = static_cast<size_t>(hash) & t->mask;
+        auto const slots = t->slots();
+        while (true) {
+            auto const e = atomic_acquire::load(&slots[index]);
+            if (e == nullptr || matches(e, str, hash)) {
+                return index;
+            }
+
+            index = (index + 1) & t->mask;
+        }
+    }
+
+    __UTL_HIDE_FROM_ABI entry_type const* lookup(view_type str, uint64_t hash) const noexcept {
+        auto t = atomic_acquire::load(&table_);
+        while (true) {
+            auto const e = atomic_acquire::load(&t->slots()[probe(t, str, hash)]);
+            if (e != nullptr) {
+                return e;
+            }
+
+            // A miss is only conclusive if the table was not replaced in the meantime
+            auto const current = atomic_acquire::load(&table_);
+            if (current == t) {
+                return nullptr;
+            }
+
+            t = current;
+        }
+    }
+
+    __UTL_HIDE_FROM_ABI entry_type* store(view_type str, uint64_t hash) UTL_THROWS {
+        auto const bytes = align_up(sizeof(entry_type) + (str.size() + 1) * sizeof(CharType));
+        if (static_cast<size_t>(end_ - cursor_) < bytes) {
+            auto const size = align_up(sizeof(chunk)) + bytes > chunk_size
+                ? align_up(sizeof(chunk)) + bytes
+                : chunk_size;
+            auto const c =
+                static_cast<chunk*>(__UTL memory::details::allocate(size, alignof(chunk)));
+            c->previous = chunks_;
+            c->size = size;
+            chunks_ = c;
+            cursor_ = reinterpret_cast<unsigned char*>(c) + align_up(sizeof(chunk));
+            end_ = reinterpret_cast<unsigned char*>(c) + size;
+        }
+
+        auto const e = reinterpret_cast<entry_type*>(cursor_);
+        cursor_ += bytes;
+        e->hash = hash;
+        e->size = str.size();
+        traits_type::copy(e->data(), str.data(), str.size());
+        e->data()[str.size()] = CharType();
+        return e;
+    }
+
+    __UTL_HIDE_FROM_ABI table* grow(table* t) UTL_THROWS {
+        auto const capacity = t->mask ? (t->mask + 1) * 2 : initial_capacity;
+        auto const next = static_cast<table*>(
+            __UTL memory::details::allocate(table_bytes(capacity), alignof(table)));
+        next->previous = t;
+        next->mask = capacity - 1;
+        auto const slots = next->slots();
+        for (size_t i = 0; i < capacity; ++i) {
+            slots[i] = nullptr;
+        }
+
+        auto const old_slots = t->slots();
+        for (size_t i = 0; i <= t->mask; ++i) {
+            if (auto const e = old_slots[i]) {
+                auto index = static_cast<size_t>(e->hash) & next->mask;
+                while (slots[index] != nullptr) {
+                    index = (index + 1) & next->mask;
+                }
+
+                slots[index] = e;
+            }
+        }
+
+        atomic_release::store(&table_, next);
+        return next;
+    }
+
+    static empty_table empty_table_;
+
+    table* table_;
+    chunk* chunks_;
+    unsigned char* cursor_;
+    unsigned char* end_;
+    size_t size_;
+    mutable details::string_pool::mutex mutex_;
+};
+
+template <typename CharType, typename Traits>
+typename basic_string_pool<CharType, Traits>::empty_table
+    basic_string_pool<CharType, Traits>::empty_table_ = {{nullptr, 0}, nullptr};
+
+using string_pool = basic_string_pool<char>;
+using interned_string = basic_interned_string<char>;
+using wstring_pool = basic_string_pool<wchar_t>;
+using winterned_string = basic_interned_string<wchar_t>;
+#if UTL_SUPPORTS_CHAR8_T
+using u8string_pool = basic_string_pool<char8_t>;
+using u8interned_string = basic_interned_string<char8_t>;
+#endif
+using u16string_pool = basic_string_pool<char16_t>;
+using u16interned_string = basic_interned_string<char16_t>;
+using u32string_pool = basic_string_pool<char32_t>;
+using u32interned_string = basic_interned_string<char32_t>;
+
+template <typename>
+struct hash;
+
+template <typename CharType, typename Traits>
+struct __UTL_PUBLIC_TEMPLATE hash<basic_interned_string<CharType, Traits>> {
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) inline size_t operator()(
+        basic_interned_string<CharType, Traits> const& str) const noexcept {
+        return str.hash();
+    }
+};
+
+UTL_NAMESPACE_END
@@ -0,0 +1,470 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/string/utl_string_fwd.h"
+
+#include "utl/string/utl_basic_short_string.h"
+#include "utl/string/utl_basic_string_view.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Validation and conversion between UTF-8, UTF-16 and UTF-32
+ *
+ * The encoding of a code unit type is determined by its size: 1-byte types (`char`, `char8_t`,
+ * `unsigned char`) hold UTF-8, 2-byte types UTF-16 and 4-byte types UTF-32, so `wchar_t` is
+ * treated as whichever of the latter two it matches on the target.
+ *
+ * Runs of ASCII are processed 16 bytes at a time and the remaining code points go through a
+ * validating scalar decoder; malformed input is reported rather than replaced.
+ */
+
+UTL_NAMESPACE_BEGIN
+
+#define __UTL_ATTRIBUTE_UNICODE_PURE (PURE)(NODISCARD) __UTL_ATTRIBUTE__HIDE_FROM_ABI
+#define __UTL_ATTRIBUTE_TYPE_AGGREGATE_UNICODE_PURE
+#define __UTL_ATTRIBUTE_UNICODE_INLINE (ALWAYS_INLINE)__UTL_ATTRIBUTE__HIDE_FROM_ABI
+#define __UTL_ATTRIBUTE_TYPE_AGGREGATE_UNICODE_INLINE
+
+namespace unicode {
+
+enum class conversion_error : unsigned char {
+    none,
+    /** Unexpected continuation byte or missing continuation byte */
+    invalid_sequence,
+    /** The input ends in the middle of a sequence */
+    truncated,
+    /** A code point encoded with more bytes than necessary */
+    overlong,
+    /** A surrogate encoded in UTF-8/UTF-32, or an unpaired surrogate in UTF-16 */
+    surrogate,
+    /** A code point above U+10FFFF */
+    out_of_range
+};
+
+struct conversion_result {
+    conversion_error error;
+    /**
+     * On success the number of code units produced, otherwise the offset of the first code unit
+     * of the malformed sequence in the input
+     */
+    size_t count;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) constexpr explicit operator bool() const noexcept {
+        return error == conversion_error::none;
+    }
+};
+
+namespace details {
+
+template <size_t N>
+struct code_unit;
+template <>
+struct code_unit<1> {
+    using type = uint8_t;
+    /** Sign bit of every byte in a word */
+    static constexpr uint64_t non_ascii = 0x8080808080808080ull;
+};
+template <>
+struct code_unit<2> {
+    using type = uint16_t;
+    static constexpr uint64_t non_ascii = 0xff80ff80ff80ff80ull;
+};
+template <>
+struct code_unit<4> {
+    using type = uint32_t;
+    static constexpr uint64_t non_ascii = 0xffffff80ffffff80ull;
+};
+
+template <typename T>
+UTL_ATTRIBUTE(UNICODE_INLINE) inline uint32_t unit(T value) noexcept {
+    return static_cast<typename code_unit<sizeof(T)>::type>(value);
+}
+
+/**
+ * Whether the next 16 bytes of code units are all ASCII, `str` must have 16 bytes remaining
+ */
+template <typename T>
+UTL_ATTRIBUTE(UNICODE_INLINE) inline bool ascii_block(T const* str) noexcept {
+    uint64_t words[2];
+    ::memcpy(words, str, sizeof(words));
+    return ((words[0] | words[1]) & code_unit<sizeof(T)>::non_ascii) == 0;
+}
+
+static constexpr size_t block_bytes = 16;
+
+struct decoded {
+    conversion_error error;
+    uint32_t code_point;
+    /** Code units consumed */
+    size_t length;
+};
+
+UTL_ATTRIBUTE(UNICODE_INLINE) inline constexpr bool is_continuation(uint32_t byte) noexcept {
+    return (byte & 0xc0) == 0x80;
+}
+
+template <size_t N>
+struct encoding;
+
+template <>
+struct encoding<1> {
+    static constexpr size_t max_length = 4;
+
+    template <typename T>
+    UTL_ATTRIBUTE(UNICODE_INLINE) static inline decoded decode(T const* str, size_t remaining) noexcept {
+        auto const lead = unit(str[0]);
+        if (lead < 0x80) {
+            return {conversion_error::none, lead, 1};
+        }
+
+        size_t length;
+        uint32_t code_point;
+        // Valid range of the second byte, narrowed for the leads that can start overlong,
+        // surrogate or out of range sequences
+        uint32_t low = 0x80;
+        uint32_t high = 0xbf;
+        if (lead < 0xc2) {
+            return {lead < 0xc0 ? conversion_error::invalid_sequence : conversion_error::overlong,
+                0, 0};
+        } else if (lead < 0xe0) {
+            length = 2;
+            code_point = lead & 0x1f;
+        } else if (lead < 0xf0) {
+            length = 3;
+            code_point = lead & 0x0f;
+            low = lead == 0xe0 ? 0xa0 : low;
+            high = lead == 0xed ? 0x9f : high;
+        } else if (lead < 0xf5) {
+            length = 4;
+            code_point = lead & 0x07;
+            low = lead == 0xf0 ? 0x90 : low;
+            high = lead == 0xf4 ? 0x8f : high;
+        } else {
+            return {conversion_error::out_of_range, 0, 0};
+        }
+
+        if (remaining < length) {
+            for (size_t idx = 1; idx < remaining; ++idx) {
+                if (!is_continuation(unit(str[idx]))) {
+                    return {conversion_error::invalid_sequence, 0, 0};
+                }
+            }
+
+            return {conversion_error::truncated, 0, 0};
+        }
+
+        auto const second = unit(str[1]);
+        if (second < low || second > high) {
+            if (!is_continuation(second)) {
+                return {conversion_error::invalid_sequence, 0, 0};
+            }
+
+            return {lead == 0xed ? conversion_error::surrogate
+                        : lead == 0xf4 ? conversion_error::out_of_range
+                                       : conversion_error::overlong,
+                0, 0};
+        }
+
+        code_point = (code_point << 6) | (second & 0x3f);
+        for (size_t idx = 2; idx < length; ++idx) {
+            auto const byte = unit(str[idx]);
+            if (!is_continuation(byte)) {
+                return {conversion_error::invalid_sequence, 0, 0};
+            }
+
+            code_point = (code_point << 6) | (byte & 0x3f);
+        }
+
+        return {conversion_error::none, code_point, length};
+    }
+
+    UTL_ATTRIBUTE(UNICODE_INLINE) static inline constexpr size_t length(uint32_t code_point) noexcept {
+        return code_point < 0x80 ? 1 : code_point < 0x800 ? 2 : code_point < 0x10000 ? 3 : 4;
+    }
+
+    template <typename T>
+    UTL_ATTRIBUTE(UNICODE_INLINE) static inline size_t encode(uint32_t code_point, T* out) noexcept {
+        if (code_point < 0x80) {
+            out[0] = static_cast<T>(code_point);
+            return 1;
+        }
+
+        if (code_point < 0x800) {
+            out[0] = static_cast<T>(0xc0 | (code_point >> 6));
+            out[1] = static_cast<T>(0x80 | (code_point & 0x3f));
+            return 2;
+        }
+
+        if (code_point < 0x10000) {
+            out[0] = static_cast<T>(0xe0 | (code_point >> 12));
+            out[1] = static_cast<T>(0x80 | ((code_point >> 6) & 0x3f));
+            out[2] = static_cast<T>(0x80 | (code_point & 0x3f));
+            return 3;
+        }
+
+        out[0] = static_cast<T>(0xf0 | (code_point >> 18));
+        out[1] = static_cast<T>(0x80 | ((code_point >> 12) & 0x3f));
+        out[2] = static_cast<T>(0x80 | ((code_point >> 6) & 0x3f));
+        out[3] = static_cast<T>(0x80 | (code_point & 0x3f));
+        return 4;
+    }
+};
+
+template <>
+struct encoding<2> {
+    static constexpr size_t max_length = 2;
+
+    template <typename T>
+    UTL_ATTRIBUTE(UNICODE_INLINE) static inline decoded decode(T const* str, size_t remaining) noexcept {
+        auto const lead = unit(str[0]);
+        if ((lead & 0xf800) != 0xd800) {
+            return {conversion_error::none, lead, 1};
+        }
+
+        if (lead >= 0xdc00) {
+            return {conversion_error::surrogate, 0, 0};
+        }
+
+        if (remaining < 2) {
+            return {conversion_error::truncated, 0, 0};
+        }
+
+        auto const trail = unit(str[1]);
+        if ((trail & 0xfc00) != 0xdc00) {
+            return {conversion_error::surrogate, 0, 0};
+        }
+
+        return {conversion_error::none, 0x10000 + ((lead - 0xd800) << 10) + (trail - 0xdc00), 2};
+    }
+
+    UTL_ATTRIBUTE(UNICODE_INLINE) static inline constexpr size_t length(uint32_t code_point) noexcept {
+        return code_point < 0x10000 ? 1 : 2;
+    }
+
+    template <typename T>
+    UTL_ATTRIBUTE(UNICODE_INLINE) static inline size_t encode(uint32_t code_point, T* out) noexcept {
+        if (code_point < 0x10000) {
+            out[0] = static_cast<T>(code_point);
+            return 1;
+        }
+
+        code_point -= 0x10000;
+        out[0] = static_cast<T>(0xd800 + (code_point >> 10));
+        out[1] = static_cast<T>(0xdc00 + (code_point & 0x3ff));
+        return 2;
+    }
+};
+
+template <>
+struct encoding<4> {
+    static constexpr size_t max_length = 1;
+
+    template <typename T>
+    UTL_ATTRIBUTE(UNICODE_INLINE) static inline decoded decode(T const* str, size_t) noexcept {
+        auto const code_point = unit(str[0]);
+        if (code_point > 0x10ffff) {
+            return {conversion_error::out_of_range, 0, 0};
+        }
+
+        if ((code_point & 0xfffff800) == 0xd800) {
+            return {conversion_error::surrogate, 0, 0};
+        }
+
+        return {conversion_error::none, code_point, 1};
+    }
+
+    UTL_ATTRIBUTE(UNICODE_INLINE) static inline constexpr size_t length(uint32_t) noexcept {
+        return 1;
+    }
+
+    template <typename T>
+    UTL_ATTRIBUTE(UNICODE_INLINE) static inline size_t encode(uint32_t code_point, T* out) noexcept {
+        out[0] = static_cast<T>(code_point);
+        return 1;
+    }
+};
+
+/**
+ * Decodes `str` and passes each run of ASCII and each other code point to `sink`
+ *
+ * @param sink Provides `ascii(From const*, size_t)` and `code_point(uint32_t)`
+ */
+template <typename From, typename Sink>
+UTL_ATTRIBUTE(UNICODE_INLINE) inline conversion_result decode(
+    From const* str, size_t count, Sink& sink) noexcept {
+    using decoder = encoding<sizeof(From)>;
+    static constexpr size_t block_units = block_bytes / sizeof(From);
+    size_t idx = 0;
+    while (idx < count) {
+        auto const ascii_start = idx;
+        while (count - idx >= block_units && ascii_block(str + idx)) {
+            idx += block_units;
+        }
+
+        // At most a block's worth of ASCII remains before a non-ASCII unit or the end
+        while (idx < count && unit(str[idx]) < 0x80) {
+            ++idx;
+        }
+
+        if (idx != ascii_start) {
+            sink.ascii(str + ascii_start, idx - ascii_start);
+            continue;
+        }
+
+        auto const result = decoder::decode(str + idx, count - idx);
+        if (result.error != conversion_error::none) {
+            return {result.error, idx};
+        }
+
+        sink.code_point(result.code_point);
+        idx += result.length;
+    }
+
+    return {conversion_error::none, sink.count};
+}
+
+struct validate_sink {
+    size_t count;
+    UTL_ATTRIBUTE(UNICODE_INLINE) void code_point(uint32_t) noexcept {}
+    template <typename From>
+    UTL_ATTRIBUTE(UNICODE_INLINE) void ascii(From const*, size_t) noexcept {}
+};
+
+template <typename To>
+struct length_sink {
+    size_t count;
+    UTL_ATTRIBUTE(UNICODE_INLINE) void code_point(uint32_t c) noexcept {
+        count += encoding<sizeof(To)>::length(c);
+    }
+    template <typename From>
+    UTL_ATTRIBUTE(UNICODE_INLINE) void ascii(From const*, size_t length) noexcept {
+        count += length;
+    }
+};
+
+template <typename To>
+struct transcode_sink {
+    To* out;
+    size_t count;
+    UTL_ATTRIBUTE(UNICODE_INLINE) void code_point(uint32_t c) noexcept {
+        count += encoding<sizeof(To)>::encode(c, out + count);
+    }
+    template <typename From>
+    UTL_ATTRIBUTE(UNICODE_INLINE) void ascii(From const* str, size_t length) noexcept {
+        auto const dst = out + count;
+        for (size_t idx = 0; idx < length; ++idx) {
+            dst[idx] = static_cast<To>(unit(str[idx]));
+        }
+        count += length;
+    }
+};
+
+} // namespace details
+
+/**
+ * @return Whether every code unit in [str, str + count) is below 0x80
+ */
+template <typename T>
+UTL_ATTRIBUTE(UNICODE_PURE) inline bool is_ascii(T const* str, size_t count) noexcept {
+    static constexpr size_t block_units = details::block_bytes / sizeof(T);
+    uint64_t accumulated = 0;
+    size_t idx = 0;
+    for (; count - idx >= 4 * block_units; idx += 4 * block_units) {
+        uint64_t words[8];
+        ::memcpy(words, str + idx, sizeof(words));
+        accumulated |= words[0] | words[1] | words[2] | words[3] | words[4] | words[5] | words[6] |
+            words[7];
+        if (accumulated & details::code_unit<sizeof(T)>::non_ascii) {
+            return false;
+        }
+    }
+
+    uint32_t tail = 0;
+    for (; idx < count; ++idx) {
+        tail |= details::unit(str[idx]);
+    }
+
+    return tail < 0x80;
+}
+
+/**
+ * Checks that [str, str + count) is well-formed in the encoding of `T`
+ *
+ * @return On success, `count` of the result is the number of code units
+ */
+template <typename T>
+UTL_ATTRIBUTE(UNICODE_PURE) inline conversion_result validate(T const* str, size_t count) noexcept {
+    details::validate_sink sink{count};
+    return details::decode(str, count, sink);
+}
+
+/**
+ * @return The number of `To` code units needed to transcode [str, str + count), or of its valid
+ * prefix if it is malformed
+ */
+template <typename To, typename From>
+UTL_ATTRIBUTE(UNICODE_PURE) inline size_t transcoded_length(From const* str, size_t count) noexcept {
+    details::length_sink<To> sink{0};
+    details::decode(str, count, sink);
+    return sink.count;
+}
+
+/**
+ * @return An upper bound on the `To` code units needed to transcode `count` `From` code units
+ */
+template <typename To, typename From>
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) inline constexpr size_t max_transcoded_length(
+    size_t count) noexcept {
+    // Every code point takes no more code units in a wider encoding
+    return sizeof(To) >= sizeof(From) ? count
+        : sizeof(To) == 1            ? count * (sizeof(From) == 2 ? 3 : 4)
+                                     : count * 2;
+}
+
+/**
+ * Transcodes [str, str + count) into `out`, stopping at the first malformed sequence
+ *
+ * @param out Destination of at least `transcoded_length<To>(str, count)` code units
+ * @return On success, `count` of the result is the number of code units written. On failure the
+ * code points preceding the malformed sequence have been written.
+ */
+template <typename To, typename From>
+__UTL_HIDE_FROM_ABI inline conversion_result transcode(
+    From const* str, size_t count, To* out) noexcept {
+    details::transcode_sink<To> sink{out, 0};
+    return details::decode(str, count, sink);
+}
+
+/**
+ * Transcodes `src` into `dst`, replacing its contents
+ *
+ * Narrowing conversions measure the output first, widening conversions allocate for the worst
+ * case; either way `dst` is only written once. On failure, `dst` is left empty.
+ */
+template <typename To, size_t N, typename Traits, typename Alloc, typename From, typename FromTraits>
+__UTL_HIDE_FROM_ABI conversion_result transcode(
+    basic_string_view<From, FromTraits> src, basic_short_string<To, N, Traits, Alloc>& dst) UTL_THROWS {
+    auto const capacity = sizeof(To) >= sizeof(From)
+        ? max_transcoded_length<To, From>(src.size())
+        : transcoded_length<To>(src.data(), src.size());
+    conversion_result result = {conversion_error::none, 0};
+    dst.resize_and_overwrite(capacity, [&](To* out, size_t) {
+        result = transcode(src.data(), src.size(), out);
+        return result ? result.count : 0;
+    });
+    return result;
+}
+
+} // namespace unicode
+
+#undef __UTL_ATTRIBUTE_UNICODE_PURE
+#undef __UTL_ATTRIBUTE_TYPE_AGGREGATE_UNICODE_PURE
+#undef __UTL_ATTRIBUTE_UNICODE_INLINE
+#undef __UTL_ATTRIBUTE_TYPE_AGGREGATE_UNICODE_INLINE
+
+UTL_NAMESPACE_END
@@ -41,7 +41,7 @@ struct timespec_traits {
             return l.tv_sec == r.tv_sec && l.tv_nsec == r.tv_nsec;
         }
 
-        return ::memcmp(&l, &r, sizeof(value_type));
+        return ::memcmp(&l, &r, sizeof(value_type)) == 0;
     }
 
     UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr clock_order compare(
@@ -174,6 +174,9 @@ public:
 
 template <>
 struct __UTL_PUBLIC_TEMPLATE clock_traits<steady_clock_t> : private details::timespec_traits {
+private:
+    using base_type = details::timespec_traits;
+
 public:
     using clock = steady_clock_t;
     using typename base_type::duration_type;
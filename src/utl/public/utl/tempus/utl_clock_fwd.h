@@ -25,6 +25,10 @@ struct __UTL_ABI_PUBLIC hardware_clock_t;
 
 struct __UTL_ABI_PUBLIC file_clock_t;
 
+struct __UTL_ABI_PUBLIC fast_steady_clock_t;
+
+struct __UTL_ABI_PUBLIC coarse_clock_t;
+
 template <typename>
 struct __UTL_PUBLIC_TEMPLATE clock_traits;
 
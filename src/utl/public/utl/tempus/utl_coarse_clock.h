@@ -0,0 +1,104 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/tempus/utl_clock_fwd.h"
+
+#include "utl/atomic/utl_atomic.h"
+#include "utl/tempus/utl_clock.h"
+
+#include <stdint.h>
+
+#if UTL_TARGET_UNIX
+
+#  ifndef UTL_COARSE_CLOCK_RESOLUTION_US
+#    define UTL_COARSE_CLOCK_RESOLUTION_US 1000
+#  endif
+
+/**
+ * A cheap monotonic clock with roughly millisecond accuracy, suited to timeouts and TTLs
+ *
+ * While the ticker is running, a background thread publishes the monotonic time every
+ * `UTL_COARSE_CLOCK_RESOLUTION_US` microseconds and reading the clock is a single relaxed load.
+ * Otherwise reads fall back to `CLOCK_MONOTONIC_COARSE` on Linux, or `CLOCK_MONOTONIC` elsewhere.
+ */
+
+UTL_NAMESPACE_BEGIN
+
+namespace tempus {
+
+struct __UTL_ABI_PUBLIC coarse_clock_t {
+    explicit constexpr coarse_clock_t() noexcept = default;
+    __UTL_HIDE_FROM_ABI friend time_point<coarse_clock_t> get_time(coarse_clock_t) noexcept;
+
+    /**
+     * @brief Starts the background ticker if it is not already running
+     *
+     * @return `true` if the ticker is running, `false` if the ticker thread could not be created
+     */
+    __UTL_ABI_PUBLIC static bool start() noexcept;
+
+    /**
+     * @brief Stops the background ticker and waits for it to exit
+     */
+    __UTL_ABI_PUBLIC static void stop() noexcept;
+
+private:
+    __UTL_ABI_PRIVATE static void* tick(void*) noexcept;
+    __UTL_ABI_PRIVATE static void publish(int64_t value) noexcept;
+};
+
+template <>
+struct __UTL_PUBLIC_TEMPLATE clock_traits<coarse_clock_t> {
+public:
+    using clock = coarse_clock_t;
+    /** Nanoseconds since an unspecified epoch */
+    using value_type = int64_t;
+    using duration_type = duration;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr duration_type
+    time_since_epoch(value_type t) noexcept {
+        return duration_type{0, t};
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr duration_type difference(
+        value_type l, value_type r) noexcept {
+        return duration_type{0, l - r};
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr bool equal(
+        value_type l, value_type r) noexcept {
+        return l == r;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr clock_order compare(
+        value_type l, value_type r) noexcept {
+        return static_cast<clock_order>((l > r) - (l < r));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend time_point<coarse_clock_t> get_time(
+        coarse_clock_t) noexcept {
+        auto const value = atomic_relaxed::load(&published_);
+        return time_point<coarse_clock_t>{UTL_BUILTIN_expect(value != 0, 1) ? value : read()};
+    }
+
+private:
+    friend coarse_clock_t;
+
+    __UTL_ABI_PUBLIC static value_type read() noexcept;
+
+    /**
+     * Latest value published by the ticker, zero if the ticker is not running
+     */
+    __UTL_ABI_PUBLIC static value_type published_;
+};
+
+UTL_INLINE_CXX17 constexpr coarse_clock_t coarse_clock{};
+
+} // namespace tempus
+
+UTL_NAMESPACE_END
+
+#endif // UTL_TARGET_UNIX
@@ -0,0 +1,86 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/tempus/utl_clock_fwd.h"
+
+#include "utl/tempus/utl_clock.h"
+
+#include <stdint.h>
+
+#if UTL_TARGET_UNIX
+
+/**
+ * A steady clock derived from the hardware clock
+ *
+ * The hardware clock is calibrated against `CLOCK_MONOTONIC` on first use and periodically
+ * re-synchronised, with any accumulated error slewed away rather than stepped so that the clock
+ * never goes backwards. Converting ticks to nanoseconds is a single multiply and shift, avoiding
+ * the cost of `clock_gettime` on every read.
+ *
+ * If the hardware clock does not run at an invariant rate, every read falls back to
+ * `clock_gettime(CLOCK_MONOTONIC)`.
+ */
+
+UTL_NAMESPACE_BEGIN
+
+namespace tempus {
+
+struct __UTL_ABI_PUBLIC fast_steady_clock_t {
+    explicit constexpr fast_steady_clock_t() noexcept = default;
+    __UTL_HIDE_FROM_ABI friend time_point<fast_steady_clock_t> get_time(fast_steady_clock_t) noexcept;
+
+    /**
+     * @brief Checks if reads are served by the calibrated hardware clock
+     *
+     * @return `true` if the hardware clock is used, `false` if reads fall back to `clock_gettime`
+     */
+    UTL_ATTRIBUTES(_ABI_PUBLIC, NODISCARD) static bool calibrated() noexcept;
+};
+
+template <>
+struct __UTL_PUBLIC_TEMPLATE clock_traits<fast_steady_clock_t> {
+public:
+    using clock = fast_steady_clock_t;
+    /** Nanoseconds since an unspecified epoch */
+    using value_type = int64_t;
+    using duration_type = duration;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr duration_type
+    time_since_epoch(value_type t) noexcept {
+        return duration_type{0, t};
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr duration_type difference(
+        value_type l, value_type r) noexcept {
+        return duration_type{0, l - r};
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr bool equal(
+        value_type l, value_type r) noexcept {
+        return l == r;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr clock_order compare(
+        value_type l, value_type r) noexcept {
+        return static_cast<clock_order>((l > r) - (l < r));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) friend time_point<fast_steady_clock_t> get_time(
+        fast_steady_clock_t) noexcept {
+        return time_point<fast_steady_clock_t>{now()};
+    }
+
+private:
+    __UTL_ABI_PUBLIC static value_type now() noexcept;
+};
+
+UTL_INLINE_CXX17 constexpr fast_steady_clock_t fast_steady_clock{};
+
+} // namespace tempus
+
+UTL_NAMESPACE_END
+
+#endif // UTL_TARGET_UNIX
@@ -0,0 +1,303 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/tempus/utl_clock_fwd.h"
+
+#include "utl/atomic/utl_atomic.h"
+#include "utl/bit/utl_bit_width.h"
+#include "utl/tempus/utl_duration.h"
+#include "utl/tempus/utl_hardware_ticks.h"
+
+#include <stdint.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace tempus {
+
+template <typename Duration, bool Concurrent>
+class __UTL_PUBLIC_TEMPLATE basic_latency_histogram;
+
+namespace details {
+namespace histogram {
+
+template <typename Duration>
+struct units;
+
+template <>
+struct units<duration> {
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr bool valid(
+        duration d) noexcept {
+        return static_cast<bool>(d);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr uint64_t to_units(
+        duration d) noexcept {
+        return d.seconds() * 1000000000ull + d.nanoseconds();
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr duration from_units(
+        uint64_t u) noexcept {
+        return duration{0, static_cast<int64_t>(u)};
+    }
+};
+
+template <>
+struct units<hardware_ticks> {
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr bool valid(
+        hardware_ticks t) noexcept {
+        return static_cast<bool>(t);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr uint64_t to_units(
+        hardware_ticks t) noexcept {
+        return static_cast<uint64_t>(t.value());
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr hardware_ticks
+    from_units(uint64_t u) noexcept {
+        return hardware_ticks{static_cast<int64_t>(u)};
+    }
+};
+
+/**
+ * Log-linear bucket layout
+ *
+ * Values below `sub_bucket_count` get a bucket each, every subsequent power of 2 is split into
+ * `sub_bucket_count` linear sub-buckets, bounding the relative error of any recorded value to
+ * `1 / sub_bucket_count`.
+ */
+struct layout {
+    static constexpr unsigned int precision_bits = 5;
+    static constexpr uint64_t sub_bucket_count = 1ull << precision_bits;
+    static constexpr uint64_t sub_bucket_mask = sub_bucket_count - 1;
+    static constexpr size_t bucket_count = (64 - precision_bits + 1) * sub_bucket_count;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr size_t index_of(
+        uint64_t value) noexcept {
+        return value < sub_bucket_count
+            ? static_cast<size_t>(value)
+            : index_of(value, static_cast<unsigned int>(__UTL bit_width(value)) - precision_bits - 1);
+    }
+
+    /**
+     * @return The largest value that maps to the bucket at `idx`
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static inline constexpr uint64_t highest_equivalent(
+        size_t idx) noexcept {
+        return idx < sub_bucket_count ? idx
+                                      : highest_equivalent(idx & sub_bucket_mask,
+                                            static_cast<unsigned int>(idx >> precision_bits) - 1);
+    }
+
+private:
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline constexpr size_t index_of(
+        uint64_t value, unsigned int shift) noexcept {
+        return static_cast<size_t>(((shift + 1) << precision_bits) | ((value >> shift) & sub_bucket_mask));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) static inline constexpr uint64_t highest_equivalent(
+        uint64_t sub_bucket, unsigned int shift) noexcept {
+        return (((sub_bucket_count | sub_bucket) + 1) << shift) - 1;
+    }
+};
+
+template <bool Concurrent>
+struct counter_operations {
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) static inline void add(
+        uint64_t* ctx, uint64_t value) noexcept {
+        atomic_relaxed::fetch_add(ctx, value);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline uint64_t load(
+        uint64_t const* ctx) noexcept {
+        return atomic_relaxed::load(ctx);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) static inline void store(
+        uint64_t* ctx, uint64_t value) noexcept {
+        atomic_relaxed::store(ctx, value);
+    }
+};
+
+template <>
+struct counter_operations<false> {
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) static inline void add(
+        uint64_t* ctx, uint64_t value) noexcept {
+        *ctx += value;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) static inline uint64_t load(
+        uint64_t const* ctx) noexcept {
+        return *ctx;
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) static inline void store(
+        uint64_t* ctx, uint64_t value) noexcept {
+        *ctx = value;
+    }
+};
+
+} // namespace histogram
+} // namespace details
+
+/**
+ * @class basic_latency_histogram
+ * @brief Fixed-memory, log-linear bucketed histogram of durations
+ *
+ * Recording is O(1) and never allocates; the relative error of any reported value is bounded by
+ * 1/32. The concurrent variant may be recorded into from any number of threads using relaxed
+ * atomic increments, the local variant is intended to be owned by a single thread and merged into
+ * a shared histogram periodically.
+ *
+ * @tparam Duration Either `duration` or `hardware_ticks`
+ * @tparam Concurrent Whether the histogram may be modified by multiple threads at once
+ */
+template <typename Duration, bool Concurrent>
+class __UTL_PUBLIC_TEMPLATE basic_latency_histogram {
+    using layout = details::histogram::layout;
+    using units = details::histogram::units<Duration>;
+    using counter = details::histogram::counter_operations<Concurrent>;
+
+    template <typename, bool>
+    friend class basic_latency_histogram;
+
+public:
+    using duration_type = Duration;
+    static constexpr size_t bucket_count = layout::bucket_count;
+
+    __UTL_HIDE_FROM_ABI constexpr basic_latency_histogram() noexcept : counts_{} {}
+    basic_latency_histogram(basic_latency_histogram const&) = delete;
+    basic_latency_histogram& operator=(basic_latency_histogram const&) = delete;
+
+    /**
+     * @brief Records a single value, invalid values are ignored
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) inline void record(duration_type value) noexcept {
+        record(value, 1);
+    }
+
+    /**
+     * @brief Records `count` occurences of a value, invalid values are ignored
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) inline void record(
+        duration_type value, uint64_t count) noexcept {
+        if (units::valid(value)) {
+            counter::add(counts_ + layout::index_of(units::to_units(value)), count);
+        }
+    }
+
+    /**
+     * @brief Adds every count recorded in `other` to this histogram
+     *
+     * If `other` is concurrently modified, the merged result reflects some interleaving of those
+     * modifications.
+     */
+    template <bool C>
+    __UTL_HIDE_FROM_ABI void merge(basic_latency_histogram<Duration, C> const& other) noexcept {
+        using other_counter = details::histogram::counter_operations<C>;
+        for (size_t idx = 0; idx < bucket_count; ++idx) {
+            auto const count = other_counter::load(other.counts_ + idx);
+            if (count) {
+                counter::add(counts_ + idx, count);
+            }
+        }
+    }
+
+    /**
+     * @brief Clears all recorded values
+     */
+    __UTL_HIDE_FROM_ABI void reset() noexcept {
+        for (size_t idx = 0; idx < bucket_count; ++idx) {
+            counter::store(counts_ + idx, 0);
+        }
+    }
+
+    /**
+     * @return The total number of recorded values
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) uint64_t count() const noexcept {
+        uint64_t total = 0;
+        for (size_t idx = 0; idx < bucket_count; ++idx) {
+            total += counter::load(counts_ + idx);
+        }
+
+        return total;
+    }
+
+    /**
+     * @brief Queries the value below which a given percentage of recorded values fall
+     *
+     * @param percentile Percentage in the range [0, 100]
+     * @return The highest value equivalent to the bucket containing the percentile, zero if the
+     * histogram is empty
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) duration_type value_at_percentile(
+        double percentile) const noexcept {
+        auto const total = count();
+        if (!total) {
+            return units::from_units(0);
+        }
+
+        percentile = percentile < 0.0 ? 0.0 : percentile > 100.0 ? 100.0 : percentile;
+        auto target = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(total) + 0.5);
+        target = target ? target : 1;
+
+        uint64_t seen = 0;
+        size_t idx = 0;
+        for (; idx < bucket_count - 1; ++idx) {
+            seen += counter::load(counts_ + idx);
+            if (seen >= target) {
+                break;
+            }
+        }
+
+        return units::from_units(layout::highest_equivalent(idx));
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) duration_type p50() const noexcept {
+        return value_at_percentile(50.0);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) duration_type p99() const noexcept {
+        return value_at_percentile(99.0);
+    }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) duration_type p999() const noexcept {
+        return value_at_percentile(99.9);
+    }
+
+    /**
+     * @return The highest value equivalent to the largest recorded value, zero if empty
+     */
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) duration_type max() const noexcept {
+        for (size_t idx = bucket_count; idx-- > 0;) {
+            if (counter::load(counts_ + idx)) {
+                return units::from_units(layout::highest_equivalent(idx));
+            }
+        }
+
+        return units::from_units(0);
+    }
+
+private:
+    uint64_t counts_[bucket_count];
+};
+
+/**
+ * Histogram that may be recorded into from any thread
+ */
+template <typename Duration = duration>
+using latency_histogram = basic_latency_histogram<Duration, true>;
+
+/**
+ * Histogram owned by a single thread, recording avoids atomic read-modify-writes entirely
+ */
+template <typename Duration = duration>
+using local_latency_histogram = basic_latency_histogram<Duration, false>;
+
+} // namespace tempus
+
+UTL_NAMESPACE_END
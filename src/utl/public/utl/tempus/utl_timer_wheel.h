@@ -0,0 +1,340 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/tempus/utl_clock_fwd.h"
+
+#include "utl/assert/utl_assert.h"
+#include "utl/bit/utl_countr_zero.h"
+#include "utl/tempus/utl_clock.h"
+#include "utl/utility/utl_declval.h"
+
+#include <stdint.h>
+
+UTL_NAMESPACE_BEGIN
+
+namespace tempus {
+
+template <typename Clock>
+class __UTL_PUBLIC_TEMPLATE timer_wheel;
+
+namespace details {
+namespace timer_wheel {
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) inline constexpr uint64_t to_units(
+    duration d) noexcept {
+    return d ? d.seconds() * 1000000000ull + d.nanoseconds() : 0;
+}
+
+UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE, NODISCARD) inline constexpr uint64_t to_units(
+    hardware_ticks t) noexcept {
+    return t ? static_cast<uint64_t>(t.value()) : 0;
+}
+} // namespace timer_wheel
+} // namespace details
+
+/**
+ * @class timer_node
+ * @brief Intrusive hook for timers scheduled on a `timer_wheel`
+ *
+ * Embed or inherit a `timer_node` in the object owning the timeout; the wheel never allocates. A
+ * node must outlive its scheduling and may only be scheduled on a single wheel at a time.
+ */
+class __UTL_ABI_PUBLIC timer_node {
+    template <typename>
+    friend class timer_wheel;
+
+public:
+    __UTL_HIDE_FROM_ABI constexpr timer_node() noexcept
+        : prev_(nullptr)
+        , next_(nullptr)
+        , expiry_(0)
+        , slot_(unscheduled) {}
+    timer_node(timer_node const&) = delete;
+    timer_node& operator=(timer_node const&) = delete;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) constexpr bool scheduled() const noexcept {
+        return slot_ != unscheduled;
+    }
+
+private:
+    static constexpr uint32_t unscheduled = uint32_t(-1);
+
+    timer_node* prev_;
+    timer_node* next_;
+    uint64_t expiry_;
+    uint32_t slot_;
+};
+
+/**
+ * @class timer_wheel
+ * @brief Hierarchical timing wheel with O(1) schedule and cancel
+ *
+ * Time is quantised into ticks of a fixed resolution. The wheel consists of `level_count` levels
+ * of 64 slots each, every level covering 64 times the range of the previous one. Timers further
+ * in the future than the wheel's range are parked in the highest level until their expiry comes
+ * within range. Timers cascade down one level at a time as the wheel advances and fire once they
+ * reach the lowest level.
+ *
+ * The wheel is not thread-safe.
+ *
+ * @tparam Clock Clock type used to drive the wheel, e.g. `steady_clock_t` or `hardware_clock_t`
+ */
+template <typename Clock>
+class __UTL_PUBLIC_TEMPLATE timer_wheel {
+    static_assert(UTL_TRAIT_is_tempus_clock(Clock), "Invalid clock");
+
+public:
+    using clock = Clock;
+    using time_point_type = time_point<Clock>;
+    using duration_type = typename clock_traits<Clock>::duration_type;
+
+    static constexpr unsigned int level_count = 6;
+    static constexpr unsigned int slot_bits = 6;
+    static constexpr unsigned int slot_count = 1u << slot_bits;
+
+    /**
+     * @param start The time corresponding to tick 0
+     * @param resolution The duration of a single tick, must be non-zero
+     */
+    __UTL_HIDE_FROM_ABI timer_wheel(time_point_type start, duration_type resolution) noexcept
+        : start_(start)
+        , resolution_(details::timer_wheel::to_units(resolution))
+        , current_(0)
+        , size_(0)
+        , occupancy_{}
+        , slots_{} {
+        UTL_ASSERT(resolution_ != 0);
+    }
+
+    timer_wheel(timer_wheel const&) = delete;
+    timer_wheel& operator=(timer_wheel const&) = delete;
+
+    /**
+     * @brief Unschedules all pending timers without firing them
+     */
+    __UTL_HIDE_FROM_ABI ~timer_wheel() noexcept { clear(); }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) size_t size() const noexcept { return size_; }
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, NODISCARD) bool empty() const noexcept { return size_ == 0; }
+
+    /**
+     * @brief Schedules a timer to fire once `delay` has elapsed since the wheel's current tick
+     *
+     * Rescheduling a node that is already scheduled moves it. The delay is rounded up to a whole
+     * number of ticks so that a timer never fires before its deadline, a zero delay fires on the
+     * next tick.
+     */
+    __UTL_HIDE_FROM_ABI void schedule(timer_node& node, duration_type delay) noexcept {
+        if (node.scheduled()) {
+            unlink(node);
+            --size_;
+        }
+
+        auto const ticks = (details::timer_wheel::to_units(delay) + resolution_ - 1) / resolution_;
+        insert(node, current_ + (ticks ? ticks : 1));
+        ++size_;
+    }
+
+    /**
+     * @brief Unschedules a timer, does nothing if the timer is not scheduled
+     *
+     * @return `true` if the timer was scheduled
+     */
+    __UTL_HIDE_FROM_ABI bool cancel(timer_node& node) noexcept {
+        if (!node.scheduled()) {
+            return false;
+        }
+
+        unlink(node);
+        --size_;
+        return true;
+    }
+
+    /**
+     * @brief Unschedules every pending timer without firing them
+     */
+    __UTL_HIDE_FROM_ABI void clear() noexcept {
+        for (unsigned int slot = 0; slot < level_count * slot_count; ++slot) {
+            auto node = detach(slot);
+            while (node != nullptr) {
+                auto const next = node->next_;
+                reset(*node);
+                node = next;
+            }
+        }
+
+        size_ = 0;
+    }
+
+    /**
+     * @brief Advances the wheel to `now`, firing every timer that has expired
+     *
+     * Expired nodes are unscheduled before being passed to `on_expire`, which may reschedule
+     * them or schedule new timers.
+     *
+     * @param now Current time of `Clock`
+     * @param on_expire Callable invoked as `on_expire(timer_node&)` for each expired timer
+     * @return The number of timers fired
+     */
+    template <typename F>
+    __UTL_HIDE_FROM_ABI size_t advance(time_point_type now, F&& on_expire) noexcept(
+        noexcept(on_expire(__UTL declval<timer_node&>()))) {
+        auto const elapsed = now - start_;
+        auto const target = details::timer_wheel::to_units(elapsed) / resolution_;
+        size_t fired = 0;
+        while (current_ < target) {
+            auto next = current_ + 1;
+            if (next & slot_mask) {
+                // Skip empty slots up to the end of the current rotation
+                auto const pending = occupancy_[0] & (~uint64_t(0) << (next & slot_mask));
+                next = pending ? (next & ~uint64_t(slot_mask)) | __UTL countr_zero(pending)
+                               : (next | slot_mask) + 1;
+            }
+
+            if (!(next & slot_mask)) {
+                // Rotations of the levels below the lowest occupied one only cascade empty slots
+                unsigned int level = 0;
+                while (level < level_count && occupancy_[level] == 0) {
+                    ++level;
+                }
+
+                if (level == level_count) {
+                    current_ = target;
+                    break;
+                }
+
+                if (level != 0) {
+                    next = (current_ | ((uint64_t(1) << (slot_bits * level)) - 1)) + 1;
+                }
+            }
+
+            if (next > target) {
+                current_ = target;
+                break;
+            }
+
+            current_ = next;
+            if (!(current_ & slot_mask)) {
+                cascade();
+            }
+
+            fired += expire(static_cast<unsigned int>(current_ & slot_mask), on_expire);
+        }
+
+        return fired;
+    }
+
+private:
+    static constexpr uint64_t slot_mask = slot_count - 1;
+    static constexpr uint64_t max_ticks = (uint64_t(1) << (slot_bits * level_count)) - 1;
+
+    UTL_ATTRIBUTES(_HIDE_FROM_ABI, ALWAYS_INLINE) static inline void reset(timer_node& node) noexcept {
+        node.prev_ = nullptr;
+        node.next_ = nullptr;
+        node.slot_ = timer_node::unscheduled;
+    }
+
+    __UTL_HIDE_FROM_ABI void insert(timer_node& node, uint64_t expiry) noexcept {
+        auto delta = expiry - current_;
+        auto position = expiry;
+        if (delta > max_ticks) {
+            // Parked at the last tick of the range, the slot comes due before the expiry and
+            // `cascade` inserts the node again with its real expiry
+            delta = max_ticks;
+            position = current_ + max_ticks;
+        }
+
+        unsigned int level = 0;
+        while (delta >= (uint64_t(1) << (slot_bits * (level + 1)))) {
+            ++level;
+        }
+
+        auto const index = static_cast<unsigned int>((position >> (slot_bits * level)) & slot_mask);
+        auto const slot = level * slot_count + index;
+        auto& head = slots_[slot];
+        node.expiry_ = expiry;
+        node.slot_ = slot;
+        node.prev_ = nullptr;
+        node.next_ = head;
+        if (head != nullptr) {
+            head->prev_ = &node;
+        }
+
+        head = &node;
+        occupancy_[level] |= uint64_t(1) << index;
+    }
+
+    __UTL_HIDE_FROM_ABI void unlink(timer_node& node) noexcept {
+        auto const slot = node.slot_;
+        if (node.prev_ != nullptr) {
+            node.prev_->next_ = node.next_;
+        } else {
+            slots_[slot] = node.next_;
+            if (node.next_ == nullptr) {
+                occupancy_[slot / slot_count] &= ~(uint64_t(1) << (slot & slot_mask));
+            }
+        }
+
+        if (node.next_ != nullptr) {
+            node.next_->prev_ = node.prev_;
+        }
+
+        reset(node);
+    }
+
+    __UTL_HIDE_FROM_ABI timer_node* detach(unsigned int slot) noexcept {
+        auto const head = slots_[slot];
+        slots_[slot] = nullptr;
+        occupancy_[slot / slot_count] &= ~(uint64_t(1) << (slot & slot_mask));
+        return head;
+    }
+
+    /**
+     * Redistributes the timers of each higher level slot that has come due
+     */
+    __UTL_HIDE_FROM_ABI void cascade() noexcept {
+        for (unsigned int level = 1; level < level_count; ++level) {
+            auto const index = static_cast<unsigned int>((current_ >> (slot_bits * level)) & slot_mask);
+            auto node = detach(level * slot_count + index);
+            while (node != nullptr) {
+                auto const next = node->next_;
+                insert(*node, node->expiry_);
+                node = next;
+            }
+
+            if (index) {
+                break;
+            }
+        }
+    }
+
+    template <typename F>
+    __UTL_HIDE_FROM_ABI size_t expire(unsigned int index, F& on_expire) noexcept(
+        noexcept(on_expire(__UTL declval<timer_node&>()))) {
+        size_t fired = 0;
+        // Pop one node at a time since callbacks may cancel other nodes in the same slot
+        while (slots_[index] != nullptr) {
+            auto& node = *slots_[index];
+            unlink(node);
+            --size_;
+            ++fired;
+            on_expire(node);
+        }
+
+        return fired;
+    }
+
+    time_point_type start_;
+    uint64_t resolution_;
+    uint64_t current_;
+    size_t size_;
+    uint64_t occupancy_[level_count];
+    timer_node* slots_[level_count * slot_count];
+};
+
+} // namespace tempus
+
+UTL_NAMESPACE_END
@@ -0,0 +1,120 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/utl_config.h"
+
+#include "utl/preprocessor/utl_unique_var.h"
+#include "utl/scope/utl_scope_exit.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Low-overhead instrumentation zones
+ *
+ * Every zone records a begin and an end event stamped with the hardware clock and the id of the
+ * CPU executing the thread. Events are written into a fixed-size ring buffer owned by the
+ * recording thread, so the recording path never blocks, never allocates after the first event of a
+ * thread and never contends with other threads.
+ *
+ * Events are converted to wall time only when dumped, keeping the recording cost to a timestamp
+ * read and a handful of stores.
+ *
+ * Define `UTL_DISABLE_TRACE_SCOPES` to compile every zone out.
+ */
+
+#ifndef UTL_TRACE_RING_CAPACITY
+#  define UTL_TRACE_RING_CAPACITY 16384
+#endif
+
+UTL_NAMESPACE_BEGIN
+
+namespace trace {
+
+enum class event_phase : unsigned char {
+    begin = 'B',
+    end = 'E'
+};
+
+/**
+ * @brief A single recorded trace event
+ */
+struct event_t {
+    /** Name of the zone, must have static storage duration */
+    char const* name;
+    /** Raw hardware clock value */
+    int64_t tick;
+    /** Id of the CPU the event was recorded on, -1 if unknown */
+    int cpu;
+    event_phase phase;
+};
+
+/**
+ * @brief Records an event in the ring buffer of the calling thread
+ *
+ * If the ring buffer is full, the oldest event of the calling thread is overwritten.
+ *
+ * @param name Zone name, must have static storage duration
+ * @param phase Whether the zone is being entered or exited
+ */
+__UTL_ABI_PUBLIC void record(char const* name, event_phase phase) noexcept;
+
+/**
+ * @brief Resumes event recording, recording is enabled by default
+ */
+__UTL_ABI_PUBLIC void enable() noexcept;
+
+/**
+ * @brief Stops event recording; zones entered afterwards are not recorded
+ */
+__UTL_ABI_PUBLIC void disable() noexcept;
+
+UTL_ATTRIBUTES(_ABI_PUBLIC, NODISCARD) bool enabled() noexcept;
+
+/**
+ * @brief Writes every recorded event as Chrome trace-event JSON
+ *
+ * Intended to be used offline, i.e. once the instrumented threads have quiesced. Events
+ * overwritten while the dump is in progress are skipped. Timestamps are written in microseconds
+ * relative to the earliest recorded event; if the hardware clock frequency is not invariant, raw
+ * tick counts are written instead.
+ *
+ * @param file Output stream
+ * @return The number of events written
+ */
+__UTL_ABI_PUBLIC size_t dump_chrome_trace(::FILE* file) noexcept;
+
+/**
+ * @brief Writes every recorded event as Chrome trace-event JSON
+ *
+ * @param path Output file path, will be truncated if it exists
+ * @return `true` if the file was successfully written, `false` otherwise
+ */
+__UTL_ABI_PUBLIC bool dump_chrome_trace(char const* path) noexcept;
+
+} // namespace trace
+
+UTL_NAMESPACE_END
+
+#ifndef UTL_DISABLE_TRACE_SCOPES
+
+#  define __UTL_TRACE_SCOPE_IMPL(NAME, VAR)                                  \
+      char const* const VAR = NAME;                                         \
+      __UTL trace::record(VAR, __UTL trace::event_phase::begin);            \
+      UTL_ON_SCOPE_EXIT {                                                   \
+          __UTL trace::record(VAR, __UTL trace::event_phase::end);          \
+      }
+
+/**
+ * Records the enclosing scope as a named zone
+ *
+ * NAME must have static storage duration, typically a string literal
+ */
+#  define UTL_TRACE_SCOPE(NAME) __UTL_TRACE_SCOPE_IMPL(NAME, UTL_UNIQUE_VAR(TraceZone))
+
+#else // UTL_DISABLE_TRACE_SCOPES
+
+#  define UTL_TRACE_SCOPE(NAME) static_cast<void>(0)
+
+#endif // UTL_DISABLE_TRACE_SCOPES
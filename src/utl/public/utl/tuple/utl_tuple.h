@@ -34,6 +34,17 @@ UTL_NAMESPACE_END
 #  include "utl_tuple_get.h"
 #  include "utl_tuple_get_element.h"
 
+#  include "utl/type_traits/utl_is_trivially_relocatable.h"
+#  include "utl/type_traits/utl_logical_traits.h"
+
+UTL_NAMESPACE_BEGIN
+
+template <typename... Ts>
+struct __UTL_PUBLIC_TEMPLATE is_trivially_relocatable<tuple<Ts...>> :
+    conjunction<is_trivially_relocatable<Ts>...> {};
+
+UTL_NAMESPACE_END
+
 #  undef UTL_TUPLE_PRIVATE_HEADER_GUARD
 
 #endif // UTL_USE_STD_tuple
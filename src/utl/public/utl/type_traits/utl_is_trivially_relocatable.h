@@ -0,0 +1,75 @@
+// Copyright 2023-2024 Bryan Wong
+
+#pragma once
+
+#include "utl/type_traits/utl_common.h"
+
+#include "utl/type_traits/utl_constants.h"
+
+#if UTL_HAS_BUILTIN(__builtin_is_cpp_trivially_relocatable) && \
+    !UTL_DISABLE_BUILTIN_is_trivially_relocatable
+#  define UTL_BUILTIN_is_trivially_relocatable(...) \
+      __builtin_is_cpp_trivially_relocatable(__VA_ARGS__)
+#elif __UTL_SHOULD_USE_BUILTIN(is_trivially_relocatable)
+#  define UTL_BUILTIN_is_trivially_relocatable(...) __is_trivially_relocatable(__VA_ARGS__)
+#endif // UTL_HAS_BUILTIN(__builtin_is_cpp_trivially_relocatable)
+
+#ifndef UTL_BUILTIN_is_trivially_relocatable
+#  include "utl/type_traits/utl_is_trivially_copyable.h"
+#endif
+
+UTL_NAMESPACE_BEGIN
+
+/**
+ * Type trait to determine if objects of a type can be relocated by copying their bytes.
+ *
+ * Relocating an object move-constructs a new object from it and destroys the original; for a
+ * trivially relocatable type, the pair is equivalent to copying the object representation to the
+ * new location and forgetting the original, which lets ranges of such objects be relocated with
+ * a single `memmove`.
+ *
+ * Trivially copyable types are trivially relocatable, as are types the compiler knows to be
+ * relocatable (e.g. `[[clang::trivial_abi]]` types). Other types opt in by specializing this
+ * trait, which is correct for types that own resources through pointers, such as smart pointers
+ * and strings with out-of-line buffers, but not for types storing pointers into themselves or
+ * registering their address elsewhere.
+ *
+ * @tparam T The type to be checked
+ */
+#ifdef UTL_BUILTIN_is_trivially_relocatable
+
+template <typename T>
+struct __UTL_PUBLIC_TEMPLATE is_trivially_relocatable :
+    bool_constant<UTL_BUILTIN_is_trivially_relocatable(T)> {};
+
+#else // ifdef UTL_BUILTIN_is_trivially_relocatable
+
+template <typename T>
+struct __UTL_PUBLIC_TEMPLATE is_trivially_relocatable : is_trivially_copyable<T> {};
+
+#endif // ifdef UTL_BUILTIN_is_trivially_relocatable
+
+template <typename T>
+struct __UTL_PUBLIC_TEMPLATE is_trivially_relocatable<T const> : is_trivially_relocatable<T> {};
+
+template <typename T, size_t N>
+struct __UTL_PUBLIC_TEMPLATE is_trivially_relocatable<T[N]> : is_trivially_relocatable<T> {};
+
+template <typename T, size_t N>
+struct __UTL_PUBLIC_TEMPLATE is_trivially_relocatable<T const[N]> : is_trivially_relocatable<T> {};
+
+#if UTL_CXX14
+template <typename T>
+UTL_INLINE_CXX17 constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+#endif // UTL_CXX14
+
+UTL_NAMESPACE_END
+
+#define UTL_TRAIT_SUPPORTED_is_trivially_relocatable 1
+
+#if UTL_CXX14
+#  define UTL_TRAIT_is_trivially_relocatable(...) __UTL is_trivially_relocatable_v<__VA_ARGS__>
+#else
+#  define UTL_TRAIT_is_trivially_relocatable(...) \
+      __UTL is_trivially_relocatable<__VA_ARGS__>::value
+#endif